@@ -0,0 +1,516 @@
+/*
+This file is part of Electric,Thermal, Mechanical Properties
+Estimation With Percolation Theory (ETMPEWPT) (2D version) program.
+
+Created from Eleftherios Lamprou lef27064@otenet.gr during PhD thesis (2017-2024)
+
+ETMPEWPT is free software : you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+ETMPEWPT is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Foobar.If not, see < https://www.gnu.org/licenses/>.
+
+Theory of this is published in two papers:
+1. E. Lambrou and L. N. Gergidis, A computational method for calculating the electrical and thermal properties of random composite ,
+Physica A: Statistical Mechanics and its Applications, Volume 642, 2024, 129760, ISSN 0378-4371,
+https://doi.org/10.1016/j.physa.2024.129760
+2. E. Lambrou and L. N. Gergidis, A particle digitization-based computational method for continuum percolation, Physica A: Statistical Mechanics
+and its Applications, vol. 590, p. 126738, 2022
+
+if you use this programm and write a paper or report please cite above papers
+
+*/
+
+// Benchmark.cpp : Times the percolation, digitization and FDM kernels in isolation on fixed-seed
+// synthetic microstructures and writes their throughput as JSON, to track regressions across versions.
+//
+// Usage: Benchmark [output file (benchmark.json)] [repetitions (3)]
+// Every kernel runs `repetitions` times on the same microstructure and the fastest run is reported.
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include <omp.h>
+#include "../percolation/general.h"
+#include "../percolation/Grid.h"
+#include "../percolation/Shapes.h"
+#include "../percolation/ShapeGenerator.h" // Also FD2DEL.h (which has no include guard)
+#include "../percolation/PhaseTimer.h"
+#include "../percolation/PerfCounters.h"
+
+using namespace std;
+
+// Synthetic microstructures: square grids of every size, covered by particles at every area fraction
+const int benchSizes[] = { 128, 256, 512 };
+const double benchFractions[] = { 0.40, 0.60, 0.70 };
+const double discRadius = 6;          // Radius of the discs (pixels)
+const double rodWidth = 24;           // Width of the sloped rectangles (pixels)
+const double rodHeight = 4;           // Height of the sloped rectangles (pixels)
+const uint64_t benchSeed = 20240701;  // Base seed, every microstructure derives its own from its size and fraction
+
+// Matrix (phase 0) and particle (phase 1) properties. The conductivity contrast is kept low so the FDM
+// needs a comparable number of CG cycles at every size.
+double benchConductivities[maxComponents] = { 1.0, 100.0 };
+double benchYoungModulus[maxComponents] = { 1.0, 10.0 };
+double benchPoissonRatio[maxComponents] = { 0.3, 0.3 };
+
+// Console output of the kernels is dropped while they are timed.
+class NullBuffer : public std::streambuf {
+protected:
+	int overflow(int c) { return c; };
+};
+
+class MuteConsole {
+	NullBuffer sink;
+	std::streambuf* saved;
+
+public:
+	MuteConsole(void) : saved(std::cout.rdbuf(&sink)) {};
+	~MuteConsole(void) { std::cout.rdbuf(saved); };
+};
+
+// One kernel on one microstructure: fastest run and the bytes it streams per run (model).
+struct BenchResult {
+	string kernel;
+	int size;
+	double fraction;
+	double seconds;
+	double pixels;                          // Pixels processed per run (pixel updates for the FDM)
+	double bytes;                           // Bytes streamed per run
+	vector<pair<string, double>> values;    // Kernel specific results
+};
+
+// Particles of one type covering about `fraction` of a size x size grid. Uniformly placed, overlapping
+// particles of area a cover 1 - exp(-n a / A) of the area A.
+void makeParticles(ParticleSet* particles, ShapeType type, int size, double fraction, uint64_t seed)
+{
+	bool isDisc = (type == ShapeType::CIRCLE);
+	double a = isDisc ? discRadius : rodWidth;
+	double b = isDisc ? discRadius : rodHeight;
+	double area = isDisc ? M_PI * a * b : a * b;
+	size_t n = (size_t)(-log(1.0 - fraction) * size * size / area + 0.5);
+
+	std::mt19937_64 engine(seed);
+	std::uniform_real_distribution<double> position(0, size);
+	std::uniform_real_distribution<double> angle(0, M_PI);
+
+	particles->clear();
+	particles->reserve(n);
+	for (size_t k = 0; k < n; k++)
+	{
+		double x = position(engine);
+		double y = position(engine);
+		particles->add(x, y, a, b, isDisc ? 0 : angle(engine), 0, 1, type);
+	}
+}
+
+// Puts the digitized microstructure back on the grid (the kernels mark cells, visited flags and clusters).
+void restoreGrid(Grid* grid, const vector<char>& cells, const vector<unsigned char>& ingredients)
+{
+	grid->clear();
+	std::copy(cells.begin(), cells.end(), grid->cell);
+	std::copy(ingredients.begin(), ingredients.end(), grid->ingadients);
+	grid->Clusters.clear();
+	grid->cMaxClusterRadius.clear();
+	grid->pathsList.clear();
+}
+
+// Memory bandwidth roof of the CG solve (GB/s): best of five single thread triads a = b + s c
+// (24 bytes per element) over arrays far larger than the last level cache. dembx runs on one thread.
+double triadBandwidth(void)
+{
+	const size_t n = 8 * 1024 * 1024;
+	vector<double> a(n, 0.0), b(n, 1.0), c(n, 2.0);
+	double best = 1e300;
+	for (int rep = 0; rep < 5; rep++)
+	{
+		WallTimer timer;
+		for (size_t i = 0; i < n; i++)
+			a[i] = b[i] + 0.5 * c[i];
+		best = std::min(best, timer.elapsed());
+	}
+	if (a[n / 2] != 2.0) // Keeps the loop
+		cout << "triad check failed\n";
+	return 24.0 * n / best / 1e9;
+}
+
+// Writes a number as JSON (no inf or nan).
+string jsonNumber(double value)
+{
+	if (!std::isfinite(value))
+		return "null";
+	std::ostringstream s;
+	s << std::setprecision(6) << value;
+	return s.str();
+}
+
+void writeJson(ostream& out, const vector<BenchResult>& results, int repetitions, double bandwidth, const string& counters)
+{
+	out << "{\n";
+	out << "  \"program\": \"ETMPEWPT\",\n";
+	out << "  \"version\": \"" << info.mayorVersion << "." << info.minorVersion << "\",\n";
+	out << "  \"date\": \"" << NowToString() << "\",\n";
+	out << "  \"threads\": " << omp_get_max_threads() << ",\n";
+	out << "  \"repetitions\": " << repetitions << ",\n";
+	out << "  \"seed\": " << benchSeed << ",\n";
+	out << "  \"triadGbPerSecond\": " << jsonNumber(bandwidth) << ",\n";
+	out << "  \"hardwareCounters\": \"" << counters << "\",\n";
+	out << "  \"results\": [\n";
+	for (size_t i = 0; i < results.size(); i++)
+	{
+		const BenchResult& r = results[i];
+		out << "    { \"kernel\": \"" << r.kernel << "\", \"size\": " << r.size << ", \"fillFraction\": " << jsonNumber(r.fraction);
+		out << ", \"seconds\": " << jsonNumber(r.seconds);
+		out << ", \"pixelsPerSecond\": " << jsonNumber(r.pixels / r.seconds);
+		out << ", \"gbPerSecond\": " << jsonNumber(r.bytes / r.seconds / 1e9);
+		for (size_t k = 0; k < r.values.size(); k++)
+			out << ", \"" << r.values[k].first << "\": " << jsonNumber(r.values[k].second);
+		out << " }" << (i + 1 < results.size() ? "," : "") << "\n";
+	}
+	out << "  ]\n";
+	out << "}\n";
+}
+
+int main(int argc, char* argv[])
+{
+	string outputFile = (argc > 1) ? argv[1] : "benchmark.json";
+	int repetitions = (argc > 2) ? std::max(1, atoi(argv[2])) : 3;
+
+	ShapeGenerator generator; // Only its digitizers are used
+	vector<BenchResult> results;
+	double bandwidth = triadBandwidth();
+	PerfCounters counters; // Of this thread, which runs dembx
+	cout << "triad bandwidth " << bandwidth << " GB/s, hardware counters: " << counters.status() << "\n";
+
+	// Digitizers: every particle of the set drawn as HARD on a clear grid
+	struct Digitizer {
+		const char* name;
+		ShapeType type;
+		std::function<void(ParticleSet&, size_t, Grid*)> draw;
+	};
+	vector<Digitizer> digitizers = {
+		{ "digitizeEllipse", ShapeType::CIRCLE, [&](ParticleSet& p, size_t k, Grid* g) { generator.digitizeEllipse(p, k, p.a[k], p.b[k], g, CellState::HARD); } },
+		{ "digitizeEllipseArea", ShapeType::CIRCLE, [&](ParticleSet& p, size_t k, Grid* g) { generator.digitizeEllipse(p, k, p.a[k], p.b[k], g, &p.realArea[k], CellState::HARD); } },
+		{ "digitizeEllipseWithBorder", ShapeType::CIRCLE, [&](ParticleSet& p, size_t k, Grid* g) { generator.digitizeEllipseWithBorder(p, k, p.a[k], p.b[k], g, &p.realArea[k], CellState::HARD); } },
+		{ "digitizeSlopedRectangle", ShapeType::SLOPEDRECTANGLE, [&](ParticleSet& p, size_t k, Grid* g) { generator.digitizeSlopedRectangle(p, k, p.a[k], p.b[k], g, CellState::HARD); } },
+		{ "digitizeSlopedRectangleArea", ShapeType::SLOPEDRECTANGLE, [&](ParticleSet& p, size_t k, Grid* g) { generator.digitizeSlopedRectangle(p, k, p.a[k], p.b[k], g, &p.realArea[k], CellState::HARD); } },
+		{ "digitizeSlopedRectangleWithBorder", ShapeType::SLOPEDRECTANGLE, [&](ParticleSet& p, size_t k, Grid* g) { generator.digitizeSlopedRectangleWithBorder(p, k, p.a[k], p.b[k], g, &p.realArea[k], CellState::HARD); } },
+	};
+
+	for (int size : benchSizes)
+		for (double fraction : benchFractions)
+		{
+			cout << "size " << size << " x " << size << ", particle fraction " << fraction << "\n";
+			uint64_t seed = benchSeed + 1000 * (uint64_t)size + (uint64_t)(fraction * 100 + 0.5);
+			double pixels = (double)size * size;
+			Grid* grid = new Grid(size, size);
+			ParticleSet discs, rods;
+			makeParticles(&discs, ShapeType::CIRCLE, size, fraction, seed);
+			makeParticles(&rods, ShapeType::SLOPEDRECTANGLE, size, fraction, seed + 1);
+
+			// Digitizers: pixels are the particle areas drawn, two bytes (cell, ingredient) per pixel
+			for (Digitizer& d : digitizers)
+			{
+				ParticleSet& set = (d.type == ShapeType::CIRCLE) ? discs : rods;
+				double area = (d.type == ShapeType::CIRCLE) ? M_PI * discRadius * discRadius : rodWidth * rodHeight;
+				BenchResult r = { d.name, size, fraction, 1e300, area * set.size(), 2 * area * set.size(), {} };
+				for (int rep = 0; rep < repetitions; rep++)
+				{
+					grid->clear();
+					WallTimer timer;
+					for (size_t k = 0; k < set.size(); k++)
+						d.draw(set, k, grid);
+					r.seconds = std::min(r.seconds, timer.elapsed());
+				}
+				r.values.push_back({ "particles", (double)set.size() });
+				r.values.push_back({ "particlesPerSecond", set.size() / r.seconds });
+				r.values.push_back({ "coveredFraction", grid->countArea() / pixels });
+				results.push_back(r);
+			}
+
+			// The microstructure of the remaining kernels: the discs
+			grid->clear();
+			for (size_t k = 0; k < discs.size(); k++)
+				generator.digitizeEllipse(discs, k, discs.a[k], discs.b[k], grid, CellState::HARD);
+			vector<char> cells(grid->cell, grid->cell + (size_t)size * size);
+			vector<unsigned char> ingredients(grid->ingadients, grid->ingadients + (size_t)size * size);
+
+			// Grid::percolate: cell and visited planes
+			{
+				BenchResult r = { "percolate", size, fraction, 1e300, pixels, 2 * pixels, {} };
+				int percolates = 0;
+				for (int rep = 0; rep < repetitions; rep++)
+				{
+					restoreGrid(grid, cells, ingredients);
+					double seconds = 0;
+					MuteConsole mute;
+					percolates = grid->percolate(&seconds);
+					r.seconds = std::min(r.seconds, seconds);
+				}
+				r.values.push_back({ "percolates", (double)percolates });
+				results.push_back(r);
+			}
+
+			// Grid::percolateWithRealPathLength: cell, visited and ingredient planes
+			{
+				BenchResult r = { "percolateWithRealPathLength", size, fraction, 1e300, pixels, 3 * pixels, {} };
+				double paths = 0, meanLength = 0, meanRealLength = 0;
+				double resistance = 0, thermalResistance = 0, youngModulus = 0, poissonRatio = 0;
+				int percolates = 0;
+				for (int rep = 0; rep < repetitions; rep++)
+				{
+					restoreGrid(grid, cells, ingredients);
+					MuteConsole mute;
+					WallTimer timer;
+					percolates = grid->percolateWithRealPathLength(&paths, &meanLength, &meanRealLength, benchConductivities, benchConductivities,
+						benchYoungModulus, benchPoissonRatio, &resistance, &thermalResistance, &youngModulus, &poissonRatio);
+					r.seconds = std::min(r.seconds, timer.elapsed());
+				}
+				r.values.push_back({ "percolates", (double)percolates });
+				r.values.push_back({ "paths", paths });
+				results.push_back(r);
+			}
+
+			// Grid::markClusters: cell, cluster and clusterVisited planes
+			{
+				BenchResult r = { "markClusters", size, fraction, 1e300, pixels, 3 * pixels, {} };
+				for (int rep = 0; rep < repetitions; rep++)
+				{
+					restoreGrid(grid, cells, ingredients);
+					MuteConsole mute;
+					WallTimer timer;
+					grid->markClusters();
+					r.seconds = std::min(r.seconds, timer.elapsed());
+				}
+				r.values.push_back({ "clusters", (double)grid->Clusters.size() });
+				results.push_back(r);
+			}
+
+			// FD2DEL::dembx, timed by the FDM_CG_PHASE timer of FD2DEL::run, with the profile of its sections
+			// (time, hardware counters and model traffic) of the fastest run. Pixels and bytes are per CG cycle.
+			double doubleCurrent = 0.0; // Current of dembx, the reference of the accuracy of dembxMixed
+			{
+				BenchResult r = { "dembx", size, fraction, 1e300, 0, 0, {} };
+				int cycles = 0;
+				double bondSeconds = 1e300;
+				CgProfile best;
+				for (int rep = 0; rep < repetitions; rep++)
+				{
+					PhaseTimes times = {};
+					CgProfile profile;
+					profile.counters = &counters;
+					PhaseTimes* previous = attachPhaseTimes(&times);
+					{
+						MuteConsole mute;
+						FD2DEL fd2Del(2, maxComponents);
+						fd2Del.initValues(size, size);
+						fd2Del.intitArrays();
+						fd2Del.readFromArray(grid->ingadients, benchConductivities);
+						fd2Del.solver = CG_SOLVER;
+						fd2Del.profile = &profile;
+						char m[] = "m1.dat";
+						char out[] = "out.bmp";
+						fd2Del.run(m, out, 2);
+						cycles = fd2Del.cgIterations;
+						doubleCurrent = fd2Del.curry;
+					}
+					attachPhaseTimes(previous);
+					bondSeconds = std::min(bondSeconds, times.wall[FDM_BOND_PHASE]);
+					if (times.wall[FDM_CG_PHASE] < r.seconds)
+					{
+						r.seconds = times.wall[FDM_CG_PHASE];
+						best = profile;
+					}
+				}
+				// Per cycle figures: a CG cycle calls prod once
+				double perCycle = (best.calls[CG_PROD_SECTION] > 0) ? 1.0 / best.calls[CG_PROD_SECTION] : 0;
+				double cycleSeconds = 0;
+				for (int s = 0; s < CG_SECTIONS; s++)
+					cycleSeconds += best.wall[s] * perCycle;
+				r.pixels = pixels * cycles;
+				r.bytes = best.cycleBytes() * cycles;
+				r.values.push_back({ "cgIterations", (double)cycles });
+				r.values.push_back({ "cgIterationsPerSecond", cycles / r.seconds });
+				r.values.push_back({ "bondSeconds", bondSeconds });
+				r.values.push_back({ "modelBytesPerCgIteration", best.cycleBytes() });
+				r.values.push_back({ "flopsPerByte", best.cycleFlops() / best.cycleBytes() });
+				// Roofline: the attainable rate of a kernel of this intensity is bound by the triad bandwidth
+				r.values.push_back({ "rooflineFraction", best.cycleBytes() / cycleSeconds / 1e9 / bandwidth });
+				double measuredBytes = 0;
+				for (int s = 0; s < CG_SECTIONS; s++)
+				{
+					string name = cgSectionNames[s];
+					double seconds = best.wall[s] * perCycle;
+					r.values.push_back({ name + "Seconds", seconds });
+					r.values.push_back({ name + "ModelBytes", best.modelBytes[s] });
+					r.values.push_back({ name + "GbPerSecond", best.modelBytes[s] / seconds / 1e9 });
+					if (counters.isAvailable())
+					{
+						for (int e = 0; e < PERF_EVENTS; e++)
+							r.values.push_back({ name + (char)toupper(perfEventNames[e][0]) + string(perfEventNames[e] + 1), best.events[s][e] * perCycle });
+						r.values.push_back({ name + "MeasuredBytes", (double)best.events[s][LLC_MISSES_EVENT] * cacheLineBytes * perCycle });
+						measuredBytes += (double)best.events[s][LLC_MISSES_EVENT] * cacheLineBytes * perCycle;
+					}
+				}
+				if (counters.isAvailable())
+					r.values.push_back({ "measuredBytesPerCgIteration", measuredBytes });
+				results.push_back(r);
+			}
+
+			// FD2DEL::dembxStrips (row strips per OpenMP thread, block-Jacobi preconditioned), timed by the
+			// FDM_CG_PHASE timer. Pixels are per CG cycle. The current is checked against dembx, also when
+			// the solver gets a smaller team than it asked for (called from a region with nesting disabled).
+			{
+				BenchResult r = { "dembxStrips", size, fraction, 1e300, 0, 0, {} };
+				int cycles = 0, strips = 0;
+				double current = 0.0, limitedCurrent = 0.0;
+				for (int rep = 0; rep < repetitions; rep++)
+				{
+					PhaseTimes times = {};
+					PhaseTimes* previous = attachPhaseTimes(&times);
+					{
+						MuteConsole mute;
+						FD2DEL fd2Del(2, maxComponents);
+						fd2Del.initValues(size, size);
+						fd2Del.intitArrays();
+						fd2Del.readFromArray(grid->ingadients, benchConductivities);
+						fd2Del.solver = BLOCK_JACOBI_SOLVER;
+						char m[] = "m1.dat";
+						char out[] = "out.bmp";
+						fd2Del.run(m, out, 2);
+						cycles = fd2Del.cgIterations;
+						strips = fd2Del.stripCount();
+						current = fd2Del.curry;
+					}
+					attachPhaseTimes(previous);
+					r.seconds = std::min(r.seconds, times.wall[FDM_CG_PHASE]);
+				}
+				{
+					MuteConsole mute;
+					int levels = omp_get_max_active_levels();
+					omp_set_max_active_levels(1); // The solver's region runs on a team of one thread
+#pragma omp parallel num_threads(2)
+#pragma omp single
+					{
+						FD2DEL fd2Del(2, maxComponents);
+						fd2Del.initValues(size, size);
+						fd2Del.intitArrays();
+						fd2Del.readFromArray(grid->ingadients, benchConductivities);
+						fd2Del.solver = BLOCK_JACOBI_SOLVER;
+						char m[] = "m1.dat";
+						char out[] = "out.bmp";
+						fd2Del.run(m, out, 2);
+						limitedCurrent = fd2Del.curry;
+					}
+					omp_set_max_active_levels(levels);
+				}
+				r.pixels = pixels * cycles;
+				r.values.push_back({ "cgIterations", (double)cycles });
+				r.values.push_back({ "cgIterationsPerSecond", cycles / r.seconds });
+				r.values.push_back({ "strips", (double)strips });
+				r.values.push_back({ "currentRelativeError", std::fabs(current - doubleCurrent) / std::fabs(doubleCurrent) });
+				r.values.push_back({ "limitedTeamRelativeError", std::fabs(limitedCurrent - doubleCurrent) / std::fabs(doubleCurrent) });
+				results.push_back(r);
+			}
+
+			// FD2DEL::dembxAmg (serial, algebraic multigrid preconditioned), timed by the FDM_CG_PHASE
+			// timer with the multigrid setup. Pixels are per CG cycle, and the current is checked against dembx.
+			{
+				BenchResult r = { "dembxAmg", size, fraction, 1e300, 0, 0, {} };
+				int cycles = 0, levels = 0;
+				double complexity = 0, current = 0.0;
+				for (int rep = 0; rep < repetitions; rep++)
+				{
+					PhaseTimes times = {};
+					PhaseTimes* previous = attachPhaseTimes(&times);
+					{
+						MuteConsole mute;
+						FD2DEL fd2Del(2, maxComponents);
+						fd2Del.initValues(size, size);
+						fd2Del.intitArrays();
+						fd2Del.readFromArray(grid->ingadients, benchConductivities);
+						fd2Del.solver = AMG_SOLVER;
+						char m[] = "m1.dat";
+						char out[] = "out.bmp";
+						fd2Del.run(m, out, 2);
+						cycles = fd2Del.cgIterations;
+						levels = fd2Del.amg.levelCount();
+						complexity = fd2Del.amg.operatorComplexity();
+						current = fd2Del.curry;
+					}
+					attachPhaseTimes(previous);
+					r.seconds = std::min(r.seconds, times.wall[FDM_CG_PHASE]);
+				}
+				r.pixels = pixels * cycles;
+				r.values.push_back({ "cgIterations", (double)cycles });
+				r.values.push_back({ "cgIterationsPerSecond", cycles / r.seconds });
+				r.values.push_back({ "levels", (double)levels });
+				r.values.push_back({ "operatorComplexity", complexity });
+				r.values.push_back({ "currentRelativeError", std::fabs(current - doubleCurrent) / std::fabs(doubleCurrent) });
+				results.push_back(r);
+			}
+
+			// FD2DEL::dembxMixed (single precision arrays, double sums, iterative refinement), timed by the
+			// FDM_CG_PHASE timer. Pixels and bytes are per CG cycle (72 bytes a pixel: prod 16, dot
+			// products 12, updates of u, fgb and fh 44), and the current is checked against dembx.
+			{
+				BenchResult r = { "dembxMixed", size, fraction, 1e300, 0, 0, {} };
+				int cycles = 0, refinements = 0;
+				double current = 0.0;
+				for (int rep = 0; rep < repetitions; rep++)
+				{
+					PhaseTimes times = {};
+					PhaseTimes* previous = attachPhaseTimes(&times);
+					{
+						MuteConsole mute;
+						FD2DEL fd2Del(2, maxComponents);
+						fd2Del.solver = MIXED_SOLVER; // Before intitArrays: single precision arrays
+						fd2Del.initValues(size, size);
+						fd2Del.intitArrays();
+						fd2Del.readFromArray(grid->ingadients, benchConductivities);
+						char m[] = "m1.dat";
+						char out[] = "out.bmp";
+						fd2Del.run(m, out, 2);
+						cycles = fd2Del.cgIterations;
+						refinements = fd2Del.refinements;
+						current = fd2Del.curry;
+					}
+					attachPhaseTimes(previous);
+					r.seconds = std::min(r.seconds, times.wall[FDM_CG_PHASE]);
+				}
+				r.pixels = pixels * cycles;
+				r.bytes = 72.0 * pixels * cycles;
+				r.values.push_back({ "cgIterations", (double)cycles });
+				r.values.push_back({ "cgIterationsPerSecond", cycles / r.seconds });
+				r.values.push_back({ "refinements", (double)refinements });
+				r.values.push_back({ "currentRelativeError", std::fabs(current - doubleCurrent) / std::fabs(doubleCurrent) });
+				results.push_back(r);
+			}
+
+			delete grid;
+		}
+
+	ofstream out(outputFile);
+	if (!out)
+	{
+		cout << "Cannot write " << outputFile << "\n";
+		return EXIT_FAILURE;
+	}
+	writeJson(out, results, repetitions, bandwidth, counters.status());
+	cout << "Results written to " << outputFile << "\n";
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,498 @@
+/*
+This file is part of Electric,Thermal, Mechanical Properties
+Estimation With Percolation Theory (ETMPEWPT) (2D version) program.
+
+Created from Eleftherios Lamprou lef27064@otenet.gr during PhD thesis (2017-2024)
+
+ETMPEWPT is free software : you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+ETMPEWPT is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Foobar.If not, see < https://www.gnu.org/licenses/>.
+
+Theory of this is published in two papers:
+1. E. Lambrou and L. N. Gergidis, A computational method for calculating the electrical and thermal properties of random composite ,
+Physica A: Statistical Mechanics and its Applications, Volume 642, 2024, 129760, ISSN 0378-4371,
+https://doi.org/10.1016/j.physa.2024.129760
+2. E. Lambrou and L. N. Gergidis, A particle digitization-based computational method for continuum percolation, Physica A: Statistical Mechanics
+and its Applications, vol. 590, p. 126738, 2022
+
+if you use this programm and write a paper or report please cite above papers
+
+*/
+
+#include "Amg.h"
+#include <cmath>
+#include <algorithm>
+
+void SparseMatrix::multiply(const double* x, double* y) const
+{
+	for (int i = 0; i < rows; i++)
+	{
+		double sum = 0.0;
+		for (int k = start[i]; k < start[i + 1]; k++)
+			sum += value[k] * x[column[k]];
+		y[i] = sum;
+	}
+}
+
+SparseMatrix SparseMatrix::transpose(void) const
+{
+	SparseMatrix t;
+	t.rows = cols;
+	t.cols = rows;
+	t.start.assign(cols + 1, 0);
+	for (int c : column)
+		t.start[c + 1]++;
+	for (int c = 0; c < cols; c++)
+		t.start[c + 1] += t.start[c];
+	t.column.resize(column.size());
+	t.value.resize(value.size());
+	std::vector<int> next(t.start.begin(), t.start.end() - 1);
+	for (int i = 0; i < rows; i++)
+		for (int k = start[i]; k < start[i + 1]; k++)
+		{
+			int p = next[column[k]]++;
+			t.column[p] = i;
+			t.value[p] = value[k];
+		}
+	return t;
+}
+
+SparseMatrix SparseMatrix::times(const SparseMatrix& b) const
+{
+	SparseMatrix c;
+	c.rows = rows;
+	c.cols = b.cols;
+	c.start.reserve(rows + 1);
+	c.start.push_back(0);
+	std::vector<int> position(b.cols, -1); // Entry of every column in the row being built
+	for (int i = 0; i < rows; i++)
+	{
+		int rowStart = (int)c.column.size();
+		for (int k = start[i]; k < start[i + 1]; k++)
+		{
+			double a = value[k];
+			int m = column[k];
+			for (int q = b.start[m]; q < b.start[m + 1]; q++)
+			{
+				int j = b.column[q];
+				if (position[j] < rowStart)
+				{
+					position[j] = (int)c.column.size();
+					c.column.push_back(j);
+					c.value.push_back(a * b.value[q]);
+				}
+				else
+					c.value[position[j]] += a * b.value[q];
+			}
+		}
+		c.start.push_back((int)c.column.size());
+	}
+	return c;
+}
+
+// Diagonal of a square matrix.
+static std::vector<double> diagonalOf(const SparseMatrix& a)
+{
+	std::vector<double> d(a.rows, 0.0);
+	for (int i = 0; i < a.rows; i++)
+		for (int k = a.start[i]; k < a.start[i + 1]; k++)
+			if (a.column[k] == i)
+				d[i] += a.value[k];
+	return d;
+}
+
+SparseMatrix AmgSolver::strength(const SparseMatrix& a) const
+{
+	std::vector<double> d = diagonalOf(a);
+	SparseMatrix s;
+	s.rows = s.cols = a.rows;
+	s.start.reserve(a.rows + 1);
+	s.start.push_back(0);
+	std::vector<std::pair<int, double>> row;
+	for (int i = 0; i < a.rows; i++)
+	{
+		row.clear();
+		for (int k = a.start[i]; k < a.start[i + 1]; k++)
+		{
+			int j = a.column[k];
+			double v = std::fabs(a.value[k]);
+			if ((j != i) && (v > 0.0) && (v >= theta * std::sqrt(std::fabs(d[i] * d[j]))))
+				row.emplace_back(j, v);
+		}
+		std::sort(row.begin(), row.end()); // Rows searched by column
+		for (const auto& entry : row)
+		{
+			s.column.push_back(entry.first);
+			s.value.push_back(entry.second);
+		}
+		s.start.push_back((int)s.column.size());
+	}
+	return s;
+}
+
+int AmgSolver::aggregate(const SparseMatrix& s, std::vector<int>& aggregates) const
+{
+	int n = s.rows, count = 0;
+	aggregates.assign(n, -1);
+
+	// Sites whose strong neighbours are all free start an aggregate with them
+	for (int i = 0; i < n; i++)
+	{
+		if ((aggregates[i] >= 0) || (s.start[i] == s.start[i + 1]))
+			continue;
+		bool free = true;
+		for (int k = s.start[i]; free && (k < s.start[i + 1]); k++)
+			free = (aggregates[s.column[k]] < 0);
+		if (!free)
+			continue;
+		aggregates[i] = count;
+		for (int k = s.start[i]; k < s.start[i + 1]; k++)
+			aggregates[s.column[k]] = count;
+		count++;
+	}
+
+	// The others join the aggregate of their strongest neighbour in one of them
+	std::vector<int> first = aggregates;
+	for (int i = 0; i < n; i++)
+	{
+		if (first[i] >= 0)
+			continue;
+		double strongest = 0.0;
+		for (int k = s.start[i]; k < s.start[i + 1]; k++)
+			if ((first[s.column[k]] >= 0) && (s.value[k] > strongest))
+			{
+				strongest = s.value[k];
+				aggregates[i] = first[s.column[k]];
+			}
+	}
+
+	// What is left (e.g. sites without strong connections) makes new aggregates
+	for (int i = 0; i < n; i++)
+	{
+		if (aggregates[i] >= 0)
+			continue;
+		aggregates[i] = count;
+		for (int k = s.start[i]; k < s.start[i + 1]; k++)
+			if (aggregates[s.column[k]] < 0)
+				aggregates[s.column[k]] = count;
+		count++;
+	}
+	return count;
+}
+
+SparseMatrix AmgSolver::prolongator(const SparseMatrix& a, const SparseMatrix& s, const std::vector<int>& aggregates, int count) const
+{
+	const double omega = 2.0 / 3.0; // 4/3 over the bound 2 of the spectral radius of D^-1 A (rows summing to zero)
+
+	SparseMatrix p;
+	p.rows = a.rows;
+	p.cols = count;
+	p.start.reserve(a.rows + 1);
+	p.start.push_back(0);
+	std::vector<int> position(count, -1);
+	for (int i = 0; i < a.rows; i++)
+	{
+		// Row of the filtered matrix: the weak connections are lumped into the diagonal
+		double diagonal = 0.0, filtered = 0.0;
+		for (int k = a.start[i]; k < a.start[i + 1]; k++)
+			if (a.column[k] == i)
+				diagonal += a.value[k];
+		filtered = diagonal;
+		for (int k = a.start[i]; k < a.start[i + 1]; k++)
+		{
+			int j = a.column[k];
+			if ((j != i) && !std::binary_search(s.column.begin() + s.start[i], s.column.begin() + s.start[i + 1], j))
+				filtered += a.value[k];
+		}
+
+		int rowStart = (int)p.column.size();
+		auto add = [&](int c, double v) {
+			if (position[c] < rowStart)
+			{
+				position[c] = (int)p.column.size();
+				p.column.push_back(c);
+				p.value.push_back(v);
+			}
+			else
+				p.value[position[c]] += v;
+		};
+		if (filtered <= 1e-12 * std::fabs(diagonal)) // No strong connections: the tentative row
+			add(aggregates[i], 1.0);
+		else
+		{
+			// (I - omega D^-1 A) T, with T constant (1) over every aggregate
+			add(aggregates[i], 1.0 - omega);
+			for (int k = a.start[i]; k < a.start[i + 1]; k++)
+			{
+				int j = a.column[k];
+				if ((j != i) && std::binary_search(s.column.begin() + s.start[i], s.column.begin() + s.start[i + 1], j))
+					add(aggregates[j], -omega * a.value[k] / filtered);
+			}
+		}
+		p.start.push_back((int)p.column.size());
+	}
+	return p;
+}
+
+void AmgSolver::setup(const SparseMatrix& a)
+{
+	levels.clear();
+	levels.emplace_back();
+	levels[0].A = a;
+	for (;;)
+	{
+		Level& level = levels.back();
+		const SparseMatrix& fine = level.A;
+		if ((fine.rows <= coarsestSize) || ((int)levels.size() >= maxLevels))
+			break;
+
+		SparseMatrix s = strength(fine);
+		std::vector<int> aggregates;
+		int count = aggregate(s, aggregates);
+		if (count >= fine.rows) // No coarsening left
+			break;
+
+		level.P = prolongator(fine, s, aggregates, count);
+		level.R = level.P.transpose();
+		SparseMatrix coarse = level.R.times(fine.times(level.P));
+
+		// The prolongator keeps the constant (P 1 = 1), so the rows of the coarse matrix sum to zero as
+		// the ones of the fine matrix. Its diagonal is set from its off-diagonal entries: computed in
+		// the product, it would be the difference of large conductances, lost to rounding where a
+		// well conducting aggregate is held by weak (e.g. 1e-16) bonds only
+		for (int i = 0; i < coarse.rows; i++)
+		{
+			int diagonal = -1;
+			double sum = 0.0;
+			for (int k = coarse.start[i]; k < coarse.start[i + 1]; k++)
+				if (coarse.column[k] == i)
+					diagonal = k;
+				else
+					sum += coarse.value[k];
+			if (diagonal >= 0)
+				coarse.value[diagonal] = -sum;
+		}
+		levels.emplace_back();
+		levels.back().A = std::move(coarse);
+	}
+
+	// Scale of every unknown: the diagonal of the finest matrix, summed over the aggregates. An
+	// unknown whose diagonal is far below it (floating) is held by bonds much weaker than the ones
+	// inside it: e.g. a conducting island in an insulating matrix. Its correction would be rounding
+	// noise of the large conductances over the weak ones, so it is left at 0; its residual (the
+	// current through the weak bonds) is below any useful tolerance
+	for (size_t l = 0; l < levels.size(); l++)
+	{
+		Level& level = levels[l];
+		std::vector<double> d = diagonalOf(level.A);
+		if (l == 0)
+			level.scale = d;
+		else
+		{
+			const Level& fine = levels[l - 1];
+			level.scale.assign(level.A.rows, 0.0);
+			for (int i = 0; i < fine.R.rows; i++)
+				for (int k = fine.R.start[i]; k < fine.R.start[i + 1]; k++)
+					level.scale[i] += std::fabs(fine.R.value[k]) * fine.scale[fine.R.column[k]];
+		}
+		level.inverseDiagonal.resize(d.size());
+		for (size_t i = 0; i < d.size(); i++)
+			level.inverseDiagonal[i] = (d[i] > floating * level.scale[i]) ? 1.0 / d[i] : 0.0;
+		level.x.assign(level.A.rows, 0.0);
+		level.b.assign(level.A.rows, 0.0);
+		level.r.assign(level.A.rows, 0.0);
+	}
+	factorCoarsest();
+}
+
+void AmgSolver::setup(const double* gx, const double* gy, int nx, int ny)
+{
+	int nx2 = nx + 2;
+	SparseMatrix a;
+	a.rows = a.cols = nx * ny;
+	a.start.reserve((size_t)a.rows + 1);
+	a.column.reserve(5 * (size_t)a.rows);
+	a.value.reserve(5 * (size_t)a.rows);
+	a.start.push_back(0);
+	for (int row = 1; row <= ny; row++)
+		for (int col = 1; col <= nx; col++)
+		{
+			size_t i = (size_t)nx2 * row + col;
+			int k = (row - 1) * nx + (col - 1);
+			// Bonds to the left, right, upper and lower sites (periodic)
+			int left = (row - 1) * nx + ((col == 1) ? nx - 1 : col - 2);
+			int right = (row - 1) * nx + ((col == nx) ? 0 : col);
+			int up = ((row == 1) ? ny - 1 : row - 2) * nx + (col - 1);
+			int down = ((row == ny) ? 0 : row) * nx + (col - 1);
+			int neighbours[4] = { left, right, up, down };
+			double bonds[4] = { gx[i - 1], gx[i], gy[i - nx2], gy[i] };
+
+			int rowStart = (int)a.column.size();
+			a.column.push_back(k);
+			a.value.push_back(0.0);
+			for (int b = 0; b < 4; b++)
+			{
+				if ((bonds[b] == 0.0) || (neighbours[b] == k)) // A bond to itself (1 wide grid) carries no current
+					continue;
+				a.value[rowStart] += bonds[b];
+				int e = rowStart + 1;
+				while ((e < (int)a.column.size()) && (a.column[e] != neighbours[b]))
+					e++;
+				if (e < (int)a.column.size()) // Both bonds to the same site (2 wide grid)
+					a.value[e] -= bonds[b];
+				else
+				{
+					a.column.push_back(neighbours[b]);
+					a.value.push_back(-bonds[b]);
+				}
+			}
+			a.start.push_back((int)a.column.size());
+		}
+	setup(a);
+}
+
+void AmgSolver::factorCoarsest(void)
+{
+	const SparseMatrix& a = levels.back().A;
+	int n = a.rows;
+	coarseFactor.clear();
+	coarseSingular.assign(n, 0);
+	if (n > 8 * coarsestSize) // Too large to factorize (the coarsening stalled): smoothed instead
+		return;
+
+	coarseFactor.assign((size_t)n * n, 0.0);
+	for (int i = 0; i < n; i++)
+		for (int k = a.start[i]; k < a.start[i + 1]; k++)
+			coarseFactor[(size_t)i * n + a.column[k]] += a.value[k];
+	const std::vector<double>& scale = levels.back().scale;
+
+	// Cholesky, row by row of the lower factor; a floating pivot is left out (its unknown at 0)
+	for (int j = 0; j < n; j++)
+	{
+		double* lj = &coarseFactor[(size_t)j * n];
+		double pivot = lj[j];
+		for (int k = 0; k < j; k++)
+			pivot -= lj[k] * lj[k];
+		if (!(pivot > floating * scale[j]))
+		{
+			coarseSingular[j] = 1;
+			std::fill(lj, lj + j + 1, 0.0);
+			for (int i = j + 1; i < n; i++)
+				coarseFactor[(size_t)i * n + j] = 0.0;
+			continue;
+		}
+		lj[j] = std::sqrt(pivot);
+		for (int i = j + 1; i < n; i++)
+		{
+			double* li = &coarseFactor[(size_t)i * n];
+			double v = li[j];
+			for (int k = 0; k < j; k++)
+				v -= li[k] * lj[k];
+			li[j] = v / lj[j];
+		}
+	}
+}
+
+void AmgSolver::solveCoarsest(const double* b, double* x) const
+{
+	int n = levels.back().A.rows;
+	for (int i = 0; i < n; i++)
+	{
+		const double* li = &coarseFactor[(size_t)i * n];
+		double v = b[i];
+		for (int k = 0; k < i; k++)
+			v -= li[k] * x[k];
+		x[i] = coarseSingular[i] ? 0.0 : v / li[i];
+	}
+	for (int i = n - 1; i >= 0; i--)
+	{
+		double v = x[i];
+		for (int k = i + 1; k < n; k++)
+			v -= coarseFactor[(size_t)k * n + i] * x[k];
+		x[i] = coarseSingular[i] ? 0.0 : v / coarseFactor[(size_t)i * n + i];
+	}
+}
+
+void AmgSolver::forwardSweep(Level& level) const
+{
+	const SparseMatrix& a = level.A;
+	for (int i = 0; i < a.rows; i++)
+	{
+		double v = level.b[i];
+		for (int k = a.start[i]; k < a.start[i + 1]; k++)
+			v -= a.value[k] * level.x[a.column[k]];
+		level.x[i] += v * level.inverseDiagonal[i];
+	}
+}
+
+void AmgSolver::backwardSweep(Level& level) const
+{
+	const SparseMatrix& a = level.A;
+	for (int i = a.rows - 1; i >= 0; i--)
+	{
+		double v = level.b[i];
+		for (int k = a.start[i]; k < a.start[i + 1]; k++)
+			v -= a.value[k] * level.x[a.column[k]];
+		level.x[i] += v * level.inverseDiagonal[i];
+	}
+}
+
+void AmgSolver::cycle(size_t l)
+{
+	Level& level = levels[l];
+	std::fill(level.x.begin(), level.x.end(), 0.0);
+	if (l + 1 == levels.size())
+	{
+		if (!coarseFactor.empty())
+			solveCoarsest(level.b.data(), level.x.data());
+		else
+			for (int sweep = 0; sweep < 4; sweep++)
+			{
+				forwardSweep(level);
+				backwardSweep(level);
+			}
+		return;
+	}
+
+	// Pre-smoothing, coarse correction of the residual, post-smoothing in the reverse order
+	forwardSweep(level);
+	level.A.multiply(level.x.data(), level.r.data());
+	for (int i = 0; i < level.A.rows; i++)
+		level.r[i] = level.b[i] - level.r[i];
+	Level& coarse = levels[l + 1];
+	level.R.multiply(level.r.data(), coarse.b.data());
+	cycle(l + 1);
+	level.P.multiply(coarse.x.data(), level.r.data());
+	for (int i = 0; i < level.A.rows; i++)
+		level.x[i] += level.r[i];
+	backwardSweep(level);
+}
+
+void AmgSolver::vcycle(const double* b, double* x)
+{
+	if (levels.empty())
+		return;
+	Level& finest = levels[0];
+	std::copy(b, b + finest.A.rows, finest.b.begin());
+	cycle(0);
+	std::copy(finest.x.begin(), finest.x.end(), x);
+}
+
+double AmgSolver::operatorComplexity(void) const
+{
+	if (levels.empty() || (levels[0].A.entries() == 0))
+		return 0.0;
+	size_t entries = 0;
+	for (const Level& level : levels)
+		entries += level.A.entries();
+	return (double)entries / levels[0].A.entries();
+}
@@ -0,0 +1,117 @@
+/*
+This file is part of Electric,Thermal, Mechanical Properties
+Estimation With Percolation Theory (ETMPEWPT) (2D version) program.
+
+Created from Eleftherios Lamprou lef27064@otenet.gr during PhD thesis (2017-2024)
+
+ETMPEWPT is free software : you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+ETMPEWPT is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Foobar.If not, see < https://www.gnu.org/licenses/>.
+
+Theory of this is published in two papers:
+1. E. Lambrou and L. N. Gergidis, A computational method for calculating the electrical and thermal properties of random composite ,
+Physica A: Statistical Mechanics and its Applications, Volume 642, 2024, 129760, ISSN 0378-4371,
+https://doi.org/10.1016/j.physa.2024.129760
+2. E. Lambrou and L. N. Gergidis, A particle digitization-based computational method for continuum percolation, Physica A: Statistical Mechanics
+and its Applications, vol. 590, p. 126738, 2022
+
+if you use this programm and write a paper or report please cite above papers
+
+*/
+
+#pragma once // Ensures this header file is included only once in a compilation unit.
+
+#include <vector>
+#include <cstddef>
+
+// Sparse matrix in compressed rows.
+struct SparseMatrix {
+	int rows = 0, cols = 0;
+	std::vector<int> start;    // First entry of every row (rows + 1 values)
+	std::vector<int> column;   // Column of every entry
+	std::vector<double> value; // Value of every entry
+
+	// y = A x.
+	void multiply(const double* x, double* y) const;
+	// A^T.
+	SparseMatrix transpose(void) const;
+	// A B (Gustavson's row by row product).
+	SparseMatrix times(const SparseMatrix& b) const;
+	// Entries.
+	size_t entries(void) const { return value.size(); }
+};
+
+// Algebraic multigrid (smoothed aggregation) for the FDM conductance matrix, used as the
+// preconditioner of the CG solve of FD2DEL (AMG_SOLVER).
+//
+// The conductances of the phases may differ by many orders of magnitude (e.g. an insulating
+// matrix of 1e-16 against fillers of 1). A bond is a strong connection when its conductance is
+// large against the conductances of both of its sites, |a_ij| >= theta sqrt(a_ii a_jj), so the
+// bonds of an insulating region are strong among themselves and the bonds between an insulator
+// and a conductor are weak: aggregates never mix the phases and the coarse levels keep the
+// contrast. Every level is built from the one below it:
+// - aggregation of the strong connections (aggregates of a site and its strong neighbours,
+//   then the remaining sites joined to a neighbouring aggregate);
+// - the tentative prolongator, constant over every aggregate (the constant is the null space
+//   of the conductance matrix), smoothed by one damped Jacobi step of the matrix without its
+//   weak connections (lumped into the diagonal, so the rows still sum to zero);
+// - the coarse matrix P^T A P.
+// The coarsest level is factorized densely; its singular (floating) components are left at 0.
+// The setup is done once for a conductance network and every solve (vcycle) reuses it, so any
+// number of right hand sides (CG cycles, applied fields) costs one V-cycle each, in O(N) work.
+class AmgSolver {
+	struct Level {
+		SparseMatrix A;             // Matrix of the level
+		SparseMatrix P;             // Prolongation from the next coarser level
+		SparseMatrix R;             // Restriction to the next coarser level (P^T)
+		std::vector<double> scale;  // Finest diagonal summed over the aggregates of every unknown
+		std::vector<double> inverseDiagonal; // 0 for floating rows (diagonal below floating x scale)
+		std::vector<double> x, b, r; // Solution, right hand side and residual of a V-cycle
+	};
+	std::vector<Level> levels;
+	std::vector<double> coarseFactor; // Dense Cholesky factor of the coarsest matrix (lower, row major)
+	std::vector<char> coarseSingular; // Coarsest unknowns without a pivot (left at 0)
+
+	// Strong connections of a (rows of the strength graph sorted by column, the diagonal excluded).
+	SparseMatrix strength(const SparseMatrix& a) const;
+	// Aggregate of every row of the strength graph s; returns the aggregates.
+	int aggregate(const SparseMatrix& s, std::vector<int>& aggregates) const;
+	// Smoothed prolongator of the aggregates.
+	SparseMatrix prolongator(const SparseMatrix& a, const SparseMatrix& s, const std::vector<int>& aggregates, int count) const;
+	void factorCoarsest(void);
+	void solveCoarsest(const double* b, double* x) const;
+	// Symmetric Gauss-Seidel half sweeps of level l.
+	void forwardSweep(Level& level) const;
+	void backwardSweep(Level& level) const;
+	void cycle(size_t l);
+
+public:
+	double theta = 0.08;     // Strength of connection threshold
+	double floating = 1e-10; // Diagonal over scale below which an unknown is floating (not corrected)
+	int coarsestSize = 400;  // Unknowns of the level factorized densely
+	int maxLevels = 25;
+
+	// Builds the hierarchy of a matrix (symmetric, rows summing to zero, as a conductance network without
+	// fixed potentials).
+	void setup(const SparseMatrix& a);
+	// Builds the hierarchy of the periodic conductance network of an nx by ny grid, given in the
+	// padded layout of FD2DEL (gx, gy of (nx + 2) (ny + 2) sites, real sites in rows and columns 1..n).
+	// The unknowns are the real sites, row by row; the matrix is minus FD2DEL::prod.
+	void setup(const double* gx, const double* gy, int nx, int ny);
+	// x = M^-1 b, one V-cycle from x = 0 (a symmetric positive semidefinite approximate inverse).
+	void vcycle(const double* b, double* x);
+
+	int levelCount(void) const { return (int)levels.size(); }
+	int unknowns(void) const { return levels.empty() ? 0 : levels[0].A.rows; }
+	// Entries of all levels over the entries of the finest one.
+	double operatorComplexity(void) const;
+};
@@ -0,0 +1,431 @@
+/*
+This file is part of Electric,Thermal, Mechanical Properties
+Estimation With Percolation Theory (ETMPEWPT) (2D version) program.
+
+Created from Eleftherios Lamprou lef27064@otenet.gr during PhD thesis (2017-2024)
+
+ETMPEWPT is free software : you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+ETMPEWPT is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Foobar.If not, see < https://www.gnu.org/licenses/>.
+
+Theory of this is published in two papers:
+1. E. Lambrou and L. N. Gergidis, A computational method for calculating the electrical and thermal properties of random composite ,
+Physica A: Statistical Mechanics and its Applications, Volume 642, 2024, 129760, ISSN 0378-4371,
+https://doi.org/10.1016/j.physa.2024.129760
+2. E. Lambrou and L. N. Gergidis, A particle digitization-based computational method for continuum percolation, Physica A: Statistical Mechanics
+and its Applications, vol. 590, p. 126738, 2022
+
+if you use this programm and write a paper or report please cite above papers
+
+*/
+
+#include "Backbone.h"
+#include <cmath>
+#include <algorithm>
+#include "ProgressStatus.h" // CG convergence of the running realization for the status file
+
+int Backbone::gridBondOf(int r, int k) const
+{
+	int row = r / nx, col = r % nx;
+	if (k == 0)
+		return 2 * r;
+	if (k == 1)
+		return 2 * r + 1;
+	if (k == 2)
+		return 2 * (row * nx + ((col == 0) ? nx - 1 : col - 1));
+	return 2 * (((row == 0) ? ny - 1 : row - 1) * nx + col) + 1;
+}
+
+bool Backbone::gridBond(const double* gx, const double* gy, int e, int* a, int* b, double* g, double* d) const
+{
+	int r = e / 2, row = r / nx, col = r % nx;
+	size_t i = (size_t)(nx + 2) * (row + 1) + col + 1; // Padded index of the site
+	*a = r;
+	if (e % 2 == 0)
+	{
+		*b = row * nx + ((col == nx - 1) ? 0 : col + 1);
+		*d = (col == nx - 1) ? wrapX[row] : 0.0;
+		*g = gx[i];
+	}
+	else
+	{
+		*b = ((row == ny - 1) ? 0 : row + 1) * nx + col;
+		*d = (row == ny - 1) ? wrapY[col] : 0.0;
+		*g = gy[i];
+	}
+	return (*g > threshold) && (*a != *b); // A bond to itself (1 wide grid) has no unknown
+}
+
+void Backbone::link(int a, int b, double g, double d)
+{
+	for (int k = 0; k < 4; k++)
+	{
+		int e = slots[4 * (size_t)a + k];
+		if (e < 0)
+			continue;
+		Edge& edge = edges[e];
+		if ((edge.a == a) && (edge.b == b))
+			edge.d = (edge.g * edge.d + g * d) / (edge.g + g);
+		else if ((edge.a == b) && (edge.b == a))
+			edge.d = (edge.g * edge.d - g * d) / (edge.g + g);
+		else
+			continue;
+		edge.g += g; // Parallel bonds: the Norton equivalent
+		return;
+	}
+	int e = (int)edges.size();
+	edges.push_back({ a, b, g, d });
+	*std::find(slots.begin() + 4 * (size_t)a, slots.begin() + 4 * (size_t)a + 4, -1) = e;
+	*std::find(slots.begin() + 4 * (size_t)b, slots.begin() + 4 * (size_t)b + 4, -1) = e;
+}
+
+bool Backbone::build(const double* gx, const double* gy, const double* u, int inx, int iny, double cut)
+{
+	nx = inx;
+	ny = iny;
+	int n = nx * ny;
+	size_t nx2 = (size_t)nx + 2;
+
+	// Open bonds and applied voltages of the bonds across the boundaries (faces minus their images)
+	double strongest = 0.0;
+	for (int row = 1; row <= ny; row++)
+		for (int col = 1; col <= nx; col++)
+			strongest = std::max(strongest, std::max(gx[nx2 * row + col], gy[nx2 * row + col]));
+	threshold = cut * strongest;
+	wrapX.resize(ny);
+	wrapY.resize(nx);
+	double largest = 0.0;
+	for (int row = 1; row <= ny; row++)
+	{
+		wrapX[row - 1] = u[nx2 * row + nx + 1] - u[nx2 * row + 1];
+		largest = std::max(largest, std::fabs(wrapX[row - 1]));
+	}
+	for (int col = 1; col <= nx; col++)
+	{
+		wrapY[col - 1] = u[nx2 * (ny + 1) + col] - u[nx2 + col];
+		largest = std::max(largest, std::fabs(wrapY[col - 1]));
+	}
+	double tolerance = 1e-9 * (1.0 + largest);
+
+	// Biconnected blocks by an iterative depth first search (Tarjan). psi is a potential without
+	// current along the tree bonds; a back bond that does not fit it closes a cycle with a net
+	// applied voltage, and the block of that bond carries current
+	std::vector<int> discovery(n, -1), low(n), parent(n, -1);
+	std::vector<char> next(n, 0);
+	std::vector<double> psi(n);
+	std::vector<char> state(2 * (size_t)n, 0); // 1: closes a cycle with voltage, 2: kept
+	std::vector<int> stack, bondStack;
+	int time = 0;
+	blocks = 0;
+	for (int root = 0; root < n; root++)
+	{
+		if (discovery[root] >= 0)
+			continue;
+		discovery[root] = low[root] = time++;
+		psi[root] = 0.0;
+		stack.push_back(root);
+		while (!stack.empty())
+		{
+			int v = stack.back();
+			int a, b;
+			double g, d;
+			if (next[v] < 4)
+			{
+				int e = gridBondOf(v, next[v]++);
+				if ((e == parent[v]) || !gridBond(gx, gy, e, &a, &b, &g, &d))
+					continue;
+				int w = (a == v) ? b : a;
+				if (discovery[w] < 0)
+				{
+					parent[w] = e;
+					psi[w] = (a == v) ? psi[v] - d : psi[v] + d;
+					discovery[w] = low[w] = time++;
+					bondStack.push_back(e);
+					stack.push_back(w);
+				}
+				else if (discovery[w] < discovery[v]) // Back bond (a bond to a descendant was seen from it)
+				{
+					bondStack.push_back(e);
+					low[v] = std::min(low[v], discovery[w]);
+					if (std::fabs(psi[a] - psi[b] - d) > tolerance)
+						state[e] = 1;
+				}
+				continue;
+			}
+			stack.pop_back();
+			if (parent[v] < 0)
+				continue;
+			gridBond(gx, gy, parent[v], &a, &b, &g, &d);
+			int p = (a == v) ? b : a;
+			low[p] = std::min(low[p], low[v]);
+			if (low[v] >= discovery[p]) // The bonds down to parent[v] form a block
+			{
+				size_t first = bondStack.size();
+				bool current = false;
+				do
+				{
+					first--;
+					current = current || (state[bondStack[first]] == 1);
+				} while (bondStack[first] != parent[v]);
+				if (current)
+				{
+					for (size_t k = first; k < bondStack.size(); k++)
+						state[bondStack[k]] = 2;
+					blocks++;
+				}
+				bondStack.resize(first);
+			}
+		}
+	}
+	if (blocks == 0)
+		return false;
+
+	// Reduced network of the sites of the kept bonds
+	std::vector<int> reduced(n, -1);
+	site.clear();
+	edges.clear();
+	slots.clear();
+	for (int e = 0; e < 2 * n; e++)
+	{
+		int a, b;
+		double g, d;
+		if (state[e] != 2)
+			continue;
+		gridBond(gx, gy, e, &a, &b, &g, &d);
+		for (int s : { a, b })
+			if (reduced[s] < 0)
+			{
+				reduced[s] = (int)site.size();
+				site.push_back(s);
+				slots.insert(slots.end(), 4, -1);
+			}
+		link(reduced[a], reduced[b], g, d);
+	}
+	keptSites = (int)site.size();
+	x.resize(site.size());
+	for (size_t k = 0; k < site.size(); k++)
+		x[k] = u[nx2 * (site[k] / nx + 1) + site[k] % nx + 1];
+	reduce();
+
+	// System of the remaining sites: sum over the bonds of g (u_a - u_b - d) = 0 at every site
+	unknown.assign(site.size(), -1);
+	int count = 0;
+	for (size_t k = 0; k < site.size(); k++)
+		if (!eliminated[k] && (*std::max_element(slots.begin() + 4 * k, slots.begin() + 4 * k + 4) >= 0))
+			unknown[k] = count++;
+	system = SparseMatrix();
+	system.rows = system.cols = count;
+	system.start.push_back(0);
+	rhs.assign(count, 0.0);
+	for (size_t k = 0; k < site.size(); k++)
+	{
+		if (unknown[k] < 0)
+			continue;
+		int diagonal = (int)system.column.size();
+		system.column.push_back(unknown[k]);
+		system.value.push_back(0.0);
+		for (int s = 0; s < 4; s++)
+		{
+			int e = slots[4 * k + s];
+			if (e < 0)
+				continue;
+			const Edge& edge = edges[e];
+			bool first = (edge.a == (int)k);
+			system.value[diagonal] += edge.g;
+			system.column.push_back(unknown[first ? edge.b : edge.a]);
+			system.value.push_back(-edge.g);
+			rhs[unknown[k]] += first ? edge.g * edge.d : -edge.g * edge.d;
+		}
+		system.start.push_back((int)system.column.size());
+	}
+	return true;
+}
+
+void Backbone::reduce(void)
+{
+	eliminated.assign(site.size(), 0);
+	eliminations.clear();
+	auto degree = [&](int m) {
+		return 4 - (int)std::count(slots.begin() + 4 * (size_t)m, slots.begin() + 4 * (size_t)m + 4, -1);
+	};
+	// Bond e of site m: the neighbour n and the voltage delta it is seen at (current g (u_m - u_n - delta))
+	auto side = [&](int m, int e, int* neighbour, double* delta) {
+		const Edge& edge = edges[e];
+		*neighbour = (edge.a == m) ? edge.b : edge.a;
+		*delta = (edge.a == m) ? edge.d : -edge.d;
+	};
+	auto unlink = [&](int e) {
+		for (int s : { edges[e].a, edges[e].b })
+			*std::find(slots.begin() + 4 * (size_t)s, slots.begin() + 4 * (size_t)s + 4, e) = -1;
+		edges[e].g = 0.0;
+	};
+
+	std::vector<int> queue;
+	for (int m = 0; m < (int)site.size(); m++)
+		if (degree(m) <= 2)
+			queue.push_back(m);
+	while (!queue.empty())
+	{
+		int m = queue.back();
+		queue.pop_back();
+		int bonds = degree(m);
+		if (eliminated[m] || (bonds == 0) || (bonds > 2))
+			continue;
+		int e[2], k = 0;
+		for (int s = 0; s < 4; s++)
+			if (slots[4 * (size_t)m + s] >= 0)
+				e[k++] = slots[4 * (size_t)m + s];
+		Elimination step = { m, -1, -1, edges[e[0]].g, 0.0, 0.0, 0.0 };
+		side(m, e[0], &step.n1, &step.d1);
+		unlink(e[0]);
+		if (bonds == 2) // Series: n1 - m - n2 becomes one bond n1 - n2
+		{
+			step.g2 = edges[e[1]].g;
+			side(m, e[1], &step.n2, &step.d2);
+			unlink(e[1]);
+			link(step.n1, step.n2, step.g1 * step.g2 / (step.g1 + step.g2), step.d2 - step.d1);
+			queue.push_back(step.n2);
+		}
+		queue.push_back(step.n1);
+		eliminated[m] = 1;
+		eliminations.push_back(step);
+	}
+}
+
+int Backbone::solve(double gtest, int maxSteps)
+{
+	int n = system.rows;
+	std::vector<double> v(n), r(n), z(n), p(n), q(n);
+	for (size_t k = 0; k < site.size(); k++)
+		if (unknown[k] >= 0)
+			v[unknown[k]] = x[k];
+	auto dot = [n](const std::vector<double>& a, const std::vector<double>& b) {
+		double sum = 0.0;
+		for (int i = 0; i < n; i++)
+			sum += a[i] * b[i];
+		return sum;
+	};
+
+	// CG preconditioned by one V-cycle, as FD2DEL::dembxAmg
+	int steps = 0;
+	system.multiply(v.data(), q.data());
+	for (int i = 0; i < n; i++)
+		r[i] = rhs[i] - q[i];
+	double gg = dot(r, r);
+	if (gg > gtest)
+	{
+		amg.setup(system);
+		cgProgressStart(gg, gtest);
+		amg.vcycle(r.data(), z.data());
+		p = z;
+		double rho = dot(r, z);
+		for (; (steps < maxSteps) && (gg > gtest); steps++)
+		{
+			system.multiply(p.data(), q.data());
+			double lambda = rho / dot(p, q);
+			for (int i = 0; i < n; i++)
+			{
+				v[i] += lambda * p[i];
+				r[i] -= lambda * q[i];
+			}
+			gg = dot(r, r);
+			amg.vcycle(r.data(), z.data());
+			double rhoNew = dot(r, z);
+			double gamma = rhoNew / rho;
+			rho = rhoNew;
+			for (int i = 0; i < n; i++)
+				p[i] = z[i] + gamma * p[i];
+			cgProgress(steps + 1, gg);
+		}
+		cgProgressEnd();
+	}
+
+	// Potentials of the eliminated sites, the last eliminated first
+	for (size_t k = 0; k < site.size(); k++)
+		if (unknown[k] >= 0)
+			x[k] = v[unknown[k]];
+	for (size_t k = eliminations.size(); k-- > 0;)
+	{
+		const Elimination& step = eliminations[k];
+		if (step.n2 < 0)
+			x[step.m] = x[step.n1] + step.d1;
+		else
+			x[step.m] = (step.g1 * (x[step.n1] + step.d1) + step.g2 * (x[step.n2] + step.d2)) / (step.g1 + step.g2);
+	}
+	return steps;
+}
+
+void Backbone::mapBack(const double* gx, const double* gy, double* u) const
+{
+	int n = nx * ny;
+	size_t nx2 = (size_t)nx + 2;
+	std::vector<double> value(n);
+	std::vector<char> known(n, 0);
+	std::vector<int> queue;
+	for (size_t k = 0; k < site.size(); k++)
+	{
+		value[site[k]] = x[k];
+		known[site[k]] = 1;
+		queue.push_back(site[k]);
+	}
+
+	// Every other site takes the potential without current along the closed bonds: dead ends from
+	// the backbone, then every other cluster from the potential of its first site
+	for (int root = -1; root < n; root++)
+	{
+		if (root >= 0)
+		{
+			if (known[root])
+				continue;
+			value[root] = u[nx2 * (root / nx + 1) + root % nx + 1];
+			known[root] = 1;
+			queue.push_back(root);
+		}
+		while (!queue.empty())
+		{
+			int v = queue.back();
+			queue.pop_back();
+			for (int k = 0; k < 4; k++)
+			{
+				int a, b;
+				double g, d;
+				if (!gridBond(gx, gy, gridBondOf(v, k), &a, &b, &g, &d))
+					continue;
+				int w = (a == v) ? b : a;
+				if (known[w])
+					continue;
+				value[w] = (a == v) ? value[v] - d : value[v] + d;
+				known[w] = 1;
+				queue.push_back(w);
+			}
+		}
+	}
+
+	// Real sites, then the faces: their images plus the applied voltage they were given
+	std::vector<size_t> faces, images;
+	std::vector<double> offsets;
+	for (int row = 0; row <= ny + 1; row++)
+		for (int col = 0; col <= nx + 1; col++)
+		{
+			if ((row > 0) && (row <= ny) && (col > 0) && (col <= nx))
+				continue;
+			int imageRow = (row == 0) ? ny : ((row == ny + 1) ? 1 : row);
+			int imageCol = (col == 0) ? nx : ((col == nx + 1) ? 1 : col);
+			faces.push_back(nx2 * row + col);
+			images.push_back(nx2 * imageRow + imageCol);
+			offsets.push_back(u[faces.back()] - u[images.back()]);
+		}
+	for (int r = 0; r < n; r++)
+		u[nx2 * (r / nx + 1) + r % nx + 1] = value[r];
+	for (size_t k = 0; k < faces.size(); k++)
+		u[faces[k]] = u[images[k]] + offsets[k];
+}
@@ -0,0 +1,106 @@
+/*
+This file is part of Electric,Thermal, Mechanical Properties
+Estimation With Percolation Theory (ETMPEWPT) (2D version) program.
+
+Created from Eleftherios Lamprou lef27064@otenet.gr during PhD thesis (2017-2024)
+
+ETMPEWPT is free software : you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+ETMPEWPT is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Foobar.If not, see < https://www.gnu.org/licenses/>.
+
+Theory of this is published in two papers:
+1. E. Lambrou and L. N. Gergidis, A computational method for calculating the electrical and thermal properties of random composite ,
+Physica A: Statistical Mechanics and its Applications, Volume 642, 2024, 129760, ISSN 0378-4371,
+https://doi.org/10.1016/j.physa.2024.129760
+2. E. Lambrou and L. N. Gergidis, A particle digitization-based computational method for continuum percolation, Physica A: Statistical Mechanics
+and its Applications, vol. 590, p. 126738, 2022
+
+if you use this programm and write a paper or report please cite above papers
+
+*/
+
+#pragma once // Ensures this header file is included only once in a compilation unit.
+
+#include <vector>
+#include "Amg.h" // Solver of the reduced system
+
+// Current carrying backbone of the FDM conductance network (FD2DEL), solved in place of the
+// whole grid.
+//
+// Near the percolation threshold most sites belong to the insulating matrix, to clusters that do
+// not span the grid or to dead ends of the spanning cluster, and carry (next to) no current. The
+// reduction works on the bonds of the grid (periodic, with the jump of the applied field across
+// the boundaries):
+// - bonds weaker than cut x the strongest bond are taken as open (cut 0: only the zero bonds),
+//   which leaves the clusters of the conducting phases;
+// - the biconnected blocks of these clusters are found (Tarjan). A block carries current only
+//   if it holds a cycle around the periodic grid with a net applied voltage; any other block
+//   (a non-spanning cluster, a dead end hanging from one site) has a potential without current,
+//   so only the sites of the current carrying blocks are kept;
+// - sites of two bonds (series chains) and sites of one bond are eliminated, parallel bonds are
+//   merged (Norton equivalents).
+// The remaining sites are solved by CG preconditioned by algebraic multigrid, the eliminated
+// ones are substituted back and the potential of every other cluster is propagated along its
+// bonds, so the field (and its currents) is the one of the whole grid, up to the currents of the
+// open bonds.
+class Backbone {
+	struct Edge {
+		int a, b;    // Sites (reduced numbering)
+		double g, d; // Conductance and applied voltage: current g (u_a - u_b - d) from a to b
+	};
+	// Site m eliminated by series (or dead end, n2 < 0) reduction: u_m is the weighted mean of
+	// u_n1 + d1 and u_n2 + d2.
+	struct Elimination {
+		int m, n1, n2;
+		double g1, d1, g2, d2;
+	};
+
+	int nx = 0, ny = 0;
+	double threshold = 0.0;        // Bonds up to this conductance are open
+	std::vector<double> wrapX;     // Applied voltage of the bond from the last to the first column, per row
+	std::vector<double> wrapY;     // Applied voltage of the bond from the last to the first row, per column
+	std::vector<int> site;         // Grid site (row major, real sites) of every reduced site
+	std::vector<Edge> edges;       // Bonds of the reduced network (g 0: removed)
+	std::vector<int> slots;        // Four bond slots of every reduced site (-1: free)
+	std::vector<char> eliminated;  // Reduced sites eliminated
+	std::vector<Elimination> eliminations; // In the order of elimination
+	std::vector<int> unknown;      // Unknown of every reduced site in the system (-1: none)
+	std::vector<double> x;         // Potentials of the reduced sites
+	SparseMatrix system;
+	std::vector<double> rhs;
+	AmgSolver amg;
+
+	// Bond e of the grid (2 r: to the right of site r, 2 r + 1: below it, periodic); false when it is open.
+	bool gridBond(const double* gx, const double* gy, int e, int* a, int* b, double* g, double* d) const;
+	// Bond k (0..3: right, below, left, above) of grid site r.
+	int gridBondOf(int r, int k) const;
+	// Adds a bond between reduced sites a and b, merged with an existing bond between them.
+	void link(int a, int b, double g, double d);
+	// Eliminates the sites of one or two bonds.
+	void reduce(void);
+
+public:
+	int keptSites = 0; // Grid sites of the current carrying blocks
+	int blocks = 0;    // Current carrying blocks
+
+	// Finds the backbone of the periodic nx by ny network given in the padded layout of FD2DEL
+	// (gx, gy and the initial potential u with the applied field on the faces). Returns false when
+	// no block carries current (nothing spans the grid): the whole grid has to be solved.
+	bool build(const double* gx, const double* gy, const double* u, int nx, int ny, double cut);
+	// Solves the reduced system from the potentials of u until the squared residual is below
+	// gtest; returns the CG cycles.
+	int solve(double gtest, int maxSteps);
+	// Writes the potentials of the whole grid (real sites and faces) to u.
+	void mapBack(const double* gx, const double* gy, double* u) const;
+	// Unknowns of the reduced system.
+	int unknowns(void) const { return system.rows; }
+};
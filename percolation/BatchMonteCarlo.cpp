@@ -63,26 +63,28 @@ BatchMonteCarlo::BatchMonteCarlo(string idirectory)
 	settings.readFromFile("settings.txt");
 }
 
+// Releases the generators of inputs that were read but not reported
+BatchMonteCarlo::~BatchMonteCarlo(void)
+{
+	for (ShapeGenerator* shapes : iShapes)
+		delete shapes;
+}
+
 /// <summary>
-/// single Run of the algorithm (One Problem)
+/// Reads one input file (One Problem) and prepares its project
 /// </summary>
-/// <param name="fileName"></param>
-/// <param name="shapes"></param>
-// Performs a single Monte Carlo simulation run for a given input file and shape generator
-void BatchMonteCarlo::singleRun(string fileName, ShapeGenerator* shapes)
+/// <param name="i">index of the input file</param>
+// Reads the input file, creates the project directories and estimates the memory of the run
+void BatchMonteCarlo::readInput(int i)
 {
-	// Record the starting time of the simulation
-	clock_t start = clock();
+	ShapeGenerator* shapes = new ShapeGenerator();
+	iShapes[i] = shapes;
+	// Construct the full path to the input file
+	string fileName = exePath.generic_string() + "/" + inputfiles[i];
 
-	// Convert string file name to char*
-	char* cInputFile = &fileName[0u];
-	cout << "\n";
-	//cout << "--------------------------------------------------------------------------------------------------------------\n"; // Commented out formatting
 	cout << "Input File: " << fileName << "\n"; // Display the current input file
-	cout << "\n";
-	cout << "--------------------------------------------------------------------------------------------------------------\n";
 	// Read shape data from the input file
-	shapes->readFromFile(cInputFile);
+	shapes->readFromFile(&fileName[0u]);
 
 	// Create output directories for this project
 	shapes->initDirs();
@@ -90,74 +92,133 @@ void BatchMonteCarlo::singleRun(string fileName, ShapeGenerator* shapes)
 	// Solve for the area of all components based on their percentage weights
 	shapes->areaSolve();
 
-	// Display the grid dimensions
-	cout << "Running for " << shapes->width << "x" << shapes->height << " Grid \n";
+	// Point the shapes' settings pointer to the global settings
+	shapes->settings = &settings;
+
+	// Peak memory of the run, used to decide how many inputs run at the same time
+	jobMemory[i] = shapes->memoryFootprint();
+}
+
+/// <summary>
+/// Decides how many input files run at the same time and how many OpenMP threads each one gets
+/// </summary>
+/// <param name="jobs">indexes of the input files to run</param>
+// Concurrency is sized by the largest grid footprint against the available RAM (or set in settings)
+void BatchMonteCarlo::planConcurrency(const std::vector<int>& jobs)
+{
+	int cores = max(omp_get_num_procs() / distributed.localRanks, 1); // The ranks of an MPI run on this node share its cores
+	int maxWorkers = (int)min((size_t)cores, jobs.size());
+
+	if (distributed.sharesRealizations()) // All ranks merge every input in the same order: one at a time
+		workers = 1;
+	else if (settings.concurrentJobs > 0) // Fixed by the user
+		workers = min(settings.concurrentJobs, (int)jobs.size());
+	else
+	{
+		size_t largest = 1;
+		for (int i : jobs)
+			largest = max(largest, jobMemory[i]);
+		// Keep a fifth of the available memory for the system, the reports and the particle sets
+		size_t budget = availableMemory() / 5 * 4;
+		workers = (int)min((size_t)maxWorkers, budget / largest);
+	}
+	workers = max(workers, 1);
+	threadsPerJob = max(cores / workers, 1);
+	spareCores = (cores > workers) ? cores % workers : 0;
+
+	cout << "\n";
+	cout << "--------------------------------------------------------------------------------------------------------------\n";
+	cout << "Input files running concurrently: " << workers << " with " << threadsPerJob << " threads each";
+	if (spareCores > 0)
+		cout << " (" << spareCores << " with one more)";
+	cout << "\n";
+	cout << "--------------------------------------------------------------------------------------------------------------\n";
+}
+
+/// <summary>
+/// single Run of the algorithm (One Problem)
+/// </summary>
+/// <param name="i">index of the (already read) input file</param>
+// Performs a single Monte Carlo simulation run for an input file and its shape generator
+void BatchMonteCarlo::singleRun(int i)
+{
+	ShapeGenerator* shapes = iShapes[i];
 
-	// Initialize random number generator (if not already done)
+	// Display the grid dimensions
+	LOG_INFO("Running " << shapes->projectName << " for " << shapes->width << "x" << shapes->height << " Grid \n");
 
 	// Initialize the grid with specified width and height
 	Grid grid(shapes->width, shapes->height);
 
+	// Periodic (torus) boundaries for placement, percolation and clusters
+	grid.periodic = settings.isPeriodic;
+
 	// Point the shapes' grid pointer to the newly created grid
 	shapes->grid = &grid;
-	// Point the shapes' settings pointer to the global settings
-	shapes->settings = &settings;
 
-	// Reset the start time before the Monte Carlo simulation begins
-	start = clock();
+	// Record the starting time (wall and process CPU) before the Monte Carlo simulation begins
+	WallTimer timer;
+	double cpuStart = processCpuSeconds();
 
-	// Start the Monte Carlo simulation
+	// Start the Monte Carlo simulation, its progress in the status file
+	JobProgress* job = progressStatus.addJob(inputfiles[i], shapes->projectName, shapes->width, shapes->height);
+	attachJobProgress(job);
 	shapes->monteCarlo();
+	attachJobProgress(NULL);
+	progressStatus.endJob(job);
 
 	double sumMaxClusterRadius = 0;
 	double avgMaxClusterRadius = 0;
 
-	// Calculate the sum of maximum cluster radii
-	for (size_t i = 0; i < grid.cMaxClusterRadius.size(); i++)
-		sumMaxClusterRadius = sumMaxClusterRadius + grid.cMaxClusterRadius[i];
+	// Calculate the sum of maximum cluster radii (of all cases, merged into rank 0 when the ranks share them)
+	for (size_t i = 0; i < shapes->caseMaxClusterRadius.size(); i++)
+		sumMaxClusterRadius = sumMaxClusterRadius + shapes->caseMaxClusterRadius[i];
 
 	// Calculate the average maximum cluster radius
-	avgMaxClusterRadius = sumMaxClusterRadius / grid.cMaxClusterRadius.size();
+	if (!shapes->caseMaxClusterRadius.empty())
+		avgMaxClusterRadius = sumMaxClusterRadius / shapes->caseMaxClusterRadius.size();
 
 	// Store the average maximum cluster radius for this case
-	casesMeanMaxClusterRadius.push_back(avgMaxClusterRadius);
-	// Debug cout << "avgMaxClusterRadius=" << avgMaxClusterRadius <<"\n"; // Debugging line (commented out)
+	casesMeanMaxClusterRadius[i] = avgMaxClusterRadius;
+	LOG_DEBUG("avgMaxClusterRadius=" << avgMaxClusterRadius << "\n"); // Debug builds only (PERC_DEBUG_LOG)
 
 	//grid.cMaxClusterRadius.clear(); // Clear cluster radius data (commented out)
 	// Display simulation progress
-	cout << endl << "Running " << shapes->width << "x" << shapes->height << " grid " << shapes->iterations << " times " << endl;
+	LOG_INFO("\nFinished " << shapes->projectName << " " << shapes->width << "x" << shapes->height << " grid " << shapes->iterations << " times \n");
 
-	// Record the ending time of the simulation
-	clock_t end = clock();
-	// Calculate the CPU time used
-	double cpu_time_used = ((double)(end - start)) / CLOCKS_PER_SEC;
+	// Wall time of the run and CPU time of the process meanwhile (all threads)
+	double wall_time_used = timer.elapsed();
+	double cpu_time_used = processCpuSeconds() - cpuStart;
 
-	// Save simulation results
-	shapes->Report();             // Save general report
-	shapes->ReportWithSemicolon(); // Save report with semicolon delimiter
-	shapes->ReportStatistics();    // Save statistical report
+	// Save simulation results (rank 0 has the merged results when the ranks share the realizations)
+	if (!distributed.sharesRealizations() || (distributed.rank == 0))
+	{
+		shapes->Report();             // Save general report
+		shapes->ReportWithSemicolon(); // Save report with semicolon delimiter
+		shapes->ReportStatistics();    // Save statistical report
+	}
 
 	// Display total time taken
-	cout << "Total time =" << cpu_time_used << "sec or " << cpu_time_used / 60 << "min or " << cpu_time_used / 3600 << "h \n";
-	// Display finish time
-	cout << "Finish at " << NowToString();
+	// Display total time taken and finish time
+	LOG_INFO(shapes->projectName << ": Total time =" << wall_time_used << "sec or " << wall_time_used / 60 << "min or " << wall_time_used / 3600 << "h (CPU " << cpu_time_used << "sec)\n"
+		<< "Finish at " << NowToString());
 }
 
 // Gets all input files from the specified directory
 int BatchMonteCarlo::getInputFiles(void)
 {
 	//C++ 17*
-	total = 0; // Initialize total file count to 0
+	inputfiles.clear();
 
 	// Iterate through all files in the directory
 	for (const auto& file : std::filesystem::directory_iterator(directory))
 	{
 		// Store the generic string path of the file
-		inputfiles[total] = file.path().generic_string();
+		inputfiles.push_back(file.path().generic_string());
 		//cout << "\n Debug_2:" << inputfiles[count] << "\n"; // Debugging line (commented out)
 		//cout << "\n Debug:"<<file.path().generic_string() << "\n"; // Debugging line (commented out)
-		total++; // Increment the total file count
 	}
+	total = (int)inputfiles.size(); // Total file count
 
 	// Return 0 if files were found, otherwise return failure
 	if (total > 0)
@@ -190,37 +251,160 @@ void BatchMonteCarlo::Run()
 	char fileNameSemicolon[80]; // Buffer for semicolon-separated report file name
 	bool headerSaved = false;     // Flag to ensure header is saved only once
 
-
-	for (int i = 0; i < total; i++) // Loop through each input file
-	{
-		// Construct the full path to the input file
-		string inputfile = exePath.generic_string() + "/" + inputfiles[i];
-		// Check if the file is not a hidden file (doesn't start with '.')
+	// Input files to run: hidden files (starting with '.') are skipped
+	std::vector<int> jobs;
+	for (int i = 0; i < total; i++)
 		if (inputfiles[i][0] != '.')
+			jobs.push_back(i);
+
+	// All inputs are read first, so the memory of every run is known before the first one starts
+	casesMeanMaxClusterRadius.assign(total, 0);
+	jobMemory.assign(total, 0);
+	iShapes.assign(total, NULL);
+	for (int i : jobs)
+		readInput(i);
+	planConcurrency(jobs);
+
+	// Backing store of the grid planes (heap or memory map), the same for all runs
+	Grid::storage = settings.gridStorage;
+	Grid::backingDirectory = settings.gridBackingDirectory;
+
+	// Ranks of an MPI run share the realizations of every input or whole inputs
+	distributed.mode = settings.distribute;
+	if (distributed.size > 1)
+		LOG_INFO("MPI rank " << distributed.rank << " of " << distributed.size << ", sharing the "
+			<< (distributed.sharesRealizations() ? "realizations of every input" : "input files") << "\n");
+
+	// Console output of the runs: the level of the settings (warnings and errors only on ranks other than 0)
+	logLevel = settings.consoleLevel;
+	if ((distributed.rank != 0) && (logLevel > WARNING_LOG))
+		logLevel = WARNING_LOG;
+
+	// Images, shapes files and reports of the runs are written by the output queue (if enabled)
+	outputQueue.setEnabled(settings.asyncOutput);
+
+	// Progress, ETA, memory and CG convergence of the runs, rewritten for schedulers (if enabled)
+	progressStatus.start(settings.statusFile + ((distributed.rank != 0) ? "." + to_string(distributed.rank) : string()),
+		settings.statusInterval, (int)jobs.size());
+
+	// Interrupted batches continue at the next unfinished realization of every input; inputs
+	// that had finished only rewrite their reports from the checkpoint
+	if (settings.resume)
+		cout << "Resume: runs continue from the checkpoints of their projects\n";
+
+	// The backbone of spanning realizations is solved by its own multigrid preconditioned CG,
+	// in place of the FDM solver of the settings (MIXED solves the whole grid)
+	if ((settings.fdmBackbone >= 0.0) && (settings.fdmSolver != MIXED_SOLVER) && (settings.fdmSolver != AMG_SOLVER))
+		LOG_INFO("FDM backbone: bonds below " << settings.fdmBackbone << " of the strongest are open, the backbone of spanning"
+			<< " realizations is solved by multigrid preconditioned CG in place of the FDM solver setting\n");
+
+	// Workers take the next input file until none is left; each one has its own OpenMP thread count.
+	// Ranks sharing the input files take them from the counter of all ranks
+	std::mutex lock;
+	std::condition_variable finished;
+	size_t next = 0;
+	std::vector<char> done(jobs.size(), 0);
+	bool sharedInputs = distributed.sharesInputs();
+	if (sharedInputs)
+		distributed.resetCounter(0);
+	auto worker = [&](int threads) {
+		omp_set_num_threads(threads);
+		for (;;)
 		{
-			// Run a single simulation for the current input file
-			singleRun(inputfile, &iShapes[i]);
+			size_t k;
+			{
+				std::lock_guard<std::mutex> guard(lock);
+				k = sharedInputs ? (size_t)distributed.next() : next++;
+				if (k >= jobs.size())
+					return;
+			}
+			singleRun(jobs[k]);
+			{
+				std::lock_guard<std::mutex> guard(lock);
+				done[k] = 1;
+			}
+			finished.notify_all();
+		}
+	};
+	std::vector<std::thread> pool;
+	for (int w = 0; w < workers; w++)
+		pool.emplace_back(worker, threadsPerJob + ((w < spareCores) ? 1 : 0));
 
-			// Save report headers only once
-			if (!headerSaved)
+	// Input files shared by the ranks: rank 0 writes the rows of all ranks, in input order, when all runs have ended
+	if (sharedInputs)
+	{
+		for (std::thread& t : pool)
+			t.join();
+		pool.clear();
+
+		std::vector<std::pair<int, string>> rowsComma, rowsSemicolon;
+		for (size_t k = 0; k < jobs.size(); k++)
+			if (done[k])
 			{
-				headerSaved = true;
-				singlRunsaveResultstoReportHeader(ReportType::COMMA, &fileNameComma[0]);       // Header for comma-separated
-				singlRunsaveResultstoReportHeader(ReportType::SEMICOLON, &fileNameSemicolon[0]); // Header for semicolon-separated
+				rowsComma.emplace_back((int)k, reportRow(ReportType::COMMA, jobs[k]));
+				rowsSemicolon.emplace_back((int)k, reportRow(ReportType::SEMICOLON, jobs[k]));
 			}
+		distributed.gatherRows(rowsComma);
+		distributed.gatherRows(rowsSemicolon);
+		if (distributed.rank == 0)
+		{
+			std::sort(rowsComma.begin(), rowsComma.end());
+			std::sort(rowsSemicolon.begin(), rowsSemicolon.end());
+			singlRunsaveResultstoReportHeader(ReportType::COMMA, &fileNameComma[0], jobs[0]);
+			singlRunsaveResultstoReportHeader(ReportType::SEMICOLON, &fileNameSemicolon[0], jobs[0]);
+			std::ofstream commaFile(fileNameComma, std::ios_base::app);
+			for (const auto& row : rowsComma)
+				commaFile << row.second;
+			std::ofstream semicolonFile(fileNameSemicolon, std::ios_base::app);
+			for (const auto& row : rowsSemicolon)
+				semicolonFile << row.second;
+		}
+		for (int i : jobs)
+		{
+			delete iShapes[i];
+			iShapes[i] = NULL;
+		}
+	}
+
+	// Report rows are written in input order, as soon as a run and all runs before it have finished
+	for (size_t k = 0; k < (sharedInputs ? 0 : jobs.size()); k++)
+	{
+		{
+			std::unique_lock<std::mutex> guard(lock);
+			finished.wait(guard, [&] { return done[k] != 0; });
+		}
+		int i = jobs[k];
+
+		// Save report headers only once (rank 0 has the merged results when the ranks share the realizations)
+		if (!headerSaved && (distributed.rank == 0))
+		{
+			headerSaved = true;
+			singlRunsaveResultstoReportHeader(ReportType::COMMA, &fileNameComma[0], i);       // Header for comma-separated
+			singlRunsaveResultstoReportHeader(ReportType::SEMICOLON, &fileNameSemicolon[0], i); // Header for semicolon-separated
+		}
 
-			// Save results for the current run to both report types
+		// Save results for the current run to both report types
+		if (distributed.rank == 0)
+		{
 			singlRunsaveResultstoReport(ReportType::COMMA, &fileNameComma[0], i);       // Save to comma-separated
 			singlRunsaveResultstoReport(ReportType::SEMICOLON, &fileNameSemicolon[0], i); // Save to semicolon-separated
 		}
+
+		// The generator (and its per case results) is no longer needed
+		delete iShapes[i];
+		iShapes[i] = NULL;
 	}
 
-	//saveResults();           // (Commented out)
-	//saveResultsWithSemicolon(); // (Commented out)
+	for (std::thread& t : pool)
+		t.join();
+
+	// All outputs on disk before the batch ends
+	outputQueue.flush();
+	progressStatus.stop();
 }
 
-// Saves the header of the report for a single run
-void BatchMonteCarlo::singlRunsaveResultstoReportHeader(ReportType ireportType, char* fileName)
+// Saves the header of the report, with the columns of run i
+void BatchMonteCarlo::singlRunsaveResultstoReportHeader(ReportType ireportType, char* fileName, int i)
 {
 	string seperator; // Separator string (comma or semicolon)
 	time_t t = time(0); // Get current time
@@ -258,31 +442,31 @@ void BatchMonteCarlo::singlRunsaveResultstoReportHeader(ReportType ireportType,
 
 	// Write column headers
 	componentFile << "Case" << seperator << "Mean Percolation Probability" << seperator;
-	if (this->iShapes[0].calcStatistcs) // If statistics calculation is enabled
+	if (iShapes[i]->calcStatistcs) // If statistics calculation is enabled
 		componentFile << "Max Cluster Radius" << seperator << "Correlation" << seperator << "Length" << seperator;
 
-	if (this->iShapes[0].calcElectricConductivity) // If electric conductivity calculation is enabled
+	if (iShapes[i]->calcElectricConductivity) // If electric conductivity calculation is enabled
 		componentFile << "Electric Conductivity" << seperator << "Thermal Conductivity" << seperator << "Young Modulus"
 		<< seperator << "Poisson Ratio" << seperator << "Total Conductive Paths" << seperator << "Mean Conductive Length" << seperator
 		<< "Log Electric Conductivity" << seperator << "Log Thermal Conductivity" << seperator << "Log Young Modulus"
 		<< seperator << "Log Poisson Ratio" << seperator << "Log Total Conductive Paths" << seperator << "Log Mean Conductive Length" << seperator;
 
-	if (this->iShapes[0].calcElectricConductivityWithFDM) // If FDM electric conductivity is enabled
+	if (iShapes[i]->calcElectricConductivityWithFDM) // If FDM electric conductivity is enabled
 		componentFile << "FDM Ix" << seperator << "FDM Iy" << seperator << "FDM ro" << seperator;
 
 	componentFile << "Process Time" << seperator << "Preperation Time" << seperator << "Grid(X)" << seperator << "Grid(Y)" << seperator << "ppms" << seperator;
 
 	// Write headers for component-specific properties
-	for (int j = 0; j < iShapes[0].totalComponents; j++)
+	for (int j = 0; j < iShapes[i]->totalComponents; j++)
 		componentFile << "% Area - " << j << seperator;
-	for (int j = 0; j < iShapes[0].totalComponents; j++)
+	for (int j = 0; j < iShapes[i]->totalComponents; j++)
 		componentFile << "% Real Area - " << j << seperator;
-	for (int j = 0; j < iShapes[0].totalComponents; j++)
+	for (int j = 0; j < iShapes[i]->totalComponents; j++)
 		componentFile << "Size X -" << j << seperator;
 
-	for (int j = 0; j < iShapes[0].totalComponents; j++)
+	for (int j = 0; j < iShapes[i]->totalComponents; j++)
 		componentFile << "Size Y -" << j << seperator;
-	for (int j = 0; j < iShapes[0].totalComponents; j++)
+	for (int j = 0; j < iShapes[i]->totalComponents; j++)
 		componentFile << "Hoop Size - " << j << seperator;
 
 	componentFile << "\n"; // New line after headers
@@ -293,9 +477,18 @@ void BatchMonteCarlo::singlRunsaveResultstoReportHeader(ReportType ireportType,
 
 // Saves results for a single run to the report file
 void BatchMonteCarlo::singlRunsaveResultstoReport(ReportType ireportType, char* fileName, int i)
+{
+	// Open the file in append mode
+	std::ofstream componentFile(fileName, std::ios_base::app);
+	componentFile << reportRow(ireportType, i);
+	componentFile.close(); // Close the file
+}
+
+// Row of the report with the results of run i
+string BatchMonteCarlo::reportRow(ReportType ireportType, int i)
 {
 	string seperator;          // Separator string (comma or semicolon)
-	std::ofstream componentFile; // Output file stream
+	std::ostringstream componentFile; // The row
 
 	if (ireportType == SEMICOLON) // If report type is semicolon-separated
 	{
@@ -306,172 +499,55 @@ void BatchMonteCarlo::singlRunsaveResultstoReport(ReportType ireportType, char*
 	else
 		seperator = ","; // Set separator to comma
 
-	// Open the file in append mode
-	componentFile.open(fileName, std::ios_base::app);
 	// Calculate mean paths and mean path length
-	double meanPaths = average_element(iShapes[i].paths, 0, iShapes[i].iterations);
-	double meanPathsLength = average_element(iShapes[i].meanPathLength, 0, iShapes[i].iterations);
+	double meanPaths = average_element(iShapes[i]->paths.data(), 0, iShapes[i]->iterations);
+	double meanPathsLength = average_element(iShapes[i]->meanPathLength.data(), 0, iShapes[i]->iterations);
 	// Write case name and mean percolation probability
-	componentFile << iShapes[i].projectName << seperator << iShapes[i].meanPercolation << seperator;
-	if (this->iShapes[0].calcStatistcs) // If statistics calculation is enabled
-		componentFile << casesMeanMaxClusterRadius[i] << seperator << iShapes[i].correleationLength << seperator;
-	if (this->iShapes[0].calcElectricConductivity) // If electric conductivity calculation is enabled
-		componentFile << iShapes[i].meanElectricConductivity << seperator << iShapes[i].meanThermalConductivity << seperator
-		<< iShapes[i].meanYoungModulus << seperator << iShapes[i].meanPoissonRatio << seperator << meanPaths << seperator << meanPathsLength << seperator
-		<< log(iShapes[i].meanElectricConductivity) << seperator << log(iShapes[i].meanThermalConductivity) << seperator
-		<< log(iShapes[i].meanYoungModulus) << seperator << log(iShapes[i].meanPoissonRatio) << seperator << log(meanPaths) << seperator << log(meanPathsLength) << seperator;
-	if (this->iShapes[0].calcElectricConductivityWithFDM) // If FDM electric conductivity is enabled
-		componentFile << setw(13) << iShapes[i].FDResults[2 * i] << seperator << setw(13) << iShapes[i].FDResults[2 * i + 1] << seperator << setw(13) << (1 / iShapes[i].FDResults[2 * i]) << seperator;
+	componentFile << iShapes[i]->projectName << seperator << iShapes[i]->meanPercolation << seperator;
+	if (iShapes[i]->calcStatistcs) // If statistics calculation is enabled
+		componentFile << casesMeanMaxClusterRadius[i] << seperator << iShapes[i]->correleationLength << seperator;
+	if (iShapes[i]->calcElectricConductivity) // If electric conductivity calculation is enabled
+		componentFile << iShapes[i]->meanElectricConductivity << seperator << iShapes[i]->meanThermalConductivity << seperator
+		<< iShapes[i]->meanYoungModulus << seperator << iShapes[i]->meanPoissonRatio << seperator << meanPaths << seperator << meanPathsLength << seperator
+		<< log(iShapes[i]->meanElectricConductivity) << seperator << log(iShapes[i]->meanThermalConductivity) << seperator
+		<< log(iShapes[i]->meanYoungModulus) << seperator << log(iShapes[i]->meanPoissonRatio) << seperator << log(meanPaths) << seperator << log(meanPathsLength) << seperator;
+	if (iShapes[i]->calcElectricConductivityWithFDM) // If FDM electric conductivity is enabled
+	{
+		// Mean FDM currents over the realizations of this run
+		double meanIx = 0, meanIy = 0;
+		for (int c = 0; c < iShapes[i]->iterations; c++)
+		{
+			meanIx += iShapes[i]->FDResults[2 * c];
+			meanIy += iShapes[i]->FDResults[2 * c + 1];
+		}
+		meanIx /= iShapes[i]->iterations;
+		meanIy /= iShapes[i]->iterations;
+		componentFile << setw(13) << meanIx << seperator << setw(13) << meanIy << seperator << setw(13) << (1 / meanIx) << seperator;
+	}
 
 	// Write process time, preparation time, grid dimensions, and pixels per minimum size
-	componentFile << iShapes[i].meanSetUpTime << seperator << iShapes[i].meanTime << seperator << iShapes[i].width << seperator << iShapes[i].height << seperator
-		<< iShapes[i].pixelsPerMinimumSize;
+	componentFile << iShapes[i]->meanSetUpTime << seperator << iShapes[i]->meanTime << seperator << iShapes[i]->width << seperator << iShapes[i]->height << seperator
+		<< iShapes[i]->pixelsPerMinimumSize;
 
 	// Write component-specific area percentages
-	for (int j = 0; j < iShapes[i].totalComponents; j++)
-		componentFile << seperator << iShapes[i].componentsArea[j];
+	for (int j = 0; j < iShapes[i]->totalComponents; j++)
+		componentFile << seperator << iShapes[i]->componentsArea[j];
 	// Write real component area percentages
-	for (int j = 0; j < iShapes[i].totalComponents; j++)
-		componentFile << seperator << iShapes[i].realComponentAreas[j];
+	for (int j = 0; j < iShapes[i]->totalComponents; j++)
+		componentFile << seperator << iShapes[i]->realComponentAreas[j];
 	// Write component-specific X dimensions
-	for (int j = 0; j < iShapes[i].totalComponents; j++)
-		componentFile << seperator << iShapes[i].dimensionX[j];
+	for (int j = 0; j < iShapes[i]->totalComponents; j++)
+		componentFile << seperator << iShapes[i]->dimensionX[j];
 
 	// Write component-specific Y dimensions
-	for (int j = 0; j < iShapes[i].totalComponents; j++)
-		componentFile << seperator << iShapes[i].dimensionY[j];
+	for (int j = 0; j < iShapes[i]->totalComponents; j++)
+		componentFile << seperator << iShapes[i]->dimensionY[j];
 
 	// Write component-specific hoop sizes
-	for (int j = 0; j < iShapes[i].totalComponents; j++)
-		componentFile << seperator << iShapes[i].hoops[j];
+	for (int j = 0; j < iShapes[i]->totalComponents; j++)
+		componentFile << seperator << iShapes[i]->hoops[j];
 
 	componentFile << "\n"; // New line for the next entry
 
-	componentFile.close(); // Close the file
+	return componentFile.str();
 }
-
-// Saves all results to a report file based on the specified report type
-void BatchMonteCarlo::saveResultstoReport(ReportType ireportType)
-{
-	string seperator;          // Separator string (comma or semicolon)
-	time_t t = time(0);         // Get current time
-	struct tm* now = localtime(&t); // Convert to local time
-
-	char fileName[80];          // Buffer for report file name
-	std::ofstream componentFile; // Output file stream
-
-	if (ireportType == SEMICOLON) // If report type is semicolon-separated
-	{
-		seperator = ";"; // Set separator to semicolon
-		// Format file name with date and time for semicolon report
-		strftime(fileName, 80, "Report %Y-%m-%d %H %M %S-Semicolon.csv", now);
-		std::locale cpploc{ "" }; // Set locale
-		componentFile.imbue(cpploc); // Imbue locale for proper numeric formatting
-		componentFile.open(fileName); // Open the file
-	}
-	else // If report type is comma-separated (default)
-	{
-		seperator = ","; // Set separator to comma
-		// Format file name with date and time for comma report
-		strftime(fileName, 80, "Report %Y-%m-%d %H %M %S-Comma.csv", now);
-		componentFile.open(fileName); // Open the file
-	}
-
-	// Write program information and header
-	componentFile << "-------------------------------------------------------------------------------------------------------------------------\n";
-	componentFile << info.program;
-	componentFile << info.version;
-	componentFile << info.date;
-	componentFile << info.author;
-	componentFile << info.licence;
-	componentFile << "-------------------------------------------------------------------------------------------------------------------------\n";
-	componentFile << "Start at " << NowToString() << "\n";
-
-	// Write column headers
-	componentFile << "Case" << seperator << "Mean Percolation Probability" << seperator;
-	if (this->iShapes[0].calcStatistcs) // If statistics calculation is enabled
-		componentFile << "Max Cluster Radius" << seperator << "Correlation" << seperator << "Length" << seperator;
-
-	if (this->iShapes[0].calcElectricConductivity) // If electric conductivity calculation is enabled
-		componentFile << "Electric Conductivity" << seperator << "Thermal Conductivity" << seperator << "Young Modulus"
-		<< seperator << "Poisson Ratio" << seperator << "Total Conductive Paths" << seperator << "Mean Conductive Length" << seperator
-		<< "Log Electric Conductivity" << seperator << "Log Thermal Conductivity" << seperator << "Log Young Modulus"
-		<< seperator << "Log Poisson Ratio" << seperator << "Log Total Conductive Paths" << seperator << "Log Mean Conductive Length" << seperator;
-
-	if (this->iShapes[0].calcElectricConductivityWithFDM) // If FDM electric conductivity is enabled
-		componentFile << "FDM Ix" << seperator << "FDM Iy" << seperator << "FDM ro" << seperator;
-
-	componentFile << "Process Time" << seperator << "Preperation Time" << seperator << "Grid(X)" << seperator << "Grid(Y)" << seperator << "ppms" << seperator;
-
-	// Write headers for component-specific properties
-	for (int j = 0; j < iShapes[0].totalComponents; j++)
-		componentFile << "% Area - " << j << seperator;
-	for (int j = 0; j < iShapes[0].totalComponents; j++)
-		componentFile << "% Real Area - " << j << seperator;
-	for (int j = 0; j < iShapes[0].totalComponents; j++)
-		componentFile << "Size X -" << j << seperator;
-
-	for (int j = 0; j < iShapes[0].totalComponents; j++)
-		componentFile << "Size Y -" << j << seperator;
-	for (int j = 0; j < iShapes[0].totalComponents; j++)
-		componentFile << "Hoop Size - " << j << seperator;
-
-	componentFile << "\n"; // New line after headers
-
-
-	for (int i = 0; i < total; i++) // Loop through each simulation case
-	{
-		// Calculate mean paths and mean path length
-		double meanPaths = average_element(iShapes[i].paths, 0, iShapes[i].iterations);
-		double meanPathsLength = average_element(iShapes[i].meanPathLength, 0, iShapes[i].iterations);
-		// Write case name and mean percolation probability
-		componentFile << iShapes[i].projectName << seperator << iShapes[i].meanPercolation << seperator;
-		if (this->iShapes[0].calcStatistcs) // If statistics calculation is enabled
-			componentFile << casesMeanMaxClusterRadius[i] << seperator << iShapes[i].correleationLength << seperator;
-		if (this->iShapes[0].calcElectricConductivity) // If electric conductivity calculation is enabled
-			componentFile << iShapes[i].meanElectricConductivity << seperator << iShapes[i].meanThermalConductivity << seperator
-			<< iShapes[i].meanYoungModulus << seperator << iShapes[i].meanPoissonRatio << seperator << meanPaths << seperator << meanPathsLength << seperator
-			<< log(iShapes[i].meanElectricConductivity) << seperator << log(iShapes[i].meanThermalConductivity) << seperator
-			<< log(iShapes[i].meanYoungModulus) << seperator << log(iShapes[i].meanPoissonRatio) << seperator << log(meanPaths) << seperator << log(meanPathsLength) << seperator;
-		if (this->iShapes[0].calcElectricConductivityWithFDM) // If FDM electric conductivity is enabled
-			componentFile << setw(13) << iShapes[i].FDResults[2 * i] << seperator << setw(13) << iShapes[i].FDResults[2 * i + 1] << seperator << setw(13) << (1 / iShapes[i].FDResults[2 * i]) << seperator;
-
-		// Write process time, preparation time, grid dimensions, and pixels per minimum size
-		componentFile << iShapes[i].meanSetUpTime << seperator << iShapes[i].meanTime << seperator << iShapes[i].width << seperator << iShapes[i].height << seperator
-			<< iShapes[i].pixelsPerMinimumSize;
-
-		// Write component-specific area percentages
-		for (int j = 0; j < iShapes[i].totalComponents; j++)
-			componentFile << seperator << iShapes[i].componentsArea[j];
-		// Write real component area percentages
-		for (int j = 0; j < iShapes[i].totalComponents; j++)
-			componentFile << seperator << iShapes[i].realComponentAreas[j];
-		// Write component-specific X dimensions
-		for (int j = 0; j < iShapes[i].totalComponents; j++)
-			componentFile << seperator << iShapes[i].dimensionX[j];
-
-		// Write component-specific Y dimensions
-		for (int j = 0; j < iShapes[i].totalComponents; j++)
-			componentFile << seperator << iShapes[i].dimensionY[j];
-
-		// Write component-specific hoop sizes
-		for (int j = 0; j < iShapes[i].totalComponents; j++)
-			componentFile << seperator << iShapes[i].hoops[j];
-		componentFile << "\n"; // New line for the next entry
-
-	}
-
-	componentFile.close(); // Close the file
-
-}
-// Saves results to a report file with semicolon as the delimiter
-void BatchMonteCarlo::saveResultsWithSemicolon(void)
-{
-	saveResultstoReport(SEMICOLON); // Call the general save function with SEMICOLON type
-}
-
-// Saves results to a report file with comma as the delimiter
-void BatchMonteCarlo::saveResults(void)
-{
-	saveResultstoReport(COMMA); // Call the general save function with COMMA type
-}
\ No newline at end of file
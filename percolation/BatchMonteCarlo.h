@@ -28,6 +28,11 @@ if you use this programm and write a paper or report please cite above papers
 */
 
 #include <filesystem>
+#include <thread>             // Concurrent input files
+#include <mutex>
+#include <condition_variable>
+#include <sstream>            // Report rows of the ranks of an MPI run
+#include <algorithm>
 
 #include "Shapes.h"
 #include "Grid.h"
@@ -36,38 +41,41 @@ if you use this programm and write a paper or report please cite above papers
 #include "general.h"
 
 
-
-#define maxFilesInDir 300
-
 class BatchMonteCarlo {
 public:
 	int total=0;
 
 
 	string directory;
-	string inputfiles[maxFilesInDir];
+	std::vector<string> inputfiles;
 	//string exePath;
 
 	std::filesystem::path  exePath;
 	Settings settings;
-	ShapeGenerator iShapes[maxFilesInDir];
+	// One generator per input file, created when the input is read and released after its report rows are written
+	std::vector<ShapeGenerator*> iShapes;
 
 	//std::vector<double> maxClusterRadiusPerCase;
 	std::vector<double> casesMeanMaxClusterRadius;
+	std::vector<size_t> jobMemory; // Estimated peak memory (bytes) of each input file
+
+	int workers = 1;      // Input files run at the same time
+	int threadsPerJob = 0; // OpenMP threads of each running input file
+	int spareCores = 0;    // Cores left over by threadsPerJob: the first spareCores workers get one more thread
 
 	//initialize
 	BatchMonteCarlo(void);
 	BatchMonteCarlo(string idirectory);
+	~BatchMonteCarlo(void);
 	//void singleRun(string fileName, ShapeGenerator *shapes);
-	void singleRun(string fileName, ShapeGenerator* shapes);
+	void singleRun(int i);
+	void readInput(int i);
+	void planConcurrency(const std::vector<int>& jobs);
 	int getInputFiles(void);
 	void show(void);
 	void Run();
-	void singlRunsaveResultstoReportHeader(ReportType ireportType, char* fileName);
+	void singlRunsaveResultstoReportHeader(ReportType ireportType, char* fileName, int i);
 
 	void singlRunsaveResultstoReport(ReportType ireportType, char* fileName, int i);
-	
-	void saveResultstoReport(ReportType ireportType);
-	void saveResultsWithSemicolon(void);
-	void saveResults();
+	string reportRow(ReportType ireportType, int i);
 };
\ No newline at end of file
@@ -0,0 +1,125 @@
+/*
+This file is part of Electric,Thermal, Mechanical Properties
+Estimation With Percolation Theory (ETMPEWPT) (2D version) program.
+
+Created from Eleftherios Lamprou lef27064@otenet.gr during PhD thesis (2017-2024)
+
+ETMPEWPT is free software : you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+ETMPEWPT is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Foobar.If not, see < https://www.gnu.org/licenses/>.
+
+Theory of this is published in two papers:
+1. E. Lambrou and L. N. Gergidis, A computational method for calculating the electrical and thermal properties of random composite ,
+Physica A: Statistical Mechanics and its Applications, Volume 642, 2024, 129760, ISSN 0378-4371,
+https://doi.org/10.1016/j.physa.2024.129760
+2. E. Lambrou and L. N. Gergidis, A particle digitization-based computational method for continuum percolation, Physica A: Statistical Mechanics
+and its Applications, vol. 590, p. 126738, 2022
+
+if you use this programm and write a paper or report please cite above papers
+
+*/
+
+#include "Checkpoint.h"
+#include <iostream>    // std::cerr.
+#include <filesystem>  // Rename of the temporary file.
+#include <algorithm>   // std::min.
+
+int Checkpoint::find(const char* name, size_t elementBytes) const
+{
+	for (size_t k = 0; k < blocks.size(); k++)
+		if ((strncmp(blocks[k].name, name, sizeof(blocks[k].name)) == 0) && (blocks[k].elementBytes == elementBytes))
+			return (int)k;
+	return -1;
+}
+
+size_t Checkpoint::bytes(void) const
+{
+	size_t total = sizeof(header);
+	for (size_t k = 0; k < blocks.size(); k++)
+		total += sizeof(CheckpointBlock) + data[k].size();
+	return total;
+}
+
+bool Checkpoint::save(const std::string& fileName) const
+{
+	std::string temporary = fileName + ".tmp";
+	FILE* file = fopen(temporary.c_str(), "wb");
+	if (file == NULL)
+	{
+		std::cerr << "*** Warning: Could not create checkpoint " << temporary << " ****\n";
+		return false;
+	}
+
+	CheckpointHeader out = header;
+	memcpy(out.magic, checkpointMagic, sizeof(out.magic));
+	out.version = 1;
+	out.blocks = (uint32_t)blocks.size();
+	bool written = (fwrite(&out, sizeof(out), 1, file) == 1);
+	for (size_t k = 0; written && (k < blocks.size()); k++)
+		written = (fwrite(&blocks[k], sizeof(CheckpointBlock), 1, file) == 1)
+			&& (fwrite(data[k].data(), 1, data[k].size(), file) == data[k].size());
+	written = (fclose(file) == 0) && written;
+
+	// The previous checkpoint is replaced only by a complete one
+	std::error_code error;
+	if (written)
+		std::filesystem::rename(temporary, fileName, error);
+	if (!written || error)
+	{
+		std::cerr << "*** Warning: Error writing at checkpoint " << fileName << " ****\n";
+		return false;
+	}
+	return true;
+}
+
+bool Checkpoint::load(const std::string& fileName)
+{
+	blocks.clear();
+	data.clear();
+	header = {};
+
+	FILE* file = fopen(fileName.c_str(), "rb");
+	if (file == NULL)
+		return false;
+	fseek(file, 0, SEEK_END);
+	uint64_t left = (uint64_t)ftell(file); // Bytes not read yet (a block cannot be longer)
+	fseek(file, 0, SEEK_SET);
+
+	bool valid = (fread(&header, sizeof(header), 1, file) == 1) && (memcmp(header.magic, checkpointMagic, sizeof(header.magic)) == 0);
+	left -= std::min(left, (uint64_t)sizeof(header));
+	for (uint32_t k = 0; valid && (k < header.blocks); k++)
+	{
+		CheckpointBlock block;
+		valid = (fread(&block, sizeof(block), 1, file) == 1);
+		if (!valid)
+			break;
+		block.name[sizeof(block.name) - 1] = 0;
+		left -= std::min(left, (uint64_t)sizeof(block));
+		valid = (block.elementBytes > 0) && (block.count <= left / block.elementBytes);
+		if (!valid)
+			break;
+		left -= block.count * block.elementBytes;
+		std::vector<unsigned char> values((size_t)(block.count * block.elementBytes));
+		valid = values.empty() || (fread(values.data(), 1, values.size(), file) == values.size());
+		blocks.push_back(block);
+		data.push_back(std::move(values));
+	}
+	fclose(file);
+	if (!valid)
+	{
+		std::cerr << "*** Warning: " << fileName << " is not a valid checkpoint ****\n";
+		blocks.clear();
+		data.clear();
+		header = {};
+	}
+	return valid;
+}
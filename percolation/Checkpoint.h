@@ -0,0 +1,110 @@
+/*
+This file is part of Electric,Thermal, Mechanical Properties
+Estimation With Percolation Theory (ETMPEWPT) (2D version) program.
+
+Created from Eleftherios Lamprou lef27064@otenet.gr during PhD thesis (2017-2024)
+
+ETMPEWPT is free software : you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+ETMPEWPT is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Foobar.If not, see < https://www.gnu.org/licenses/>.
+
+Theory of this is published in two papers:
+1. E. Lambrou and L. N. Gergidis, A computational method for calculating the electrical and thermal properties of random composite ,
+Physica A: Statistical Mechanics and its Applications, Volume 642, 2024, 129760, ISSN 0378-4371,
+https://doi.org/10.1016/j.physa.2024.129760
+2. E. Lambrou and L. N. Gergidis, A particle digitization-based computational method for continuum percolation, Physica A: Statistical Mechanics
+and its Applications, vol. 590, p. 126738, 2022
+
+if you use this programm and write a paper or report please cite above papers
+
+*/
+
+#pragma once // Ensures this header file is included only once in a compilation unit.
+
+#include <stdio.h>   // FILE, fopen, fread, fwrite.
+#include <stdint.h>  // Fixed size fields of the file layout.
+#include <string.h>  // memcpy, strncpy.
+#include <string>
+#include <vector>
+
+// Checkpoint of a Monte Carlo run: the per case result arrays of the finished realizations of one
+// input, so an interrupted run continues at the next unfinished realization. The per case seeds are
+// part of the arrays; every case reseeds the random engine and draws its particles (or lattice
+// sites) from it alone, so they are the whole random state.
+//
+// Layout (little-endian): CheckpointHeader, then per array CheckpointBlock + data.
+// The file is written to a temporary name and renamed, so a checkpoint is either complete or absent.
+
+const char checkpointMagic[8] = { 'P', 'E', 'R', 'C', 'C', 'K', 'P', '1' };
+
+struct CheckpointHeader {
+	char magic[8];            // checkpointMagic
+	uint32_t version;         // 1
+	uint32_t blocks;          // Arrays in the file.
+	uint64_t fingerprint;     // Hash of the input (a checkpoint of another input is not used).
+	int32_t iterations;       // Realizations of the run.
+	int32_t completed;        // Finished realizations (0 .. completed - 1).
+	int32_t width, height;
+	int32_t pixelsPerMinimumSize;
+	int32_t totalComponents;
+};
+
+struct CheckpointBlock {
+	char name[24];            // Array name (zero terminated).
+	uint32_t elementBytes;    // Size of one element.
+	uint32_t reserved;
+	uint64_t count;           // Elements.
+};
+
+// Named arrays of a checkpoint, saved and loaded as a whole.
+class Checkpoint {
+	std::vector<CheckpointBlock> blocks;
+	std::vector<std::vector<unsigned char>> data;
+
+	int find(const char* name, size_t elementBytes) const;
+
+public:
+	CheckpointHeader header = {};
+
+	// Adds a copy of an array.
+	template <typename T> void add(const char* name, const std::vector<T>& values)
+	{
+		CheckpointBlock block = {};
+		strncpy(block.name, name, sizeof(block.name) - 1);
+		block.elementBytes = sizeof(T);
+		block.count = values.size();
+		blocks.push_back(block);
+		const unsigned char* bytes = (const unsigned char*)values.data();
+		data.emplace_back(bytes, bytes + values.size() * sizeof(T));
+	}
+
+	// Restores an array. With `fixedSize` the stored array must have values.size() elements,
+	// else values is resized to the stored array. Returns false if it is missing or does not fit.
+	template <typename T> bool get(const char* name, std::vector<T>& values, bool fixedSize = true) const
+	{
+		int k = find(name, sizeof(T));
+		if ((k < 0) || (fixedSize && (blocks[k].count != values.size())))
+			return false;
+		values.resize((size_t)blocks[k].count);
+		if (!values.empty())
+			memcpy(values.data(), data[k].data(), data[k].size());
+		return true;
+	}
+
+	// Total bytes of the arrays.
+	size_t bytes(void) const;
+
+	// Writes the checkpoint (temporary file, then renamed over fileName). Returns false on error.
+	bool save(const std::string& fileName) const;
+	// Reads a checkpoint. Returns false if the file is missing or is not a checkpoint.
+	bool load(const std::string& fileName);
+};
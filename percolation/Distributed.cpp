@@ -0,0 +1,240 @@
+/*
+This file is part of Electric,Thermal, Mechanical Properties
+Estimation With Percolation Theory (ETMPEWPT) (2D version) program.
+
+Created from Eleftherios Lamprou lef27064@otenet.gr during PhD thesis (2017-2024)
+
+ETMPEWPT is free software : you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+ETMPEWPT is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Foobar.If not, see < https://www.gnu.org/licenses/>.
+
+Theory of this is published in two papers:
+1. E. Lambrou and L. N. Gergidis, A computational method for calculating the electrical and thermal properties of random composite ,
+Physica A: Statistical Mechanics and its Applications, Volume 642, 2024, 129760, ISSN 0378-4371,
+https://doi.org/10.1016/j.physa.2024.129760
+2. E. Lambrou and L. N. Gergidis, A particle digitization-based computational method for continuum percolation, Physica A: Statistical Mechanics
+and its Applications, vol. 590, p. 126738, 2022
+
+if you use this programm and write a paper or report please cite above papers
+
+*/
+
+#include "Distributed.h"
+#include "Log.h"
+#include <cstring>
+
+Distributed distributed;
+
+#ifdef PERC_MPI
+// Sum of `count` values of every rank into rank 0.
+static void reduceToRoot(int rank, void* values, int count, MPI_Datatype type)
+{
+	if (count <= 0)
+		return;
+	MPI_Reduce((rank == 0) ? MPI_IN_PLACE : values, values, count, type, MPI_SUM, 0, MPI_COMM_WORLD);
+}
+#endif
+
+void Distributed::start(int* argc, char*** argv)
+{
+#ifdef PERC_MPI
+	int provided = 0;
+	MPI_Init_thread(argc, argv, MPI_THREAD_SERIALIZED, &provided);
+	MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+	MPI_Comm_size(MPI_COMM_WORLD, &size);
+	if (provided < MPI_THREAD_SERIALIZED)
+		LOG_WARNING("MPI without MPI_THREAD_SERIALIZED: run the input files one at a time (settings concurrentJobs 1)\n");
+
+	// Ranks of this node: its cores are shared between them
+	MPI_Comm node;
+	MPI_Comm_split_type(MPI_COMM_WORLD, MPI_COMM_TYPE_SHARED, rank, MPI_INFO_NULL, &node);
+	MPI_Comm_size(node, &localRanks);
+	MPI_Comm_free(&node);
+
+	// The shared counter, accessed with atomic operations for the whole run (passive target)
+	MPI_Win_allocate((rank == 0) ? sizeof(int64_t) : 0, sizeof(int64_t), MPI_INFO_NULL, MPI_COMM_WORLD, &counter, &window);
+	if (rank == 0)
+		*counter = 0;
+	MPI_Barrier(MPI_COMM_WORLD);
+	MPI_Win_lock_all(0, window);
+#else
+	(void)argc;
+	(void)argv;
+#endif
+}
+
+void Distributed::stop(void)
+{
+#ifdef PERC_MPI
+	MPI_Win_unlock_all(window);
+	MPI_Win_free(&window);
+	MPI_Finalize();
+#endif
+}
+
+void Distributed::resetCounter(int64_t first)
+{
+	std::lock_guard<std::mutex> guard(lock);
+#ifdef PERC_MPI
+	// No rank takes from the old count after the first barrier or from the new one before the second
+	MPI_Barrier(MPI_COMM_WORLD);
+	if (rank == 0)
+	{
+		int64_t old;
+		MPI_Fetch_and_op(&first, &old, MPI_INT64_T, 0, 0, MPI_REPLACE, window);
+		MPI_Win_flush(0, window);
+	}
+	MPI_Barrier(MPI_COMM_WORLD);
+#else
+	counter = first;
+#endif
+}
+
+int64_t Distributed::next(void)
+{
+	std::lock_guard<std::mutex> guard(lock);
+#ifdef PERC_MPI
+	const int64_t one = 1;
+	int64_t value;
+	MPI_Fetch_and_op(&one, &value, MPI_INT64_T, 0, 0, MPI_SUM, window);
+	MPI_Win_flush(0, window);
+	return value;
+#else
+	return counter++;
+#endif
+}
+
+void Distributed::sumToRoot(std::vector<double>& values)
+{
+#ifdef PERC_MPI
+	std::lock_guard<std::mutex> guard(lock);
+	reduceToRoot(rank, values.data(), (int)values.size(), MPI_DOUBLE);
+#else
+	(void)values;
+#endif
+}
+
+void Distributed::sumToRoot(std::vector<float>& values)
+{
+#ifdef PERC_MPI
+	std::lock_guard<std::mutex> guard(lock);
+	reduceToRoot(rank, values.data(), (int)values.size(), MPI_FLOAT);
+#else
+	(void)values;
+#endif
+}
+
+void Distributed::sumToRoot(std::vector<int>& values)
+{
+#ifdef PERC_MPI
+	std::lock_guard<std::mutex> guard(lock);
+	reduceToRoot(rank, values.data(), (int)values.size(), MPI_INT);
+#else
+	(void)values;
+#endif
+}
+
+void Distributed::sumToRoot(std::vector<int64_t>& values)
+{
+#ifdef PERC_MPI
+	std::lock_guard<std::mutex> guard(lock);
+	reduceToRoot(rank, values.data(), (int)values.size(), MPI_INT64_T);
+#else
+	(void)values;
+#endif
+}
+
+void Distributed::sumToRoot(std::vector<uint64_t>& values)
+{
+#ifdef PERC_MPI
+	std::lock_guard<std::mutex> guard(lock);
+	reduceToRoot(rank, values.data(), (int)values.size(), MPI_UINT64_T);
+#else
+	(void)values;
+#endif
+}
+
+void Distributed::sumToRoot(std::vector<PhaseTimes>& values)
+{
+#ifdef PERC_MPI
+	// Wall and CPU times, then the calls (exact as doubles)
+	std::vector<double> packed(3 * TIMER_PHASES * values.size());
+	size_t k = 0;
+	for (const PhaseTimes& times : values)
+		for (int p = 0; p < TIMER_PHASES; p++)
+		{
+			packed[k++] = times.wall[p];
+			packed[k++] = times.cpu[p];
+			packed[k++] = times.calls[p];
+		}
+	sumToRoot(packed);
+	k = 0;
+	for (PhaseTimes& times : values)
+		for (int p = 0; p < TIMER_PHASES; p++)
+		{
+			times.wall[p] = packed[k++];
+			times.cpu[p] = packed[k++];
+			times.calls[p] = (uint32_t)packed[k++];
+		}
+#else
+	(void)values;
+#endif
+}
+
+void Distributed::fromRoot(int64_t& value)
+{
+#ifdef PERC_MPI
+	std::lock_guard<std::mutex> guard(lock);
+	MPI_Bcast(&value, 1, MPI_INT64_T, 0, MPI_COMM_WORLD);
+#else
+	(void)value;
+#endif
+}
+
+void Distributed::gatherRows(std::vector<std::pair<int, std::string>>& rows)
+{
+#ifdef PERC_MPI
+	std::lock_guard<std::mutex> guard(lock);
+	// Rows of this rank as index, length, text
+	std::vector<char> bytes;
+	if (rank != 0)
+		for (const auto& row : rows)
+		{
+			int head[2] = { row.first, (int)row.second.size() };
+			bytes.insert(bytes.end(), (const char*)head, (const char*)head + sizeof(head));
+			bytes.insert(bytes.end(), row.second.begin(), row.second.end());
+		}
+
+	int count = (int)bytes.size();
+	std::vector<int> counts(size), offsets(size);
+	MPI_Gather(&count, 1, MPI_INT, counts.data(), 1, MPI_INT, 0, MPI_COMM_WORLD);
+	int total = 0;
+	for (int r = 0; r < size; r++)
+	{
+		offsets[r] = total;
+		total += counts[r];
+	}
+	std::vector<char> all((rank == 0) ? total : 0);
+	MPI_Gatherv(bytes.data(), count, MPI_CHAR, all.data(), counts.data(), offsets.data(), MPI_CHAR, 0, MPI_COMM_WORLD);
+
+	for (size_t k = 0; k + 2 * sizeof(int) <= all.size();)
+	{
+		int head[2];
+		memcpy(head, &all[k], sizeof(head));
+		k += sizeof(head);
+		rows.emplace_back(head[0], std::string(&all[k], head[1]));
+		k += head[1];
+	}
+#else
+	(void)rows;
+#endif
+}
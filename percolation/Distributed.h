@@ -0,0 +1,101 @@
+/*
+This file is part of Electric,Thermal, Mechanical Properties
+Estimation With Percolation Theory (ETMPEWPT) (2D version) program.
+
+Created from Eleftherios Lamprou lef27064@otenet.gr during PhD thesis (2017-2024)
+
+ETMPEWPT is free software : you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+ETMPEWPT is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Foobar.If not, see < https://www.gnu.org/licenses/>.
+
+Theory of this is published in two papers:
+1. E. Lambrou and L. N. Gergidis, A computational method for calculating the electrical and thermal properties of random composite ,
+Physica A: Statistical Mechanics and its Applications, Volume 642, 2024, 129760, ISSN 0378-4371,
+https://doi.org/10.1016/j.physa.2024.129760
+2. E. Lambrou and L. N. Gergidis, A particle digitization-based computational method for continuum percolation, Physica A: Statistical Mechanics
+and its Applications, vol. 590, p. 126738, 2022
+
+if you use this programm and write a paper or report please cite above papers
+
+*/
+
+#pragma once // Ensures this header file is included only once in a compilation unit.
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <mutex>
+#include "general.h"    // DistributeMode.
+#include "PhaseTimer.h" // PhaseTimes of the per case results.
+#ifdef PERC_MPI
+#include <mpi.h>
+#endif
+
+// Runs of one batch over the processes (ranks) of an MPI job, e.g. `mpirun -np 4 Perc2d` on one box
+// or across the nodes of a cluster. Built with -DPERC_MPI (and the MPI compiler wrapper); without it
+// the program is a single rank and every call below is a no-op.
+//
+// Realizations (settings distribute REALIZATIONS): all ranks run every input file together. The
+// next case of an input is taken from a shared counter on rank 0 (an MPI atomic fetch and add,
+// so faster ranks simply take more cases), and at the end of the input the per case results of
+// all ranks are summed into rank 0 (every case is run by exactly one rank, the others hold zeros).
+// Rank 0 then has the results of a serial run and writes the reports.
+//
+// Inputs (settings distribute INPUTS): every rank takes whole input files from the shared counter
+// and writes the project's own reports; the rows of the batch reports are sent to rank 0.
+class Distributed {
+	std::mutex lock;    // MPI calls of concurrent runs are serialized (MPI_THREAD_SERIALIZED)
+#ifdef PERC_MPI
+	MPI_Win window;     // Window of the shared counter (its memory is on rank 0)
+	int64_t* counter = NULL;
+#else
+	int64_t counter = 0; // The counter of a single rank
+#endif
+
+public:
+	int rank = 0;       // This process
+	int size = 1;       // Processes of the job
+	int localRanks = 1; // Processes of the job on this node (they share its cores)
+	DistributeMode mode = DISTRIBUTE_REALIZATIONS;
+
+	// Starts MPI (if built with it) and finds the rank of this process.
+	void start(int* argc, char*** argv);
+	// Ends MPI, after all ranks have finished.
+	void stop(void);
+
+	// Ranks share the realizations of every input.
+	bool sharesRealizations(void) const { return (size > 1) && (mode == DISTRIBUTE_REALIZATIONS); }
+	// Ranks share the input files of the batch.
+	bool sharesInputs(void) const { return (size > 1) && (mode == DISTRIBUTE_INPUTS); }
+
+	// Sets the shared counter to `first` (collective: every rank calls it before taking from it).
+	void resetCounter(int64_t first);
+	// Takes the next value of the shared counter.
+	int64_t next(void);
+
+	// Sums the vector of every rank into the one of rank 0 (collective, the sizes must match).
+	void sumToRoot(std::vector<double>& values);
+	void sumToRoot(std::vector<float>& values);
+	void sumToRoot(std::vector<int>& values);
+	void sumToRoot(std::vector<int64_t>& values);
+	void sumToRoot(std::vector<uint64_t>& values);
+	void sumToRoot(std::vector<PhaseTimes>& values);
+
+	// Sets the value of every rank to the one of rank 0 (collective).
+	void fromRoot(int64_t& value);
+
+	// Gathers the (index, text) rows of all ranks at rank 0, appended to its own rows (collective).
+	void gatherRows(std::vector<std::pair<int, std::string>>& rows);
+};
+
+// The processes of the program.
+extern Distributed distributed;
@@ -32,6 +32,21 @@ if you use this programm and write a paper or report please cite above papers
 #include "FD2DEL.h" // Include the header file for the FD2DEL class
 #include <cstring>  // Required for memset
 #include <cmath>    // Required for sqrt
+#include <charconv> // std::from_chars, locale free parsing of phase maps
+#include <stdint.h> // Fixed size fields of BMP headers
+#include <optional> // Scope of the bond phase timer
+#include <omp.h>    // Threads of the strip solver
+#include "PhaseTimer.h" // FDM bond and CG phases of the realization
+#include "ProgressStatus.h" // CG convergence of the running realization for the status file
+#include "Log.h"        // Console output by level
+
+#if defined(__unix__) || defined(__APPLE__)
+#define FD2DEL_HAS_MMAP // Phase maps are memory mapped (POSIX)
+#include <sys/mman.h> // For `mmap`, `munmap`, `madvise`.
+#include <sys/stat.h> // For `fstat`, `struct stat`.
+#include <fcntl.h>    // For `open`.
+#include <unistd.h>   // For `pread`, `close`.
+#endif
 
 // Function to calculate the volume-averaged current
 void FD2DEL::current(double* icurrx, double* icurry, double* iu, double* igx, double* igy)
@@ -67,6 +82,27 @@ void FD2DEL::current(double* icurrx, double* icurry, double* iu, double* igx, do
     return; // Function returns
 }
 
+// current() with the exact conductances of the phases (the MIXED_SOLVER keeps gx, gy in single precision)
+void FD2DEL::phaseCurrent(double* icurrx, double* icurry, double* iu)
+{
+    const double* bondsX = phaseBonds.data();
+    const double* bondsY = bondsX + (size_t)bondPhases * bondPhases;
+    double sumx = 0.0, sumy = 0.0;
+    for (int j = 1; j <= ny; j++)
+    {
+        for (int i = 1; i <= nx; i++)
+        {
+            int m = nx2 * j + i;
+            double left = bondsX[pix[m - 1] * bondPhases + pix[m]], right = bondsX[pix[m] * bondPhases + pix[m + 1]];
+            double up = bondsY[pix[m - nx2] * bondPhases + pix[m]], down = bondsY[pix[m] * bondPhases + pix[m + nx2]];
+            sumx += 0.5 * ((iu[m - 1] - iu[m]) * left + (iu[m] - iu[m + 1]) * right);
+            sumy += 0.5 * ((iu[m - nx2] - iu[m]) * up + (iu[m] - iu[m + nx2]) * down);
+        }
+    }
+    *icurrx = sumx / double(nx * ny);
+    *icurry = sumy / double(nx * ny);
+}
+
 // Function to process pixel phase labels and map periodic boundaries
 void FD2DEL::ppixel(int* ipix, double* ia, int nphase, int ntot)
 {
@@ -109,20 +145,27 @@ void FD2DEL::ppixel(int* ipix, double* ia, int nphase, int ntot)
             }
         }
 
-    // Check for wrong phase labels (less than 0 or greater than nphase - 1)
+    // Check for wrong phase labels (less than 0 or greater than nphase - 1), reported once with the first one
+    int wrongLabels = 0;
+    int firstWrong = -1;
     for (int im = 0; im < ns2 - 1; im++)
     {
-        if (ipix[im] < 0)
-            std::cout << "Phase label in pix < 0--error at " << im << "\n";
-
-        if (ipix[im] > nphase - 1)
-            std::cout << "Phase label in pix > nphase--error at " << im << "\n";
+        if ((ipix[im] < 0) || (ipix[im] > nphase - 1))
+        {
+            if (wrongLabels == 0)
+                firstWrong = im;
+            wrongLabels++;
+        }
     }
+    if (wrongLabels > 0)
+        LOG_ERROR(wrongLabels << " phase labels in pix out of 0.." << nphase - 1 << ", first at " << firstWrong << " (" << ipix[firstWrong] << ")\n");
 }
 
 // Subroutine that determines the correct bond conductances used for matrix A
-void FD2DEL::bond(int* ipix, double* igx, double* igy, Matrix2D<double>* isigma, Matrix3D<double>* ibe, int nphase, int ntot)
+template <typename T>
+void FD2DEL::bond(int* ipix, T* igx, T* igy, Matrix2D<double>* isigma, Matrix3D<double>* ibe, int nphase, int ntot)
 {
+    (void)ntot; // Array dimension of the Fortran original, the phases are bounded by nphase
     // Auxiliary variables involving the system size
     int j1;
     int i1;
@@ -182,21 +225,30 @@ void FD2DEL::bond(int* ipix, double* igx, double* igy, Matrix2D<double>* isigma,
             igx[m - 1] = ibe->at(ipix[m - 1], ipix[m1 - 1], 0);
         }
     }
+
+    // Exact conductances of the phase pairs, looked up by the MIXED_SOLVER
+    bondPhases = nphase;
+    phaseBonds.resize(2 * (size_t)nphase * nphase);
+    for (m = 0; m < 2; ++m)
+        for (i = 0; i < nphase; ++i)
+            for (j = 0; j < nphase; ++j)
+                phaseBonds[((size_t)m * nphase + i) * nphase + j] = ibe->at(i, j, m);
     return; // Function returns
 }
 
 // Function to perform matrix-vector product (A * xw)
-void FD2DEL::prod(double* igx, double* igy, double* xw, double* yw)
+template <typename T>
+void FD2DEL::prod(T* igx, T* igy, T* xw, T* yw)
 {
     // xw is the input vector (e.g., voltage), yw = (A)(xw) is the output vector (e.g., negative divergence of current)
 
-    int i, j;
+    int i;
     // Initialize yw to zero
     std::fill_n(yw, ns2, 0);
 
     // Perform basic matrix multiplication for interior points, neglecting periodic boundaries for now.
-    // This calculates the divergence of current at each node.
-    for (i = nx2 + 1; i <= ns2 - nx2; ++i)
+    // This calculates the divergence of current at each node (rows 1..ny2-2, 0-based arrays).
+    for (i = nx2; i < ns2 - nx2; ++i)
     {
         // This is effectively - (sum of conductances connected to node i) * xw[i]
         yw[i] = -xw[i] * (igx[i - 1] + igx[i] + igy[i] + igy[i - nx2]);
@@ -205,6 +257,15 @@ void FD2DEL::prod(double* igx, double* igy, double* xw, double* yw)
     }
 
     // Correct terms at periodic boundaries (refer to Section 3.3 in manual)
+    copyFaces(yw);
+    return; // Function returns
+}
+
+// Copies the real sites next to the periodic boundaries to the faces of a product
+template <typename T>
+void FD2DEL::copyFaces(T* yw)
+{
+    int i, j;
 
     // x faces (left and right boundaries)
     for (j = 1; j <= ny2; ++j)
@@ -233,11 +294,29 @@ void FD2DEL::dembx(double* igx, double* igy, double* iu, int* ic, double* iigb,
     // relaxation algorithm, the voltage vector is only modified by adding a
     // periodic vector to it.
 
+    // Traffic and work of a CG cycle per section, every array read or written once (8 byte values,
+    // 4 byte site list): prod clears Ah, reads gx, gy, h and writes Ah (5 x 8 bytes, 12 flops per site);
+    // the dot products gg and hAh read the list and gb, h, Ah (2 x 4 + 3 x 8 bytes, 4 flops per real
+    // site); the updates read gb, h and write h, then read u, h, gb, Ah and write u, gb (9 x 8 bytes,
+    // 6 flops per site).
+    if (profile != NULL)
+    {
+        profile->modelBytes[CG_PROD_SECTION] = 40.0 * ns2;
+        profile->modelFlops[CG_PROD_SECTION] = 12.0 * ns2;
+        profile->modelBytes[CG_DOT_SECTION] = 32.0 * nlist;
+        profile->modelFlops[CG_DOT_SECTION] = 4.0 * nlist;
+        profile->modelBytes[CG_UPDATE_SECTION] = 72.0 * ns2;
+        profile->modelFlops[CG_UPDATE_SECTION] = 6.0 * ns2;
+    }
+
     // First stage: compute initial value of gradient (iigb), initialize h (conjugate gradient direction),
     // and compute norm squared of gradient vector (gg).
 
     // Calculate initial gradient (iigb) as A * iu
-    prod(igx, igy, iu, iigb);
+    {
+        CgSectionTimer section(profile, CG_PROD_SECTION);
+        prod(igx, igy, iu, iigb);
+    }
     // Initialize conjugate gradient direction 'h' with the gradient
     for (int i = 0; i < ns2; ++i)
         h[i] = iigb[i];
@@ -245,10 +324,13 @@ void FD2DEL::dembx(double* igx, double* igy, double* iu, int* ic, double* iigb,
     // Variable gg is the norm squared of the gradient vector
     gg = 0.0;
     // Sum squares of gradient components only for real (interior) sites
-    for (int k = 0; k < nlist; ++k)
     {
-        int m = list[k];
-        gg = (iigb[m - 1] * iigb[m - 1]) + gg;
+        CgSectionTimer section(profile, CG_DOT_SECTION);
+        for (int k = 0; k < nlist; ++k)
+        {
+            int m = list[k];
+            gg = (iigb[m - 1] * iigb[m - 1]) + gg;
+        }
     }
 
     hAh = 0; // Initialize hAh for the first step
@@ -256,24 +338,36 @@ void FD2DEL::dembx(double* igx, double* igy, double* iu, int* ic, double* iigb,
     // Second stage: initialize Ah variable, compute parameter lambda,
     // make first change in voltage array, update gradient (iigb) vector.
     int icc = 0; // Conjugate gradient iteration counter
+    LogRate progress(5.0); // Progress of long solves, every 5 seconds at most
     if (gg > gtest) // Proceed if the initial gradient norm is above the tolerance
     {
+        cgProgressStart(gg, gtest); // Convergence of the solve, seen by the status file
+
         // Calculate A * h
-        prod(igx, igy, h, Ah);
+        {
+            CgSectionTimer section(profile, CG_PROD_SECTION);
+            prod(igx, igy, h, Ah);
+        }
 
         // Compute hAh (h dot Ah) for real sites
-        for (int k = 1; k <= nlist; ++k)
         {
-            int m = list[k - 1];
-            hAh = hAh + (h[m - 1] * Ah[m - 1]);
+            CgSectionTimer section(profile, CG_DOT_SECTION);
+            for (int k = 1; k <= nlist; ++k)
+            {
+                int m = list[k - 1];
+                hAh = hAh + (h[m - 1] * Ah[m - 1]);
+            }
         }
         // Calculate lambda (step size)
         lambda = gg / hAh;
         // Update voltage and gradient vectors
-        for (int i = 0; i < ns2; ++i)
         {
-            iu[i] = iu[i] - lambda * h[i];    // Update voltage
-            iigb[i] = iigb[i] - lambda * Ah[i]; // Update gradient
+            CgSectionTimer section(profile, CG_UPDATE_SECTION);
+            for (int i = 0; i < ns2; ++i)
+            {
+                iu[i] = iu[i] - lambda * h[i];    // Update voltage
+                iigb[i] = iigb[i] - lambda * Ah[i]; // Update gradient
+            }
         }
 
         // Third stage: iterate conjugate gradient solution process until
@@ -291,71 +385,429 @@ void FD2DEL::dembx(double* igx, double* igy, double* iu, int* ic, double* iigb,
             gg = 0.0;    // Reset current gradient norm squared
 
             // Recalculate current gradient norm squared for real sites
-            for (int k = 0; k < nlist; ++k)
             {
-                int m = list[k];
-                gg = (iigb[m - 1] * iigb[m - 1]) + gg;
+                CgSectionTimer section(profile, CG_DOT_SECTION);
+                for (int k = 0; k < nlist; ++k)
+                {
+                    int m = list[k];
+                    gg = (iigb[m - 1] * iigb[m - 1]) + gg;
+                }
             }
 
+            cgProgress(icc, gg);
+
             // Calculate gamma (Fletcher-Reeves or Polak-Ribiere parameter)
             gamma = gg / gglast;
 
             // Update conjugate gradient direction
-            for (int i = 0; i < ns2; ++i)
             {
-                h[i] = iigb[i] + gamma * h[i];
+                CgSectionTimer section(profile, CG_UPDATE_SECTION);
+                for (int i = 0; i < ns2; ++i)
+                {
+                    h[i] = iigb[i] + gamma * h[i];
+                }
             }
 
             // Calculate A * h for the updated direction
-            prod(igx, igy, h, Ah);
+            {
+                CgSectionTimer section(profile, CG_PROD_SECTION);
+                prod(igx, igy, h, Ah);
+            }
             hAh = 0.0; // Reset hAh
 
             // Compute hAh (h dot Ah) for real sites
-            for (int k = 0; k < nlist; ++k)
             {
-                int m = list[k];
-                hAh = hAh + h[m - 1] * Ah[m - 1];
+                CgSectionTimer section(profile, CG_DOT_SECTION);
+                for (int k = 0; k < nlist; ++k)
+                {
+                    int m = list[k];
+                    hAh = hAh + h[m - 1] * Ah[m - 1];
+                }
             }
 
             // Calculate lambda (step size)
             lambda = gg / hAh;
 
             // Update voltage and gradient vectors
-            for (int i = 0; i < ns2; ++i)
             {
-                iu[i] = iu[i] - (lambda * h[i]);    // Update voltage
-                iigb[i] = iigb[i] - (lambda * Ah[i]); // Update gradient
+                CgSectionTimer section(profile, CG_UPDATE_SECTION);
+                for (int i = 0; i < ns2; ++i)
+                {
+                    iu[i] = iu[i] - (lambda * h[i]);    // Update voltage
+                    iigb[i] = iigb[i] - (lambda * Ah[i]); // Update gradient
+                }
             }
 
             // (USER) This piece of code forces dembx to write out the total current and
-            // the norm of the gradient squared, every ncheck conjugate gradient steps,
+            // the norm of the gradient squared, every few seconds at the detail level,
             // in order to see how the relaxation is proceeding. If the currents become
             // unchanging before the relaxation is done, then gtest was picked to be
-            // smaller than was necessary.
-
-            int ncheck = 5000; // Check frequency
-
-            if ((icc % ncheck) == 0) // If current iteration is a multiple of ncheck
+            // smaller than was necessary. The currents cost a pass over the grid, so
+            // the clock is read and they are computed only when the level is enabled.
+            if (logEnabled(DETAIL_LOG) && progress.ready())
             {
-                std::cout << icc;                 // Print current iteration
-                std::cout << " gg = " << gg << "\n"; // Print norm squared of gradient
-                // Call current subroutine to calculate and print average currents
                 current(&currx, &curry, iu, igx, igy);
-                std::cout << " currx = " << currx << "\n";
-                std::cout << " curry = " << curry << "\n";
-                std::cout << "number of conjugate gradient cycles needed = " << icc << "\n";
+                LOG_DETAIL(icc << " gg = " << gg << " currx = " << currx << " curry = " << curry << "\n");
             }
         }
         // If the loop finishes because icc reached ncgsteps, it means iteration failed to converge
         if (icc == ncgsteps) {
-            std::cout << " iteration failed to converge after" << ncgsteps << " steps";
+            LOG_WARNING("iteration failed to converge after " << ncgsteps << " steps\n");
         }
+        cgProgressEnd();
     }
 
     *ic = icc; // Store the total number of iterations
     return;    // Function returns
 }
 
+// Domain-decomposed version of dembx: the grid is split in row strips, one per thread (stripRows),
+// and every thread runs the CG cycle on its strip. The stencil of a strip reads the edge rows of
+// its neighbours (the halo) after a barrier, and the periodic halo rows are copied by the strips
+// that own them. The CG is preconditioned by block-Jacobi over the strips: each strip applies
+// one symmetric Gauss-Seidel sweep on its own sites, without the couplings to other strips, so
+// the strips never wait for each other inside the preconditioner. The diagonal scaling of the
+// sweep also evens out the conductance contrast of the phases. The solve stops on the same test
+// as dembx (squared norm of the unpreconditioned gradient below gtest).
+void FD2DEL::dembxStrips(double* igx, double* igy, double* iu, int* ic, double* iigb, double* h, double* Ah, double gtest)
+{
+    int strips = stripCount(); // Strips asked for, set to the threads of the team in the region
+    double* z = new double[ns2];    // Preconditioned gradient
+    double* dinv = new double[ns2]; // Inverse diagonal of A (0 at sites without bonds)
+    // Partial sums of the strips, a cache line apart: hAh, then gg and gb.z
+    const int stride = 8;
+    std::vector<double> partial(3 * stride * strips, 0.0);
+    int icc = 0;
+
+    // Squared gradient norm, reported by the first strip at most every 5 seconds
+    LogRate progress(5.0);
+
+#pragma omp parallel num_threads(strips)
+    {
+        // The team may be smaller than asked (OMP_THREAD_LIMIT, OMP_DYNAMIC, nested regions):
+        // the grid is split among the threads it really has, or whole strips are never updated
+#pragma omp single
+        strips = omp_get_num_threads();
+        int s = omp_get_thread_num();
+        int first, last;
+        stripRows(s, strips, &first, &last);
+        int realFirst = std::max(first, 1), realLast = std::min(last, ny + 1); // Real rows of the strip
+        size_t begin = (size_t)first * nx2, end = (size_t)last * nx2;          // Sites of the strip (with halo rows)
+
+        // yw = A xw on the real rows of the strip, x faces copied (see prod)
+        auto prodRows = [&](const double* xw, double* yw) {
+            for (size_t i = (size_t)realFirst * nx2; i < (size_t)realLast * nx2; ++i)
+                yw[i] = -xw[i] * (igx[i - 1] + igx[i] + igy[i] + igy[i - nx2])
+                    + igx[i - 1] * xw[i - 1] + igx[i] * xw[i + 1] + igy[i] * xw[i + nx2] + igy[i - nx2] * xw[i - nx2];
+            for (int j = realFirst; j < realLast; ++j)
+            {
+                yw[(size_t)nx2 * j + nx2 - 1] = yw[(size_t)nx2 * j + 1];
+                yw[(size_t)nx2 * j] = yw[(size_t)nx2 * j + nx1 - 1];
+            }
+        };
+        // y faces of the halo rows owned by the strip (after a barrier: they copy other strips' rows)
+        auto periodicRows = [&](double* yw) {
+            if (first == 0)
+                std::copy(yw + (size_t)ny * nx2, yw + (size_t)ny1 * nx2, yw);
+            if (last == ny2)
+                std::copy(yw + nx2, yw + 2 * (size_t)nx2, yw + (size_t)ny1 * nx2);
+        };
+        // z = M^-1 iigb on the real sites of the strip, x faces copied. M is minus the symmetric
+        // Gauss-Seidel matrix (D + L) D^-1 (D + U) of the strip (A is negative definite).
+        auto precondition = [&]() {
+            for (int j = realFirst; j < realLast; ++j)
+                for (int c = 1; c <= nx; ++c)
+                {
+                    size_t i = (size_t)nx2 * j + c;
+                    double v = -iigb[i];
+                    if (c > 1)
+                        v += igx[i - 1] * z[i - 1];
+                    if (j > realFirst)
+                        v += igy[i - nx2] * z[i - nx2];
+                    z[i] = v * dinv[i];
+                }
+            for (int j = realLast - 1; j >= realFirst; --j)
+                for (int c = nx; c >= 1; --c)
+                {
+                    size_t i = (size_t)nx2 * j + c;
+                    double v = 0.0;
+                    if (c < nx)
+                        v += igx[i] * z[i + 1];
+                    if (j < realLast - 1)
+                        v += igy[i] * z[i + nx2];
+                    z[i] += v * dinv[i];
+                }
+            for (int j = realFirst; j < realLast; ++j)
+            {
+                z[(size_t)nx2 * j + nx2 - 1] = z[(size_t)nx2 * j + 1];
+                z[(size_t)nx2 * j] = z[(size_t)nx2 * j + nx1 - 1];
+            }
+        };
+        // Sum of the partial sums of all strips, in strip order (the same on every thread)
+        auto total = [&](int slot) {
+            double sum = 0.0;
+            for (int t = 0; t < strips; ++t)
+                sum += partial[(size_t)(slot * strips + t) * stride];
+            return sum;
+        };
+        // Partial sums of gg (slot 1) and gb.z (slot 2) over the real sites of the strip
+        auto residualSums = [&]() {
+            double sgg = 0.0, srho = 0.0;
+            for (int j = realFirst; j < realLast; ++j)
+                for (size_t i = (size_t)nx2 * j + 1; i <= (size_t)nx2 * j + nx; ++i)
+                {
+                    sgg += iigb[i] * iigb[i];
+                    srho += iigb[i] * z[i];
+                }
+            partial[(size_t)(strips + s) * stride] = sgg;
+            partial[(size_t)(2 * strips + s) * stride] = srho;
+        };
+
+        // First touch of the work arrays by their strip, and the inverse diagonal
+        std::fill_n(z + begin, end - begin, 0.0);
+        std::fill_n(dinv + begin, end - begin, 0.0);
+        for (size_t i = std::max(begin, (size_t)nx2); i < std::min(end, (size_t)ny1 * nx2); ++i)
+        {
+            double d = igx[i - 1] + igx[i] + igy[i] + igy[i - nx2];
+            dinv[i] = (d > 0.0) ? 1.0 / d : 0.0;
+        }
+
+        // First stage: gradient iigb = A iu, its preconditioned form z and h = z
+        prodRows(iu, iigb);
+#pragma omp barrier
+        periodicRows(iigb);
+        precondition();
+#pragma omp barrier
+        periodicRows(z);
+        residualSums();
+        std::copy(z + begin, z + end, h + begin);
+#pragma omp barrier
+        double gg = total(1), rho = total(2);
+        if (s == 0)
+            cgProgressStart(gg, gtest);
+
+        int it = 0;
+        for (; (it < ncgsteps) && (gg > gtest); ++it)
+        {
+            // Ah = A h and lambda = rho / hAh
+            prodRows(h, Ah);
+#pragma omp barrier
+            periodicRows(Ah);
+            double shAh = 0.0;
+            for (int j = realFirst; j < realLast; ++j)
+                for (size_t i = (size_t)nx2 * j + 1; i <= (size_t)nx2 * j + nx; ++i)
+                    shAh += h[i] * Ah[i];
+            partial[(size_t)s * stride] = shAh;
+#pragma omp barrier
+            double lambda = rho / total(0);
+
+            // Update voltage and gradient, precondition the new gradient
+            for (size_t i = begin; i < end; ++i)
+            {
+                iu[i] -= lambda * h[i];
+                iigb[i] -= lambda * Ah[i];
+            }
+            precondition();
+#pragma omp barrier
+            periodicRows(z);
+            residualSums();
+#pragma omp barrier
+            gg = total(1);
+            double rhoNew = total(2);
+            double gamma = rhoNew / rho;
+            rho = rhoNew;
+
+            // New direction (the next product reads the halo rows of the other strips)
+            for (size_t i = begin; i < end; ++i)
+                h[i] = z[i] + gamma * h[i];
+#pragma omp barrier
+            if (s == 0)
+            {
+                cgProgress(it + 1, gg);
+                LOG_EVERY(DETAIL_LOG, progress, it + 1 << " gg = " << gg << " (" << strips << " strips)\n");
+            }
+        }
+        if (s == 0)
+            icc = it;
+    }
+    if (icc == ncgsteps)
+        LOG_WARNING("iteration failed to converge after " << ncgsteps << " steps\n");
+    cgProgressEnd();
+
+    delete[] z;
+    delete[] dinv;
+    *ic = icc;
+}
+
+// CG of dembx preconditioned by algebraic multigrid (AmgSolver): the hierarchy is built once from
+// the bonds and every cycle applies one V-cycle to the gradient. Aggregation by conductance-aware
+// strength keeps the phases apart on the coarse levels, so the cycles needed depend little on
+// the grid size or on the contrast of the conductivities (which stalls the plain CG near the
+// percolation threshold). Same stopping test as dembx.
+void FD2DEL::dembxAmg(double* igx, double* igy, double* iu, int* ic, double* iigb, double* h, double* Ah, double gtest)
+{
+    amg.setup(igx, igy, nx, ny);
+    LOG_DETAIL("AMG: " << amg.levelCount() << " levels, operator complexity " << amg.operatorComplexity() << "\n");
+
+    int n = nx * ny;
+    std::vector<double> z(ns2, 0.0);     // Preconditioned gradient (padded, periodic)
+    std::vector<double> rc(n), zc(n);    // Gradient and its correction on the real sites
+    int icc = 0;
+    LogRate progress(5.0); // Progress of long solves, every 5 seconds at most
+
+    // z = M^-1 iigb: M^-1 is minus a V-cycle of -A (A is negative semidefinite), faces copied as in prod
+    auto precondition = [&]() {
+        for (int j = 1; j <= ny; ++j)
+            for (int c = 1; c <= nx; ++c)
+                rc[(size_t)(j - 1) * nx + c - 1] = -iigb[(size_t)nx2 * j + c];
+        amg.vcycle(rc.data(), zc.data());
+        for (int j = 1; j <= ny; ++j)
+        {
+            for (int c = 1; c <= nx; ++c)
+                z[(size_t)nx2 * j + c] = -zc[(size_t)(j - 1) * nx + c - 1];
+            z[(size_t)nx2 * j + nx2 - 1] = z[(size_t)nx2 * j + 1];
+            z[(size_t)nx2 * j] = z[(size_t)nx2 * j + nx1 - 1];
+        }
+        std::copy(z.begin() + (size_t)ny * nx2, z.begin() + (size_t)ny1 * nx2, z.begin());
+        std::copy(z.begin() + nx2, z.begin() + 2 * (size_t)nx2, z.begin() + (size_t)ny1 * nx2);
+    };
+    // Dot product over the real sites
+    auto dot = [&](const double* x, const double* y) {
+        double sum = 0.0;
+        for (int j = 1; j <= ny; ++j)
+            for (size_t i = (size_t)nx2 * j + 1; i <= (size_t)nx2 * j + nx; ++i)
+                sum += x[i] * y[i];
+        return sum;
+    };
+
+    // First stage: gradient iigb = A iu, its preconditioned form z and h = z
+    prod(igx, igy, iu, iigb);
+    double gg = dot(iigb, iigb);
+    if (gg > gtest)
+    {
+        cgProgressStart(gg, gtest);
+        precondition();
+        std::copy(z.begin(), z.end(), h);
+        double rho = dot(iigb, z.data());
+
+        for (; (icc < ncgsteps) && (gg > gtest); ++icc)
+        {
+            // Ah = A h and lambda = rho / hAh, update voltage and gradient
+            prod(igx, igy, h, Ah);
+            double lambda = rho / dot(h, Ah);
+            for (int i = 0; i < ns2; ++i)
+            {
+                iu[i] -= lambda * h[i];
+                iigb[i] -= lambda * Ah[i];
+            }
+            gg = dot(iigb, iigb);
+
+            // New direction from the preconditioned gradient
+            precondition();
+            double rhoNew = dot(iigb, z.data());
+            double gamma = rhoNew / rho;
+            rho = rhoNew;
+            for (int i = 0; i < ns2; ++i)
+                h[i] = z[i] + gamma * h[i];
+
+            cgProgress(icc + 1, gg);
+            LOG_EVERY(DETAIL_LOG, progress, icc + 1 << " gg = " << gg << " (AMG)\n");
+        }
+        if (icc == ncgsteps)
+            LOG_WARNING("iteration failed to converge after " << ncgsteps << " steps\n");
+        cgProgressEnd();
+    }
+    *ic = icc;
+}
+
+// dembx on single precision arrays (fgx, fgy, fgb, fh, fah): the CG cycle is bound by memory
+// bandwidth, and floats halve its traffic and the memory of the grid. The voltage u stays in
+// double and the dot products are summed in double. Single precision limits how far the
+// gradient drops (the rounding of the conductances and of its updates), so every CG run stops
+// when its gradient has dropped by mixedReduction, or has not reached a new low for
+// mixedStall cycles (the single precision floor), and the next one starts from the exact
+// gradient of u, computed in double from the conductances of the phases (iterative refinement).
+// The solve stops on the test of dembx applied to the exact gradient.
+void FD2DEL::dembxMixed(double* iu, int* ic, double gtest)
+{
+    const double* bondsX = phaseBonds.data();
+    const double* bondsY = bondsX + (size_t)bondPhases * bondPhases;
+    int icc = 0;
+    refinements = 0;
+    LogRate progress(5.0); // Progress of long solves, every 5 seconds at most
+
+    // Dot product over the real sites, summed in double
+    auto dot = [&](const float* x, const float* y) {
+        double sum = 0.0;
+        for (int j = 1; j <= ny; ++j)
+            for (int i = nx2 * j + 1; i <= nx2 * j + nx; ++i)
+                sum += (double)x[i] * y[i];
+        return sum;
+    };
+    // fgb = A iu with the exact conductances, from the voltage differences (no cancellation of the
+    // diagonal term); returns its squared norm over the real sites
+    auto gradient = [&]() {
+        double gg = 0.0;
+        for (int j = 1; j <= ny; ++j)
+            for (int m = nx2 * j + 1; m <= nx2 * j + nx; ++m)
+            {
+                double g = bondsX[pix[m - 1] * bondPhases + pix[m]] * (iu[m - 1] - iu[m])
+                    + bondsX[pix[m] * bondPhases + pix[m + 1]] * (iu[m + 1] - iu[m])
+                    + bondsY[pix[m - nx2] * bondPhases + pix[m]] * (iu[m - nx2] - iu[m])
+                    + bondsY[pix[m] * bondPhases + pix[m + nx2]] * (iu[m + nx2] - iu[m]);
+                fgb[m] = (float)g;
+                gg += g * g;
+            }
+        copyFaces(fgb);
+        return gg;
+    };
+
+    double gg = gradient();
+    if (gg > gtest)
+    {
+        cgProgressStart(gg, gtest);
+        while ((icc < ncgsteps) && (gg > gtest))
+        {
+            // Single precision CG from the exact gradient, until it has dropped by mixedReduction
+            refinements++;
+            double target = std::max(gtest, mixedReduction * gg);
+            double ggf = dot(fgb, fgb);
+            double lowest = ggf;
+            int lowestCycle = icc;
+            std::copy(fgb, fgb + ns2, fh);
+            while ((icc < ncgsteps) && (ggf > target) && (icc - lowestCycle < mixedStall))
+            {
+                prod(fgx, fgy, fh, fah);
+                double lambda = ggf / dot(fh, fah);
+                for (int i = 0; i < ns2; ++i)
+                {
+                    iu[i] -= lambda * fh[i];
+                    fgb[i] -= (float)(lambda * fah[i]);
+                }
+                double ggNew = dot(fgb, fgb);
+                float gamma = (float)(ggNew / ggf);
+                ggf = ggNew;
+                for (int i = 0; i < ns2; ++i)
+                    fh[i] = fgb[i] + gamma * fh[i];
+
+                icc++;
+                if (ggf < lowest)
+                {
+                    lowest = ggf;
+                    lowestCycle = icc;
+                }
+                cgProgress(icc, ggf);
+                LOG_EVERY(DETAIL_LOG, progress, icc << " gg = " << ggf << " (single precision, refinement " << refinements << ")\n");
+            }
+            gg = gradient();
+        }
+        if (icc == ncgsteps)
+            LOG_WARNING("iteration failed to converge after " << ncgsteps << " steps\n");
+        cgProgressEnd();
+    }
+    *ic = icc;
+}
+
 // Function to initialize grid dimensions
 void FD2DEL::initValues(int x, int y)
 {
@@ -367,59 +819,101 @@ void FD2DEL::initValues(int x, int y)
 }
 
 // Function to allocate and initialize arrays
+// The arrays are allocated untouched and zeroed by the threads of the strip solver, each one its
+// own rows (first touch), so with pinned threads (OMP_PROC_BIND) every strip is in the memory of
+// the socket that solves it.
 void FD2DEL::intitArrays()
 {
-    // Allocate memory for various arrays using OpenMP for parallel allocation
-#pragma omp parallel sections
+    bool mixed = (solver == MIXED_SOLVER); // Single precision arrays in place of gx, gy, gb, h, ah
+    if (mixed)
     {
-#pragma omp section
-        {
-            gx = new double[ns2];    // x-direction conductances
-            std::memset(gx, 0, ns2 * sizeof(double)); // Initialize to zero
-        }
-#pragma omp section
-        {
-            gy = new double[ns2];    // y-direction conductances
-            memset(gy, 0, ns2 * sizeof(double)); // Initialize to zero
-        }
-#pragma omp section
-        {
-            u = new double[ns2];     // Voltage field
-            memset(u, 0, ns2 * sizeof(double));  // Initialize to zero
-        }
-#pragma omp section
-        {
-            gb = new double[ns2];    // Gradient vector
-            memset(gb, 0, ns2 * sizeof(double)); // Initialize to zero
-        }
-#pragma omp section
-        {
-            h = new double[ns2];     // Conjugate gradient direction vector
-            memset(h, 0, ns2 * sizeof(double));  // Initialize to zero
-        }
-#pragma omp section
-        {
-            ah = new double[ns2];    // A * h vector
-            memset(ah, 0, ns2 * sizeof(double)); // Initialize to zero
-        }
-#pragma omp section
-        {
-            a = new double[ns2];     // Placeholder (possibly for volume fractions or temporary calculations)
-            memset(a, 0, ns2 * sizeof(double));  // Initialize to zero
-        }
-#pragma omp section
+        fgx = new float[ns2];
+        fgy = new float[ns2];
+        fgb = new float[ns2];
+        fh = new float[ns2];
+        fah = new float[ns2];
+    }
+    else
+    {
+        gx = new double[ns2];    // x-direction conductances
+        gy = new double[ns2];    // y-direction conductances
+        gb = new double[ns2];    // Gradient vector
+        h = new double[ns2];     // Conjugate gradient direction vector
+        ah = new double[ns2];    // A * h vector
+    }
+    u = new double[ns2];     // Voltage field
+    int phases = std::max(_maxComponents, components);
+    a = new double[phases];  // Volume fractions of the phases (indexed by phase)
+    std::fill_n(a, phases, 0.0);
+    pix = new int[ns2];      // Pixel phase labels
+    list = new int[ns2];     // List of real (interior) sites
+
+#pragma omp parallel num_threads(stripCount())
+    {
+        // First touch by the strips of dembxStrips, split among the threads the team really has
+        int first, last;
+        stripRows(omp_get_thread_num(), omp_get_num_threads(), &first, &last);
+        size_t begin = (size_t)first * nx2, count = (size_t)(last - first) * nx2;
+        if (mixed)
         {
-            pix = new int[ns2];;      // Pixel phase labels
-            memset(pix, 0, ns2 * sizeof(int));   // Initialize to zero
+            std::fill_n(fgx + begin, count, 0.0f);
+            std::fill_n(fgy + begin, count, 0.0f);
+            std::fill_n(fgb + begin, count, 0.0f);
+            std::fill_n(fh + begin, count, 0.0f);
+            std::fill_n(fah + begin, count, 0.0f);
         }
-#pragma omp section
+        else
         {
-            list = new int[ns2];     // List of real (interior) sites
-            memset(list, 0, ns2 * sizeof(int));  // Initialize to zero
+            std::fill_n(gx + begin, count, 0.0);
+            std::fill_n(gy + begin, count, 0.0);
+            std::fill_n(gb + begin, count, 0.0);
+            std::fill_n(h + begin, count, 0.0);
+            std::fill_n(ah + begin, count, 0.0);
         }
+        std::fill_n(u + begin, count, 0.0);
+        std::fill_n(pix + begin, count, 0);
+        std::fill_n(list + begin, count, 0);
+    }
+}
+
+void FD2DEL::solverArrays(void)
+{
+    if ((solver == MIXED_SOLVER) && (fgx == NULL))
+    {
+        fgx = new float[ns2]();
+        fgy = new float[ns2]();
+        fgb = new float[ns2]();
+        fh = new float[ns2]();
+        fah = new float[ns2]();
+    }
+    else if ((solver != MIXED_SOLVER) && (gx == NULL))
+    {
+        gx = new double[ns2]();
+        gy = new double[ns2]();
+        gb = new double[ns2]();
+        h = new double[ns2]();
+        ah = new double[ns2]();
     }
 }
 
+// Strips of the domain-decomposed solver: one per thread, at least two real rows each
+int FD2DEL::stripCount(void) const
+{
+    return std::max(1, std::min(omp_get_max_threads(), ny / 2));
+}
+
+// Rows [first, last) of the padded grid owned by strip s of strips: its share of the real rows
+// 1..ny, and the periodic halo row 0 (first strip) or ny + 1 (last strip)
+void FD2DEL::stripRows(int s, int strips, int* first, int* last) const
+{
+    *first = 1 + (int)((long long)ny * s / strips);
+    *last = 1 + (int)((long long)ny * (s + 1) / strips);
+    if (s == 0)
+        *first = 0;
+    if (s == strips - 1)
+        *last = ny2;
+}
+
 // Constructor for FD2DEL class when grid dimensions are known
 FD2DEL::FD2DEL(int x, int y, int icomponents, int i_maxComponents) :width(x), heigth(y),
 nx(x), ny(y), nx1(x + 1), ny1(y + 1), nx2(x + 2), ny2(y + 2), components(icomponents), _maxComponents(i_maxComponents)
@@ -451,6 +945,11 @@ FD2DEL::~FD2DEL(void)
     delete[] gb;
     delete[] h;
     delete[] ah;
+    delete[] fgx;
+    delete[] fgy;
+    delete[] fgb;
+    delete[] fh;
+    delete[] fah;
     delete[] a;
     delete[] pix;
     delete[] list;
@@ -463,128 +962,396 @@ FD2DEL::~FD2DEL(void)
 // void FD2DEL::run(char* inputFileName, char* outputFileName, int nx, int ny)
 // {}
 
-// Function to read pixel data from a file
-void FD2DEL::readFromFile(char* inputFileName)
+// --- Phase map input ---
+
+// Read-only view of a whole input file: memory mapped where available, read into memory otherwise.
+class InputFileView
 {
-    std::string line;
-    std::ifstream inputFile(inputFileName); // Open the input file
-    if (inputFile.is_open())               // Check if the file opened successfully
+#ifdef FD2DEL_HAS_MMAP
+    void* region = MAP_FAILED; // Mapping of the file
+#endif
+    std::vector<char> buffer;  // Contents of a file that is not mapped
+    bool opened = false;
+
+public:
+    const char* data = "";     // First byte of the file
+    size_t size = 0;           // Bytes of the file
+
+    explicit InputFileView(const char* fileName)
     {
-        // Read pixel values and store them in the pix array
-        for (int i = 2; i <= nx + 1; i++)
-            for (int j = 1; j <= ny + 1; j++)
+#ifdef FD2DEL_HAS_MMAP
+        int fd = open(fileName, O_RDONLY);
+        if (fd < 0)
+            return;
+        struct stat info;
+        if (fstat(fd, &info) == 0)
+        {
+            opened = true;
+            size = (size_t)info.st_size;
+            if (size > 0)
+                region = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (region != MAP_FAILED)
+            {
+                madvise(region, size, MADV_SEQUENTIAL);
+                data = (const char*)region;
+            }
+            else if (size > 0) // Not mappable: read it
             {
-                getline(inputFile, line);              // Read a line from the file
-                int m = (j - 1) * (nx + 2) + i;       // Calculate the 1D index
-                pix[m - 1] = std::stoi(line) - 1; // Convert string to int and store (adjusting for 0-based indexing)
+                buffer.resize(size);
+                opened = (pread(fd, buffer.data(), size, 0) == (ssize_t)size);
+                data = buffer.data();
             }
+        }
+        close(fd);
+#else
+        FILE* file = fopen(fileName, "rb");
+        if (file == NULL)
+            return;
+        fseek(file, 0, SEEK_END);
+        long length = ftell(file);
+        fseek(file, 0, SEEK_SET);
+        if (length > 0)
+        {
+            buffer.resize((size_t)length);
+            size = fread(buffer.data(), 1, buffer.size(), file);
+            data = buffer.data();
+        }
+        opened = true;
+        fclose(file);
+#endif
     }
+
+    ~InputFileView()
+    {
+#ifdef FD2DEL_HAS_MMAP
+        if (region != MAP_FAILED)
+            munmap(region, size);
+#endif
+    }
+
+    bool isOpen(void) const { return opened; }
+};
+
+// Value separators of text phase maps
+static inline bool isSeparator(char c)
+{
+    return (c == ' ') || (c == '\t') || (c == ',') || (c == '\r') || (c == '\n');
 }
 
-/*
-// Function to get file size (commented out, likely replaced by another version)
-long GetFileSize(std::string filename)
+// Skips separators and parses the next integer. Returns false at the end of the data or on a bad value.
+static bool nextInt(const char*& p, const char* end, int* value)
 {
-    struct stat stat_buf;
-    int rc = stat(filename.c_str(), &stat_buf);
-    return rc == 0 ? stat_buf.st_size : -1;
+    while ((p < end) && isSeparator(*p))
+        p++;
+    if (p >= end)
+        return false;
+    std::from_chars_result result = std::from_chars(p, end, *value);
+    if (result.ec != std::errc())
+        return false;
+    p = result.ptr;
+    return true;
 }
-*/
 
-// Function to split a string by a delimiter
-std::vector<std::string> FD2DEL::split(std::string strToSplit, char delimeter)
+// Skips blanks and '#' comments of a PGM header and parses the next integer.
+static bool nextHeaderInt(const char*& p, const char* end, int* value)
 {
-    std::stringstream ss(strToSplit);  // Create a stringstream from the input string
-    std::string item;                   // Temporary string to hold split items
-    std::vector<std::string> splittedStrings; // Vector to store the split strings
-    while (std::getline(ss, item, delimeter)) // Read items separated by the delimiter
+    for (;;)
     {
-        splittedStrings.push_back(item); // Add the item to the vector
+        while ((p < end) && isSeparator(*p))
+            p++;
+        if ((p < end) && (*p == '#'))
+        {
+            const char* eol = (const char*)memchr(p, '\n', end - p);
+            p = (eol != NULL) ? eol + 1 : end;
+            continue;
+        }
+        break;
     }
-    return splittedStrings; // Return the vector of split strings
+    return nextInt(p, end, value);
 }
 
-// Function to read pixel data from an image file into a list
-size_t FD2DEL::readFromImageFile(std::string filename, std::list<int>* pixels)
+// Values on the first non-empty line (x) and number of non-empty lines (y) of a text phase map.
+static void textMapSize(const char* p, const char* end, int* x, int* y)
 {
-    std::string line;
-    std::ifstream inputFile(filename); // Open the input file
-    std::vector<std::string> strComponent; // Vector to hold string components
-    size_t count = 0;                     // Counter for total pixels
-    while (getline(inputFile, line))      // Read file line by line
+    *x = 0;
+    *y = 0;
+    while (p < end)
     {
-        strComponent = split(line, ' '); // Split the line by space
-        for (int i = 0; i < strComponent.size(); i++)
+        const char* eol = (const char*)memchr(p, '\n', end - p);
+        if (eol == NULL)
+            eol = end;
+        const char* q = p;
+        while ((q < eol) && isSeparator(*q))
+            q++;
+        if (q < eol) // Not blank
         {
-            pixels->push_back(std::stoi(strComponent[i])); // Convert to int and add to list
+            if (*y == 0)
+                for (bool inValue = false; q < eol; q++) // Values of the first row
+                {
+                    if (!isSeparator(*q) && !inValue)
+                        (*x)++;
+                    inValue = !isSeparator(*q);
+                }
+            (*y)++;
         }
-        count = count + strComponent.size(); // Update pixel count
+        p = eol + 1;
     }
-    inputFile.close(); // Close the file
-    return count;      // Return total pixel count
 }
 
-// Function to read pixel data from an image file into a list and determine dimensions
-size_t FD2DEL::readFromImageFile(std::string filename, std::list<int>* pixels, int* x, int* y)
+// Little-endian fields of a BMP header
+static uint32_t le32(const char* p)
+{
+    const unsigned char* b = (const unsigned char*)p;
+    return b[0] | (b[1] << 8) | (b[2] << 16) | ((uint32_t)b[3] << 24);
+}
+
+static uint16_t le16(const char* p)
 {
-    std::string line;
-    std::ifstream inputFile(filename); // Open the input file
-    std::vector<std::string> strComponent; // Vector to hold string components
-    long count = 0;                    // Counter for total pixels
-    *x = 0;                             // Initialize x dimension
-    *y = 0;                             // Initialize y dimension
-    while (getline(inputFile, line))   // Read file line by line
+    const unsigned char* b = (const unsigned char*)p;
+    return (uint16_t)(b[0] | (b[1] << 8));
+}
+
+// Function to read pixel data from a file (one value per line, dimensions set before)
+void FD2DEL::readFromFile(char* inputFileName)
+{
+    InputFileView file(inputFileName); // Map the input file
+    const char* p = file.data;
+    const char* end = file.data + file.size;
+    int value;
+
+    // Read pixel values and store them in the pix array
+    for (int i = 2; i <= nx + 1; i++)
+        for (int j = 1; j <= ny + 1; j++)
+        {
+            if (!nextInt(p, end, &value))
+                return;
+            int m = (j - 1) * (nx + 2) + i;       // Calculate the 1D index
+            pix[m - 1] = value - 1; // Store (adjusting for 0-based indexing)
+        }
+}
+
+// Function to read pixel data from an image file sequentially (row by row)
+void FD2DEL::readFromImageFileSequantially(char* inputFileName)
+{
+    InputFileView file(inputFileName); // Map the input file
+    const char* p = file.data;
+    const char* end = file.data + file.size;
+    int value;
+
+    // Iterate through the grid, reading one pixel value at a time
+    for (int i = 2; i <= nx + 1; i++)
+        for (int j = 1; j < ny + 1; j++)
+        {
+            if (!nextInt(p, end, &value))
+                return;
+            int m = (j - 1) * (nx + 2) + i;       // Calculate 1D index for the pix array
+            pix[m - 1] = value - 1; // Store (adjusting for 0-based indexing)
+        }
+}
+
+// Number of values and dimensions of a phase map, from the image header or the lines of a text map
+long FD2DEL::GetFileSize(std::string filename, int* x, int* y)
+{
+    *x = 0;
+    *y = 0;
+    InputFileView file(filename.c_str());
+    const char* p = file.data;
+    const char* end = file.data + file.size;
+    int maxValue;
+
+    if ((file.size >= 2) && (p[0] == 'P') && ((p[1] == '5') || (p[1] == '2')))
+    {
+        p += 2;
+        if (!nextHeaderInt(p, end, x) || !nextHeaderInt(p, end, y) || !nextHeaderInt(p, end, &maxValue))
+            *x = *y = 0;
+    }
+    else if ((file.size >= 54) && (p[0] == 'B') && (p[1] == 'M'))
     {
-        strComponent = split(line, ' '); // Split the line by space
-        *x = strComponent.size();        // The width is the number of components in a line
-        for (int i = 0; i < strComponent.size(); i++)
+        *x = (int)le32(p + 18);
+        *y = std::abs((int)le32(p + 22));
+    }
+    else
+        textMapSize(p, end, x, y);
+    return (long)*x * *y;
+}
+
+void FD2DEL::setMapSize(int x, int y)
+{
+    initValues(x, y);  // Initialize grid values
+    intitArrays();     // Allocate arrays
+}
+
+// Image maps store gray levels (or palette indexes); the levels found become phases 0, 1, 2...
+void FD2DEL::numberPhases(int levels)
+{
+    std::vector<int> phase(levels, -1);
+    for (int j = 2; j <= ny + 1; j++)
+        for (int i = 2; i <= nx + 1; i++)
+            phase[pix[(j - 1) * nx2 + i - 1]] = 0;
+
+    int found = 0;
+    for (int level = 0; level < levels; level++)
+        if (phase[level] == 0)
+            phase[level] = found++;
+    if (found > components)
+        std::cerr << "*** Warning: phase map has " << found << " levels, more than the " << components << " components ****\n";
+
+#pragma omp parallel for
+    for (int j = 2; j <= ny + 1; j++)
+        for (int i = 2; i <= nx + 1; i++)
         {
-            pixels->push_back(std::stoi(strComponent[i])); // Convert to int and add to list
+            int m = (j - 1) * nx2 + i - 1;
+            pix[m] = phase[pix[m]];
         }
-        count = count + strComponent.size(); // Update pixel count
-        *y = *y + 1;                         // Increment y dimension (number of rows)
+}
+
+// Reads a phase map of any supported format (see FD2DEL.h) straight into pix
+bool FD2DEL::readPhaseMap(const char* inputFileName, int* x, int* y)
+{
+    InputFileView file(inputFileName); // Map the input file
+    if (!file.isOpen())
+    {
+        std::cerr << "Error: Could not open phase map " << inputFileName << "\n";
+        return false;
     }
-    inputFile.close(); // Close the file
-    return count;      // Return total pixel count
+
+    const char* data = file.data;
+    if ((file.size >= 2) && (data[0] == 'P') && ((data[1] == '5') || (data[1] == '2')))
+        return readPGMPhaseMap(data, file.size, inputFileName, x, y);
+    if ((file.size >= 2) && (data[0] == 'B') && (data[1] == 'M'))
+        return readBMPPhaseMap(data, file.size, inputFileName, x, y);
+    return readTextPhaseMap(data, file.size, inputFileName, x, y);
 }
 
-// Function to get file size and dimensions without reading all data into memory
-long FD2DEL::GetFileSize(std::string filename, int* x, int* y)
+// Text map: 1-based phases, rows on lines. One pass over the lines gives the size, one over the values fills pix.
+bool FD2DEL::readTextPhaseMap(const char* data, size_t size, const char* inputFileName, int* x, int* y)
 {
-    std::string line;
-    std::ifstream inputFile(filename); // Open the input file
-    std::vector<std::string> strComponent; // Vector to hold string components
-    long count = 0;                    // Counter for total pixels
-    *x = 0;                             // Initialize x dimension
-    *y = 0;                             // Initialize y dimension
-    while (getline(inputFile, line))   // Read file line by line
+    const char* p = data;
+    const char* end = data + size;
+
+    textMapSize(p, end, x, y);
+    // A single column (or row) of values is a square map
+    if ((*x == 1) || (*y == 1))
+    {
+        long count = (long)*x * *y;
+        *x = int(std::sqrt(count)); // Calculate side length for a square image
+        *y = *x;
+        if ((long)*x * *x != count)
+            std::cerr << "*** Warning: " << count << " values of " << inputFileName << " are not a square map, " << *x << "x" << *y << " are used ****\n";
+    }
+    if ((*x <= 0) || (*y <= 0))
     {
-        strComponent = split(line, ' '); // Split the line by space
-        *x = strComponent.size();        // The width is the number of components in a line
-        count = count + *x;              // Update pixel count
-        *y = *y + 1;                     // Increment y dimension (number of rows)
+        std::cerr << "Error: " << inputFileName << " holds no phases\n";
+        return false;
     }
-    inputFile.close(); // Close the file
-    return count;      // Return total pixel count
+    setMapSize(*x, *y);
+
+    // Populate the 'pix' array row by row
+    int value;
+    for (int j = 2; j <= ny + 1; j++)
+        for (int i = 2; i <= nx + 1; i++)
+        {
+            if (!nextInt(p, end, &value))
+            {
+                std::cerr << "Error: " << inputFileName << " has a bad or missing value at row " << j - 1 << ", column " << i - 1 << "\n";
+                return false;
+            }
+            pix[(j - 1) * nx2 + i - 1] = value - 1; // Adjust for 0-based phases
+        }
+    return true;
 }
 
-// Function to read pixel data from an image file sequentially (row by row)
-void FD2DEL::readFromImageFileSequantially(char* inputFileName)
+// PGM map: binary P5 (8 or 16 bit samples) or ASCII P2
+bool FD2DEL::readPGMPhaseMap(const char* data, size_t size, const char* inputFileName, int* x, int* y)
+{
+    const char* p = data + 2;
+    const char* end = data + size;
+    bool binary = (data[1] == '5');
+    int maxValue = 0;
+    if (!nextHeaderInt(p, end, x) || !nextHeaderInt(p, end, y) || !nextHeaderInt(p, end, &maxValue)
+        || (*x <= 0) || (*y <= 0) || (maxValue <= 0) || (maxValue > 65535))
+    {
+        std::cerr << "Error: " << inputFileName << " has a bad PGM header\n";
+        return false;
+    }
+    p++; // The single blank after the maximum value
+
+    size_t sampleBytes = (maxValue < 256) ? 1 : 2;
+    if (binary && ((size_t)(end - p) < (size_t)*x * *y * sampleBytes))
+    {
+        std::cerr << "Error: " << inputFileName << " is shorter than its " << *x << "x" << *y << " pixels\n";
+        return false;
+    }
+    setMapSize(*x, *y);
+
+    const unsigned char* samples = (const unsigned char*)p;
+    for (int j = 2; j <= ny + 1; j++)
+        for (int i = 2; i <= nx + 1; i++)
+        {
+            int value;
+            if (binary)
+            {
+                size_t k = (size_t)(j - 2) * nx + (i - 2);
+                value = (sampleBytes == 1) ? samples[k] : (samples[2 * k] << 8) | samples[2 * k + 1]; // 16 bit samples are big-endian
+            }
+            else if (!nextInt(p, end, &value) || (value < 0) || (value > maxValue))
+            {
+                std::cerr << "Error: " << inputFileName << " has a bad or missing value at row " << j - 1 << ", column " << i - 1 << "\n";
+                return false;
+            }
+            pix[(j - 1) * nx2 + i - 1] = std::min(value, maxValue);
+        }
+    numberPhases(maxValue + 1);
+    return true;
+}
+
+// BMP map: uncompressed 8 bit (palette indexes) or 24 bit (gray of the colour), bottom-up or top-down rows
+bool FD2DEL::readBMPPhaseMap(const char* data, size_t size, const char* inputFileName, int* x, int* y)
 {
-    std::string line;
-    std::ifstream inputFile(inputFileName); // Open the input file
+    if (size < 54)
+    {
+        std::cerr << "Error: " << inputFileName << " has a bad BMP header\n";
+        return false;
+    }
+    size_t offset = le32(data + 10);
+    int height = (int)le32(data + 22);
+    int bitsPerPixel = le16(data + 28);
+    *x = (int)le32(data + 18);
+    *y = std::abs(height);
+    if ((le32(data + 30) != 0) || ((bitsPerPixel != 8) && (bitsPerPixel != 24)) || (*x <= 0) || (*y <= 0))
+    {
+        std::cerr << "Error: " << inputFileName << " is not an uncompressed 8 or 24 bit BMP\n";
+        return false;
+    }
+    size_t rowBytes = ((size_t)*x * (bitsPerPixel / 8) + 3) & ~(size_t)3; // Rows are padded to 4 bytes
+    if ((offset > size) || (size - offset < rowBytes * *y))
+    {
+        std::cerr << "Error: " << inputFileName << " is shorter than its " << *x << "x" << *y << " pixels\n";
+        return false;
+    }
+    setMapSize(*x, *y);
 
-    if (inputFile.is_open())               // Check if the file opened successfully
+    const unsigned char* pixels = (const unsigned char*)data + offset;
+#pragma omp parallel for
+    for (int j = 2; j <= ny + 1; j++)
     {
-        // Iterate through the grid, reading one pixel value at a time
+        int row = (height > 0) ? ny + 1 - j : j - 2; // Bottom-up unless the height is negative
+        const unsigned char* line = pixels + (size_t)row * rowBytes;
         for (int i = 2; i <= nx + 1; i++)
-            for (int j = 1; j < ny + 1; j++)
+        {
+            int value;
+            if (bitsPerPixel == 8)
+                value = line[i - 2];
+            else // B, G, R
             {
-                getline(inputFile, line);              // Read a line (pixel value)
-                int m = (j - 1) * (nx + 2) + i;       // Calculate 1D index for the pix array
-                pix[m - 1] = std::stoi(line) - 1; // Convert string to int and store (adjusting for 0-based indexing)
+                const unsigned char* bgr = line + 3 * (size_t)(i - 2);
+                value = (114 * bgr[0] + 587 * bgr[1] + 299 * bgr[2] + 500) / 1000;
             }
+            pix[(j - 1) * nx2 + i - 1] = value;
+        }
     }
+    numberPhases(256);
+    return true;
 }
 
 // Function to read pixel data from an unsigned char array (gradients)
@@ -623,82 +1390,27 @@ void FD2DEL::readFromArray(unsigned char* ingadients, double* iMaterialsElecricC
 // Function to read pixel data from an image file and initialize grid
 void FD2DEL::readFromImageFile(char* inputFileName, int* x, int* y)
 {
-    std::list<int> data;                      // Temporary list to store pixel data
-    // Get file size and dimensions, and read data into the list
-    long fileSize = readFromImageFile(inputFileName, &data, x, y);
-
-    // If either x or y dimension is 1 (meaning it's a 1D array), assume square shape
-    if ((*x == 1) || (*y == 1))
-    {
-        *x = int(std::sqrt(fileSize)); // Calculate side length for a square image
-        *y = *x;
-        initValues(*x, *y);  // Initialize grid values
-        intitArrays();       // Allocate arrays
-    }
-    else // If dimensions are already determined
-    {
-        initValues(*x, *y);  // Initialize grid values
-        intitArrays();       // Allocate arrays
-    }
-
-    // Populate the 'pix' array from the 'data' list
-    for (int j = 2; j <= ny + 1; j++)
-        for (int i = 2; i <= nx + 1; i++)
-        {
-            int m = (j - 1) * nx2 + i;      // Calculate 1D index for the pix array
-            pix[m - 1] = data.front() - 1; // Get first element, adjust for 0-based index, and store
-            data.pop_front();              // Remove the element from the list
-            std::cout << m - 1 << "," << pix[m - 1] << "\n"; // Debug output
-        }
+    readPhaseMap(inputFileName, x, y);
 }
 
-// Function to read pixel data from a file and initialize grid (similar to readFromImageFile but without list)
+// Function to read pixel data from a file and initialize grid
 void FD2DEL::readFromFile(char* inputFileName, int* x, int* y)
 {
-    // Get file size and dimensions
-    long fileSize = GetFileSize(inputFileName, x, y);
-    // If either x or y dimension is 1 (meaning it's a 1D array), assume square shape
-    if ((*x == 1) || (*y == 1))
-    {
-        *x = int(sqrt(fileSize)); // Calculate side length for a square image
-        *y = *x;
-        initValues(*x, *y);  // Initialize grid values
-        intitArrays();       // Allocate arrays
-    }
-    else // If dimensions are already determined
-    {
-        initValues(*x, *y);  // Initialize grid values
-        intitArrays();       // Allocate arrays
-    }
-
-    std::string line;
-    std::ifstream inputFile(inputFileName); // Open the input file
-
-    if (inputFile.is_open())               // Check if the file opened successfully
-    {
-        // Read pixel values and store them in the pix array
-        for (int j = 2; j <= ny2 - 1; j++)
-            for (int i = 2; i <= ny2 - 1; i++)
-            {
-                getline(inputFile, line);              // Read a line from the file
-                int m = (j - 1) * nx2 + i;            // Calculate the 1D index
-                pix[m - 1] = std::stoi(line) - 1; // Convert string to int and store (adjusting for 0-based indexing)
-                std::cout << m << "," << pix[m - 1] << "\n"; // Debug output
-            }
-    }
-    inputFile.close(); // Close the file
+    readPhaseMap(inputFileName, x, y);
 }
 
 // Main function to run the simulation
 void FD2DEL::run(char* inputFileName, char* outputFileName, int inphase)
 {
-    std::cout << "image is " << nx << " x " << ny << " no of real sites =" << nx * ny << "\n";
+    LOG_DETAIL("image is " << nx << " x " << ny << " no of real sites =" << nx * ny << "\n");
 
     // (USER) nphase is the number of phases being considered in the problem.
     // The values of pix(m) will run from 1 to nphase. ntot is the total
     // number of phases possible in the program, and is the dimension of
     // sigma, a, and be.
 
+    std::optional<ScopedTimer> bondTimer(FDM_BOND_PHASE); // Site list, phase fractions and bonds
+
     int nphase = inphase;   // Number of phases in the current problem
     int ntot = 100;         // Total number of phases possible (dimension for arrays)
     // Make list of real (interior) sites, used in subroutine dembx. The 1-d
@@ -724,16 +1436,20 @@ void FD2DEL::run(char* inputFileName, char* outputFileName, int inphase)
     ppixel(pix, a, nphase, ntot); // Calculate phase volume fractions and map periodic boundaries
 
     // Output phase volume fractions
-    for (int i = 0; i < nphase; ++i)
+    if (logEnabled(DETAIL_LOG))
     {
-        std::cout << "phase fraction of " << i << " = " << a[i] << "\n";
+        std::ostringstream fractions;
+        fractions.imbue(std::cout.getloc());
+        for (int i = 0; i < nphase; ++i)
+            fractions << "phase fraction of " << i << " = " << a[i] << "\n";
+        logWrite(DETAIL_LOG, fractions.str());
     }
 
     // (USER) Set components of applied field, E = (ex,ey)
     double ex = 0.0; // Applied electric field in x-direction
     double ey = 1.0; // Applied electric field in y-direction
 
-    std::cout << "Applied field components : ex =" << ex << " ey = " << ey << "\n";
+    LOG_DETAIL("Applied field components : ex =" << ex << " ey = " << ey << "\n");
 
     // Initialize the voltage distribution by applying a uniform field.
     for (int j = 1; j <= ny2; ++j)
@@ -751,18 +1467,50 @@ void FD2DEL::run(char* inputFileName, char* outputFileName, int inphase)
     // The previous `readFromArray` function sets this if used.
 
     // bond() sets up conductor network in gx,gy 1-d arrays
-    bond(pix, gx, gy, sigma, be, nphase, ntot); // Calculate bond conductances
+    solverArrays(); // Arrays of a solver set after intitArrays
+    if (solver == MIXED_SOLVER)
+        bond(pix, fgx, fgy, sigma, be, nphase, ntot); // Single precision bond conductances
+    else
+        bond(pix, gx, gy, sigma, be, nphase, ntot); // Calculate bond conductances
+    bondTimer.reset();
 
     // Subroutine dembx accepts gx,gy and solves for the voltage field F
     // that minimizes the dissipated energy.
     int ic = 0; // Conjugate gradient iteration counter
-    dembx(gx, gy, u, &ic, gb, h, ah, list, nlist, gtest); // Solve for voltage field
+    fdmUnknowns = nx * ny;
+    {
+        ScopedTimer timer(FDM_CG_PHASE);
+        if (solver == MIXED_SOLVER)
+            dembxMixed(u, &ic, gtest); // Single precision arrays, whole grid (the backbone needs gx, gy)
+        else if ((backboneCut >= 0.0) && backbone.build(gx, gy, u, nx, ny, backboneCut))
+        {
+            // Only the current carrying blocks, with their series chains eliminated; the potentials
+            // of every other site are set from them (dead ends) or from their own clusters
+            fdmUnknowns = backbone.unknowns();
+            LOG_DETAIL("Backbone: " << backbone.keptSites << " of " << nx * ny << " sites in " << backbone.blocks
+                << " current carrying blocks, " << fdmUnknowns << " unknowns\n");
+            ic = backbone.solve(gtest, ncgsteps);
+            if (ic == ncgsteps)
+                LOG_WARNING("iteration failed to converge after " << ncgsteps << " steps\n");
+            backbone.mapBack(gx, gy, u);
+        }
+        else if (solver == BLOCK_JACOBI_SOLVER)
+            dembxStrips(gx, gy, u, &ic, gb, h, ah, gtest); // Row strips per thread, block-Jacobi preconditioned
+        else if (solver == AMG_SOLVER)
+            dembxAmg(gx, gy, u, &ic, gb, h, ah, gtest); // Algebraic multigrid preconditioned
+        else
+            dembx(gx, gy, u, &ic, gb, h, ah, list, nlist, gtest); // Solve for voltage field
+    }
+    cgIterations = ic;
 
     // Find final current after voltage solution is done
-    current(&currx, &curry, u, gx, gy); // Calculate average currents
+    if (solver == MIXED_SOLVER)
+        phaseCurrent(&currx, &curry, u); // Exact conductances of the phases
+    else
+        current(&currx, &curry, u, gx, gy); // Calculate average currents
 
     // Output final results
-    std::cout << "\naverage current in x direction = " << currx << "\n";
-    std::cout << "average current in y direction = " << curry << "\n";
-    std::cout << "number of conjugate gradient cycles needed = " << ic << "\n";
+    LOG_DETAIL("average current in x direction = " << currx << "\n"
+        << "average current in y direction = " << curry << "\n"
+        << "number of conjugate gradient cycles needed = " << ic << "\n");
 }
\ No newline at end of file
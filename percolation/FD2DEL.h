@@ -34,7 +34,10 @@ if you use this programm and write a paper or report please cite above papers
 #include <sstream>     // For string stream operations (e.g., std::istringstream).
 #include <sys/stat.h>  // For stat() function, used to get file information like size.
 #include <vector>      // For std::vector dynamic arrays.
-#include <list>        // For std::list doubly-linked list.
+#include "PerfCounters.h" // Sections, counters and traffic model of the CG solve.
+#include "general.h"   // FdmSolver.
+#include "Amg.h"       // Algebraic multigrid preconditioner of the AMG_SOLVER.
+#include "Backbone.h"  // Current carrying backbone solved in place of the whole grid.
 
 // --- Template Class for 2D Matrix ---
 // A generic 2D matrix class that can store any data type 'T'.
@@ -126,12 +129,23 @@ protected:
 class FD2DEL
 {
 	// Private members for storing simulation data and parameters.
-	double* gx; // Grid data for x-direction (e.g., current or potential gradient).
-	double* gy; // Grid data for y-direction.
-	double* u;  // Potential or voltage field.
-	double* gb; // Boundary conditions or other specific grid values.
-	double* h;  // Step sizes or grid spacing.
-	double* ah; // Another grid related to h.
+	double* gx = NULL; // Grid data for x-direction (e.g., current or potential gradient).
+	double* gy = NULL; // Grid data for y-direction.
+	double* u = NULL;  // Potential or voltage field.
+	double* gb = NULL; // Boundary conditions or other specific grid values.
+	double* h = NULL;  // Step sizes or grid spacing.
+	double* ah = NULL; // Another grid related to h.
+	// Single precision conductances, gradient and search vectors of the MIXED_SOLVER, in place of
+	// gx, gy, gb, h and ah (which are then not allocated).
+	float* fgx = NULL;
+	float* fgy = NULL;
+	float* fgb = NULL;
+	float* fh = NULL;
+	float* fah = NULL;
+	// Exact conductances of the bonds between phases i and j: [i * bondPhases + j] along x, then the
+	// same along y. The MIXED_SOLVER takes its double residuals and currents from them.
+	std::vector<double> phaseBonds;
+	int bondPhases = 0;
 
 	int width = 0;    // Grid width.
 	int heigth = 0;   // Grid height.
@@ -141,28 +155,61 @@ class FD2DEL
 
 	Matrix2D<double>* sigma; // 2D matrix for material conductivities or permittivity.
 	Matrix3D<double>* be;    // 3D matrix for basis functions or other material properties.
-	double* a;               // General purpose array, possibly for material properties.
+	double* a = NULL;        // Volume fractions of the phases.
 
-	int* list;       // Array for managing lists of elements (e.g., for sparse matrix solvers).
+	int* list = NULL; // Array for managing lists of elements (e.g., for sparse matrix solvers).
 	int ncgsteps = 50000; // Number of conjugate gradient (CG) steps for iterative solver.
 
 	// Private helper methods for the simulation logic.
 	void current(double* currx, double* curry, double* u, double* gx, double* gy); // Calculates current.
+	void phaseCurrent(double* currx, double* curry, double* u); // current() with the conductances of phaseBonds.
 	void ppixel(int* pix, double* a, int nphase, int ntot); // Processes pixel data.
-	void bond(int* pix, double* gx, double* gy, Matrix2D<double>* sigma, Matrix3D<double>* be, int nphase, int ntot); // Calculates bond properties.
-	void prod(double* gx, double* gy, double* xw, double* yw); // Performs a product operation.
+	template <typename T> // Calculates bond properties (double, or single for the MIXED_SOLVER), and phaseBonds.
+	void bond(int* pix, T* gx, T* gy, Matrix2D<double>* sigma, Matrix3D<double>* be, int nphase, int ntot);
+	template <typename T> // Performs a product operation (double, or single for the MIXED_SOLVER).
+	void prod(T* gx, T* gy, T* xw, T* yw);
+	template <typename T> // Copies the periodic faces of a product (the end of prod).
+	void copyFaces(T* yw);
 	// This method likely performs a preconditioned conjugate gradient step or similar numerical operation.
 	void dembx(double* gx, double* gy, double* u, int* ic, double* gb, double* h, double* Ah, int* list, int nlist, double gtest);
-	// Utility function to split a string by a delimiter.
-	std::vector<std::string> split(std::string strToSplit, char delimeter);
+	// Domain-decomposed dembx: row strips per thread with halo rows, block-Jacobi preconditioned CG.
+	void dembxStrips(double* gx, double* gy, double* u, int* ic, double* gb, double* h, double* Ah, double gtest);
+	// CG preconditioned by one algebraic multigrid V-cycle of the conductance network (amg).
+	void dembxAmg(double* gx, double* gy, double* u, int* ic, double* gb, double* h, double* Ah, double gtest);
+	// CG of dembx on the single precision arrays, double sums and iterative refinement with the exact residual.
+	void dembxMixed(double* u, int* ic, double gtest);
+	// Allocates the arrays of a solver set after intitArrays (double or single precision).
+	void solverArrays(void);
+	// Rows [first, last) of the padded grid owned by strip s of dembxStrips.
+	void stripRows(int s, int strips, int* first, int* last) const;
+
+	// Phase map readers behind readPhaseMap: `data` holds the whole (mapped) file.
+	bool readTextPhaseMap(const char* data, size_t size, const char* inputFileName, int* x, int* y);
+	bool readPGMPhaseMap(const char* data, size_t size, const char* inputFileName, int* x, int* y);
+	bool readBMPPhaseMap(const char* data, size_t size, const char* inputFileName, int* x, int* y);
+	// Sizes the grid (initValues + intitArrays) for an x by y phase map.
+	void setMapSize(int x, int y);
+	// Numbers the gray levels (or palette indexes) found in pix as phases 0, 1, 2... in ascending order.
+	void numberPhases(int levels);
 
 public:
 	double currx = 0.0, curry = 0.0; // Current values in x and y directions.
+	int cgIterations = 0; // Conjugate gradient cycles of the last run.
+	FdmSolver solver = BLOCK_JACOBI_SOLVER; // Solver of the voltage field (CG_SOLVER: serial dembx), set before intitArrays for the MIXED_SOLVER arrays
+	int stripCount(void) const; // Strips (threads) asked for by the BLOCK_JACOBI_SOLVER: one per OpenMP thread, at least two rows each (the team may be smaller)
+	AmgSolver amg; // Multigrid hierarchy of the AMG_SOLVER, built from gx, gy by every solve
+	double backboneCut = -1.0; // Bonds weaker than backboneCut x the strongest are open and only the backbone is solved (negative: whole grid)
+	Backbone backbone; // Backbone of the last solve (when backboneCut >= 0 and a cluster spans the grid)
+	int fdmUnknowns = 0; // Unknowns of the last solve (sites of the grid, or of the reduced backbone)
+	int refinements = 0; // Single precision CG runs of the last MIXED_SOLVER solve (one per exact residual above gtest)
+	double mixedReduction = 1e-10; // Drop of the squared single precision gradient after which the MIXED_SOLVER takes the exact residual
+	int mixedStall = 500; // Cycles without a new low of the single precision gradient after which the MIXED_SOLVER takes the exact residual
+	CgProfile* profile = NULL; // Filled by dembx with the time, hardware counters and model traffic of its sections (NULL: not profiled).
 	double gtest = 1.0e-16 * 100 * 100; // Global test parameter, possibly for convergence criteria.
 	void initValues(int x, int y); // Initializes various values based on grid dimensions.
 
 	void intitArrays(); // Initializes dynamically allocated arrays.
-	int* pix;           // Pixel data, likely representing material phases at each grid point.
+	int* pix = NULL;   // Pixel data, likely representing material phases at each grid point.
 
 	// Constructor: Initializes FD2DEL with grid dimensions and component information.
 	FD2DEL(int x, int y, int components, int imaxComponents);
@@ -174,18 +221,23 @@ public:
 	// Reads simulation parameters or grid data from a file.
 	void readFromFile(char* inputFileName);
 
-	// Reads pixel data from an image file, storing it in a list of integers.
-	size_t readFromImageFile(std::string filename, std::list<int>* pixels);
-	// Reads pixel data from an image file, storing it in a list of integers, and returns image dimensions.
-	size_t readFromImageFile(std::string filename, std::list<int>* pixels, int* x, int* y);
-
-	// Gets the size of an image file and extracts its dimensions (x, y).
+	// Reads a phase map in one pass, sizes the grid and fills `pix` (no intermediate containers).
+	// The file is memory mapped. Formats, told apart by their first bytes:
+	// - text: 1-based phases separated by blanks or commas, one image row per line
+	//   (a single column or row of values is taken as a square map);
+	// - PGM (binary P5 or ASCII P2) and BMP (8 bit palette or 24 bit): gray levels or palette
+	//   indexes, numbered as phases 0, 1, 2... in ascending order (e.g. segmented micrographs).
+	// Returns false (with a message) if the file cannot be read.
+	bool readPhaseMap(const char* inputFileName, int* x, int* y);
+
+	// Gets the number of values of a phase map and its dimensions (x, y), from the image header
+	// or from the lines of a text map, without parsing the values.
 	long GetFileSize(std::string filename, int* x, int* y);
 	// Reads pixel data from an image file sequentially.
 	void readFromImageFileSequantially(char* inputFileName);
-	// Reads pixel data from an image file and returns image dimensions.
+	// Reads pixel data from an image file and returns image dimensions (see readPhaseMap).
 	void readFromImageFile(char* inputFileName, int* x, int* y);
-	// Reads simulation parameters from a file, including dimensions.
+	// Reads simulation parameters from a file, including dimensions (see readPhaseMap).
 	void readFromFile(char* inputFileName, int* x, int* y); // Overload.
 
 	// Reads material data (e.g., phases) from an unsigned character array.
@@ -36,6 +36,14 @@ if you use this programm and write a paper or report please cite above papers
 #include <cmath>      // For mathematical functions like `pow` and `sqrt`.
 #include <numeric>    // For `std::accumulate` (though not directly used in the provided functions, often useful with `std::vector`).
 #include <algorithm>  // For `std::fill_n`, `std::round`, `std::floor`.
+#include "PhaseTimer.h" // Percolate, DFS, BFS, path properties and clusters phases of the realization.
+#include "Log.h"        // Console output by level.
+
+#if defined(__unix__) || defined(__APPLE__)
+#define GRID_HAS_MMAP // Memory mapped planes are available (POSIX)
+#include <sys/mman.h> // For `mmap`, `munmap`, `madvise`.
+#include <unistd.h>   // For `sysconf`, `ftruncate`, `unlink`, `close`.
+#endif
 
 using namespace std; // Brings all names from the `std` namespace into the current scope.
 
@@ -50,6 +58,10 @@ int xNum[] = { -1, 0 ,0,  1 };
 // The y-coordinate offsets for checking neighbors.
 int yNum[] = { 0,  1 ,-1, 0 };
 
+// Backing store of the grids created from now on (set from the settings file).
+GridStorage Grid::storage = HEAP;
+std::string Grid::backingDirectory = ".";
+
 
 // Constructor for the Grid class.
 // Initializes a grid of specified width `x` and height `y`.
@@ -57,6 +69,13 @@ Grid::Grid(int x, int y) : width(x), height(y)
 {
 	total = (size_t)width * height; // Calculates the total number of cells in the grid.
 
+	// Memory mapped planes: the kernel hands out zero pages, so only `cell` has to be written.
+	if ((storage != HEAP) && mapPlanes())
+	{
+		std::fill_n(start, total, CellState::EMPTY);
+		return;
+	}
+
 #pragma omp parallel sections // Directs the compiler to execute the enclosed sections in parallel.
 	{
 #pragma omp section // Defines a block of code to be executed by one thread.
@@ -108,9 +127,88 @@ Grid::Grid(int x, int y) : width(x), height(y)
 }
 
 
+// `mapPlanes` method: Places the five planes, each page aligned, in one memory map. Anonymous maps ask
+// for transparent huge pages; file maps use a temporary file in `backingDirectory` that is deleted at once,
+// so the planes can be paged to that disk instead of swap.
+bool Grid::mapPlanes(void)
+{
+#ifdef GRID_HAS_MMAP
+	size_t page = (size_t)sysconf(_SC_PAGESIZE);
+	planeBytes = ((total + 1 + page - 1) / page) * page; // Room for `total + 1` bytes, as with malloc
+	size_t mappedBytes = 5 * planeBytes;
+	void* region = MAP_FAILED;
+
+	if (storage == ANONYMOUS_MAP)
+	{
+		region = mmap(NULL, mappedBytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+#ifdef MADV_HUGEPAGE
+		if (region != MAP_FAILED)
+			madvise(region, mappedBytes, MADV_HUGEPAGE); // A hint only, failure is harmless
+#endif
+	}
+	else // FILE_MAP
+	{
+		std::string path = backingDirectory + "/gridXXXXXX";
+		std::vector<char> name(path.begin(), path.end());
+		name.push_back('\0');
+		int fd = mkstemp(name.data());
+		if (fd >= 0)
+		{
+			if (ftruncate(fd, (off_t)mappedBytes) == 0)
+				region = mmap(NULL, mappedBytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+			unlink(name.data()); // The mapping keeps the file alive
+			close(fd);
+		}
+	}
+
+	if (region == MAP_FAILED)
+	{
+		LOG_WARNING("cannot map grid planes, using heap memory\n");
+		planeBytes = 0;
+		return false;
+	}
+
+	planes = (char*)region;
+	planesStorage = storage;
+	start = planes;
+	cell = start;
+	end = start + (size_t)width * (height - 1);
+	visited = (bool*)(planes + planeBytes);
+	ingadients = (unsigned char*)(planes + 2 * planeBytes);
+	cluster = (unsigned char*)(planes + 3 * planeBytes);
+	clusterVisited = (bool*)(planes + 4 * planeBytes);
+	return true;
+#else
+	return false;
+#endif
+}
+
+// `releasePages` method: Drops the pages of a mapped region; they are zero on next access and cost
+// nothing until touched. Anonymous maps use MADV_DONTNEED, file maps punch a hole with MADV_REMOVE.
+bool Grid::releasePages(void* from, size_t bytes)
+{
+#ifdef GRID_HAS_MMAP
+	if (planesStorage == ANONYMOUS_MAP)
+		return madvise(from, bytes, MADV_DONTNEED) == 0;
+#ifdef MADV_REMOVE
+	if (planesStorage == FILE_MAP)
+		return madvise(from, bytes, MADV_REMOVE) == 0;
+#endif
+#endif
+	return false;
+}
+
 // `clear` method: Resets all values in the `cell`, `visited`, `ingadients`, `cluster`, and `clusterVisited` arrays.
 void Grid::clear(void)
 {
+	// Mapped planes: the four zero planes are released instead of rewritten. `cell` is rewritten
+	// because EMPTY is '0', not a zero byte (it is also the plane every realization fills anyway).
+	if ((planesStorage != HEAP) && releasePages(planes + planeBytes, 4 * planeBytes))
+	{
+		std::fill_n(cell, total, CellState::EMPTY);
+		return;
+	}
+
 #pragma omp parallel sections // Executes the following sections in parallel.
 	{
 #pragma omp section // Clears the `cell` array to `CellState::EMPTY`.
@@ -215,6 +313,23 @@ Range Grid::fromRectangleToRange(double x1, double y1, double x2, double y2)
 }
 
 
+// `clipRegion` method: Clamps a drawing region to the grid boundaries. On a periodic grid the
+// region may leave the grid (pixels are wrapped by `wrap`), but it never spans more than one period.
+void Grid::clipRegion(Range* region)
+{
+	if (periodic)
+	{
+		if (region->to.x - region->from.x > width) region->to.x = region->from.x + width;
+		if (region->to.y - region->from.y > height) region->to.y = region->from.y + height;
+		return;
+	}
+	if (region->from.x < 0) region->from.x = 0;
+	if (region->from.y < 0) region->from.y = 0;
+	if (region->to.x > width) region->to.x = width;
+	if (region->to.y > height) region->to.y = height;
+}
+
+
 // `isClearSlopedRectangle` method: Checks if a sloped rectangle contains any `HARD` pixels.
 // The rectangle is defined by its center (x, y), dimensions (dx, dy), and `slope` (angle).
 bool Grid::isClearSlopedRectangle(int x, int y, int dx, int dy, double slope)
@@ -413,6 +528,21 @@ bool Grid::isValid(int x, int y)
 }
 
 
+// `wrap` method: On a periodic grid maps x (and y when `wrapY` is set) back into [0, width) x [0, height).
+// Percolation paths wrap only in x, since y is the spanning direction; clusters wrap in both.
+// Returns true if the (possibly mapped) point lies inside the grid.
+bool Grid::wrap(int* x, int* y, bool wrapY)
+{
+	if (periodic)
+	{
+		*x = ((*x % width) + width) % width;
+		if (wrapY)
+			*y = ((*y % height) + height) % height;
+	}
+	return isValid(*x, *y);
+}
+
+
 // `floodFill` method: Performs a flood fill algorithm starting from `src`.
 // It marks connected `HARD` cells as `PERCOLATE`.
 int Grid::floodFill(char* mat, bool* ivisited, point2d src)
@@ -420,7 +550,7 @@ int Grid::floodFill(char* mat, bool* ivisited, point2d src)
 	// Checks if the source cell is walkable.
 	if (!mat[src.y * width + src.x])
 	{
-		cout << "* \n***Error bad destination abord path*** \n"; // Error message.
+		LOG_ERROR("bad destination abord path\n"); // Error message.
 		return -1; // Returns -1 if the source is not valid.
 	}
 
@@ -450,7 +580,7 @@ int Grid::floodFill(char* mat, bool* ivisited, point2d src)
 			int y = pt.y + yNum[i]; // Calculates neighbor's y-coordinate.
 
 			// If the neighbor is valid and is a `HARD` cell, push it to the stack.
-			if (isValid(x, y) && (mat[(size_t)y * width + x] == CellState::HARD))
+			if (wrap(&x, &y, false) && (mat[(size_t)y * width + x] == CellState::HARD))
 			{
 				q.push({ x,y }); // Pushes the neighbor onto the stack.
 			}
@@ -468,7 +598,7 @@ int Grid::DFS(char* mat, bool* ivisited, point2dShort src, point2d* target, int*
 	size_t position = (size_t)src.y * width + src.x; // Calculates the linear index of the source.
 	if (!mat[position]) // Checks if the source cell is valid for traversal.
 	{
-		cout << "Warning:Bad source point at BFS\n"; // Warning message.
+		LOG_WARNING("Bad source point at BFS\n"); // Warning message.
 		return false; // Returns false if source is invalid.
 	}
 
@@ -498,9 +628,11 @@ int Grid::DFS(char* mat, bool* ivisited, point2dShort src, point2d* target, int*
 			int x = curr.x + xNum[i]; // Calculates neighbor's x-coordinate.
 			int y = curr.y + yNum[i]; // Calculates neighbor's y-coordinate.
 
-			position = (size_t)y * width + x; // Calculates neighbor's linear index.
 			// If neighbor is valid and is `HARD` or `SOFT` (percolable materials), push it to the stack.
-			if (isValid(x, y) && (mat[position] == CellState::HARD || mat[position] == CellState::SOFT))
+			if (!wrap(&x, &y, false))
+				continue;
+			position = (size_t)y * width + x; // Calculates neighbor's linear index.
+			if (mat[position] == CellState::HARD || mat[position] == CellState::SOFT)
 				s.push({ short(x), short(y) }); // Pushes the neighbor to the stack.
 		}
 	}
@@ -527,7 +659,7 @@ int Grid::DFSRestore(char* mat, bool* ivisited, point2dShort src)
 	size_t position = (size_t)src.y * width + src.x; // Calculates linear index.
 	if (!mat[position]) // Checks if the source cell is valid.
 	{
-		cout << "Warning:Bad source point at BFS\n"; // Warning message.
+		LOG_WARNING("Bad source point at BFS\n"); // Warning message.
 		return false; // Returns false if source is invalid.
 	}
 
@@ -550,9 +682,11 @@ int Grid::DFSRestore(char* mat, bool* ivisited, point2dShort src)
 			int x = curr.x + xNum[i]; // Neighbor x-coordinate.
 			int y = curr.y + yNum[i]; // Neighbor y-coordinate.
 
-			position = (size_t)y * width + x; // Neighbor linear index.
 			// If neighbor is valid and was part of a `PERCOLATE` or `PATH`, push it to stack.
-			if ((isValid(x, y) && (mat[position] == PERCOLATE)) || ((isValid(x, y) && (mat[position] == PATH))))
+			if (!wrap(&x, &y, false))
+				continue;
+			position = (size_t)y * width + x; // Neighbor linear index.
+			if ((mat[position] == PERCOLATE) || (mat[position] == PATH))
 			{
 				q.push({ short(x), short(y) }); // Pushes neighbor to stack.
 			}
@@ -680,9 +814,11 @@ void Grid::calcPropertiesAtPoint(char* mat, bool* ivisited, queueNode* currentPo
 		else
 			x--; // Move "left" for a vertical main path.
 
-		position = (size_t)y * width + x; // Linear index of the neighbor.
 		// Check if neighbor is valid and `HARD` (part of the material).
-		if (isValid(x, y) && (mat[position] == HARD))
+		if (!wrap(&x, &y, false))
+			break;
+		position = (size_t)y * width + x; // Linear index of the neighbor.
+		if (mat[position] == HARD)
 			material = ingadients[position]; // Get material of neighbor.
 		else
 			break; // Stop if invalid or not `HARD`.
@@ -709,10 +845,11 @@ void Grid::calcPropertiesAtPoint(char* mat, bool* ivisited, queueNode* currentPo
 			y++; // Move "down" for a horizontal main path.
 		else
 			x++; // Move "right" for a vertical main path.
-		position = (size_t)y * width + x; // Linear index of the neighbor.
-
 		// Check if neighbor is valid and not already part of the main `PATH`.
-		if (isValid(x, y) && (mat[position] != PATH))
+		if (!wrap(&x, &y, false))
+			break;
+		position = (size_t)y * width + x; // Linear index of the neighbor.
+		if (mat[position] != PATH)
 			material = ingadients[position]; // Get material of neighbor.
 		else
 			break; // Stop if invalid or is `PATH`.
@@ -801,7 +938,7 @@ int Grid::BFS(char* mat, bool* ivisited, point2d src, int* distance, double* iel
 	size_t position = (size_t)src.y * width + src.x; // Linear index of source.
 	if (!mat[position]) // Checks if source is valid.
 	{
-		cout << "Warning:Bad source point at BFS\n"; // Warning message.
+		LOG_WARNING("Bad source point at BFS\n"); // Warning message.
 		return false; // Returns false if source is invalid.
 	}
 
@@ -836,10 +973,11 @@ int Grid::BFS(char* mat, bool* ivisited, point2d src, int* distance, double* iel
 		{
 			int x = pt.x + xNum[i]; // Neighbor x-coordinate.
 			int y = pt.y + yNum[i]; // Neighbor y-coordinate.
-			position = (size_t)y * width + x; // Neighbor linear index.
-
 			// If neighbor is valid, `PERCOLATE`, and not visited.
-			if ((isValid(x, y)) && (mat[position] == PERCOLATE) && (ivisited[position] == false))
+			if (!wrap(&x, &y, false))
+				continue;
+			position = (size_t)y * width + x; // Neighbor linear index.
+			if ((mat[position] == PERCOLATE) && (ivisited[position] == false))
 			{
 				smallQueueNode Adjcell = { {x, y},{pt.x,pt.y},curr.dist + 1 }; // Creates new node for neighbor.
 				q.push(Adjcell);    // Pushes neighbor to queue.
@@ -884,16 +1022,19 @@ int Grid::clusterCenter(point2d src, doublepoint2d* center, size_t* totalPoints)
 		// Iterates through neighbors.
 		for (int i = 0; i < 4; i++)
 		{
-			int x = pt.x + xNum[i]; // Neighbor x-coordinate.
-			int y = pt.y + yNum[i]; // Neighbor y-coordinate.
+			int x = pt.x + xNum[i]; // Neighbor x-coordinate (unwrapped on periodic grids).
+			int y = pt.y + yNum[i]; // Neighbor y-coordinate (unwrapped on periodic grids).
+			int wx = x, wy = y;     // Neighbor coordinates inside the grid.
 
-			id = (size_t)(y)*width + x; // Neighbor linear index.
+			if (!wrap(&wx, &wy, true))
+				continue;
+			id = (size_t)(wy)*width + wx; // Neighbor linear index.
 
-			// If neighbor is valid, is a material (`HARD`, `PERCOLATE`, `SOFT`), and not visited for clustering.
-			if ((isValid(x, y) && ((cell[id] == CellState::HARD) || (cell[id] == PERCOLATE) || (cell[id] == CellState::SOFT)) && (clusterVisited[id] == false)))
+			// If neighbor is a material (`HARD`, `PERCOLATE`, `SOFT`), and not visited for clustering.
+			if (((cell[id] == CellState::HARD) || (cell[id] == PERCOLATE) || (cell[id] == CellState::SOFT)) && (clusterVisited[id] == false))
 			{
 				clusterVisited[id] = true; // Marks neighbor as visited for clustering.
-				q.push({ x,y });         // Pushes neighbor to queue.
+				q.push({ x,y });         // Pushes neighbor to queue (unwrapped, so the center of mass is continuous).
 			}
 		}
 	}
@@ -934,13 +1075,16 @@ int Grid::clusterInertia(char* mat, unsigned char* clustersImage, point2d src, d
 		// Iterates through neighbors.
 		for (int i = 0; i < 4; i++)
 		{
-			x = pt.x + xNum[i]; // Neighbor x-coordinate.
-			y = pt.y + yNum[i]; // Neighbor y-coordinate.
+			x = pt.x + xNum[i]; // Neighbor x-coordinate (unwrapped on periodic grids).
+			y = pt.y + yNum[i]; // Neighbor y-coordinate (unwrapped on periodic grids).
+			int wx = x, wy = y; // Neighbor coordinates inside the grid.
 
-			id = (size_t)(y)*width + x; // Neighbor linear index.
+			if (!wrap(&wx, &wy, true))
+				continue;
+			id = (size_t)(wy)*width + wx; // Neighbor linear index.
 
-			// If neighbor is valid and was marked as visited (meaning it belongs to the current cluster).
-			if ((isValid(x, y) && (clusterVisited[id] == true)))
+			// If neighbor was marked as visited (meaning it belongs to the current cluster).
+			if (clusterVisited[id] == true)
 			{
 				clustersImage[id] = color; // Assigns the cluster color.
 				clusterVisited[id] = false; // Marks as processed (unvisited for next cluster search).
@@ -967,6 +1111,7 @@ Cluster Grid::markClusters()
 
 	std::queue<Cluster> cClusters; // Queue to hold discovered clusters.
 	double maxRadius = 0; // Tracks the maximum cluster radius found.
+	ScopedTimer timer(CLUSTERS_PHASE); // Clusters phase of the realization.
 
 	// Iterates through all cells in the grid.
 	for (i = 0; i < width; i++)
@@ -1002,7 +1147,7 @@ Cluster Grid::markClusters()
 			maxRadius = currCluster.radius;
 	}
 
-	cout << "Max Radius = " << maxRadius << "\n"; // Prints the maximum radius.
+	LOG_DETAIL("Max Radius = " << maxRadius << "\n"); // Prints the maximum radius (detail level).
 	cMaxClusterRadius.push_back(maxRadius); // Stores the maximum cluster radius.
 	return currCluster; // Returns the last processed cluster (or a default if no clusters were found).
 }
@@ -1078,11 +1223,10 @@ int  Grid::percolate(void)
 int Grid::percolate(double* proccessTime)
 {
 	int result; // Stores the result of percolation.
-	clock_t istart = clock(); // Records start time.
+	ScopedTimer timer(PERCOLATE_PHASE); // Records start time.
 	result = percolate(); // Calls the core percolation logic.
-	clock_t iend = clock(); // Records end time.
-	// Calculates processing time in seconds.
-	*proccessTime = ((double)(iend - istart)) / CLOCKS_PER_SEC;
+	// Calculates processing time (wall) in seconds.
+	*proccessTime = timer.elapsed();
 	return result; // Returns the percolation result.
 }
 
@@ -1120,10 +1264,14 @@ int  Grid::percolateWithRealPathLength(double* totalPaths, double* meanLength, d
 		startPoint = { (short)i,(short)0 }; // Sets the starting point (top row, current column).
 		// If the starting cell is `HARD` or `SOFT`, attempt DFS.
 		if (cell[i] == CellState::HARD || cell[i] == CellState::SOFT)
+		{
+			ScopedTimer timer(DFS_PHASE, false);
 			isPercolate = DFS(cell, visited, startPoint, &endPoint, &pathsLength[0]); // Performs DFS to find a path.
+		}
 
 		if (isPercolate) // If a percolation path is found.
 		{
+			ScopedTimer timer(BFS_PHASE);
 			// Performs BFS to find the shortest path and calculate properties along it.
 			BFS(cell, visited, { i,0 }, &realLength[0], ielectricConductivities, &pelectricResistance[0], ithermalConductivities, &pthermalResistance[0], iYoungModulus, &pYoungModulus[0], iPoissonRatio, &pPoissonRatio[0], &endPoint);
 			*totalPaths = *totalPaths + 1; // Increments total paths found.
@@ -1132,6 +1280,7 @@ int  Grid::percolateWithRealPathLength(double* totalPaths, double* meanLength, d
 	}
 
 	sumResistance = 0; // Reset sum of resistances.
+	ScopedTimer timer(PATH_PROPERTIES_PHASE); // Properties of the paths and of the RVE
 	// Iterates through all found paths to calculate detailed properties.
 	std::list<std::list<smallQueueNode>>::iterator it;
 	for (it = pathsList.begin(); it != pathsList.end(); ++it)
@@ -1181,17 +1330,18 @@ int  Grid::percolateWithRealPathLength(double* totalPaths, double* meanLength, d
 int  Grid::percolateWithRealPathLength(double* totalpaths, double* meanlength, double* meanRealLength, double* proccessTime, double* ielectricConductivities, double* omeanRVEResistance, double* ithermalConductivities, double* omeanRVEThermalResistance, double* iYoungModulus, double* omeanRVEYoungModulus, double* iPoissonRatio, double* omeanRVEPoissonRatio)
 {
 	int result; // Stores the result.
-	clock_t istart = clock(); // Records start time.
-	// Calls the detailed percolation method.
-	result = percolateWithRealPathLength(totalpaths, meanlength, meanRealLength, ielectricConductivities, ithermalConductivities, iYoungModulus, iPoissonRatio, omeanRVEResistance, omeanRVEThermalResistance, omeanRVEYoungModulus, omeanRVEPoissonRatio);
-
-	clock_t iend = clock(); // Records end time.
-	*proccessTime = ((double)(iend - istart)) / CLOCKS_PER_SEC; // Calculates processing time.
-	cout << "mean Paths per RVE=" << *totalpaths << "\n";          // Prints total paths.
-	cout << "mean RVE electric resistance=" << *omeanRVEResistance << "\n"; // Prints mean electric resistance.
-	cout << "mean RVE Thermal resistance=" << *omeanRVEThermalResistance << "\n"; // Prints mean thermal resistance.
-	cout << "mean RVE Young Modulus=" << *omeanRVEYoungModulus << "\n";       // Prints mean Young's Modulus.
-	cout << "mean RVE Poissons Ratio=" << *omeanRVEPoissonRatio << "\n";       // Prints mean Poisson's Ratio.
+	{
+		ScopedTimer timer(PERCOLATE_PHASE); // Records start time.
+		// Calls the detailed percolation method.
+		result = percolateWithRealPathLength(totalpaths, meanlength, meanRealLength, ielectricConductivities, ithermalConductivities, iYoungModulus, iPoissonRatio, omeanRVEResistance, omeanRVEThermalResistance, omeanRVEYoungModulus, omeanRVEPoissonRatio);
+		*proccessTime = timer.elapsed(); // Calculates processing time (wall).
+	}
+	// Paths, resistances and mechanical means of the realization (detail level)
+	LOG_DETAIL("mean Paths per RVE=" << *totalpaths << "\n"
+		<< "mean RVE electric resistance=" << *omeanRVEResistance << "\n"
+		<< "mean RVE Thermal resistance=" << *omeanRVEThermalResistance << "\n"
+		<< "mean RVE Young Modulus=" << *omeanRVEYoungModulus << "\n"
+		<< "mean RVE Poissons Ratio=" << *omeanRVEPoissonRatio << "\n");
 
 	return result; // Returns the percolation result.
 }
@@ -1215,13 +1365,18 @@ void  Grid::show() const
 // `saveToDisk` method: Saves the grid as an image file (BMP or PGM).
 void  Grid::saveToDisk(char* imageFileName, bool saveAsBMP)
 {
-	if (saveAsBMP) // If `saveAsBMP` is true, generate a BMP image.
-	{
-		generateBitmapImage(cell, height, width, imageFileName); // Calls function to create BMP.
-	}
-	else // Otherwise, generate a PGM image.
+	saveToDisk(imageFileName, saveAsBMP ? BMP_IMAGE : PGM_IMAGE);
+}
+
+// `saveToDisk` method: Saves the grid as an image file (BMP, PGM or PNG).
+// With background writes the cell plane is snapshotted and encoded on the output queue.
+void  Grid::saveToDisk(char* imageFileName, ImageFormat format)
+{
+	switch (format)
 	{
-		generatePGMImage(cell, height, width, imageFileName); // Calls function to create PGM.
+	case PGM_IMAGE: queueImageSnapshot(cell, height, width, imageFileName, generatePGMImage); break; // Binary gray map.
+	case PNG_IMAGE: queueImageSnapshot(cell, height, width, imageFileName, generatePNGImage); break; // Palette PNG.
+	default: queueImageSnapshot(cell, height, width, imageFileName, generateBitmapImage); break;     // BMP.
 	}
 }
 
@@ -1240,14 +1395,20 @@ void  Grid::saveToDisk(char* path, char* imageFileName, bool saveAsBMP)
 
 // Destructor for the Grid class: Frees all dynamically allocated memory.
 Grid::~Grid() {
-	delete[] start;         // Frees memory for `start` (and `cell`).
-	delete[] ingadients;     // Frees memory for `ingadients`.
-	delete[] visited;        // Frees memory for `visited`.
-	delete[] clusterVisited; // Frees memory for `clusterVisited`.
-	delete[] cluster;        // Frees memory for `cluster`.
-
-	Clusters.~vector();       // Explicitly calls the destructor for `Clusters` vector.
-	cMaxClusterRadius.~vector(); // Explicitly calls the destructor for `cMaxClusterRadius` vector.
+	// The planes are allocated with malloc (or mapped) in the constructor, so they are released with free (or unmapped).
+	// The member vectors (`Clusters`, `cMaxClusterRadius`) are destroyed automatically.
+#ifdef GRID_HAS_MMAP
+	if (planesStorage != HEAP)
+		munmap(planes, 5 * planeBytes); // All five planes live in one mapping
+	else
+#endif
+	{
+		free(start);          // Frees memory for `start` (and `cell`).
+		free(ingadients);     // Frees memory for `ingadients`.
+		free(visited);        // Frees memory for `visited`.
+		free(clusterVisited); // Frees memory for `clusterVisited`.
+		free(cluster);        // Frees memory for `cluster`.
+	}
 
 	start = 0; // Sets pointers to null to prevent dangling pointers.
 	end = 0;   // Sets pointers to null.
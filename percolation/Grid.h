@@ -111,10 +111,24 @@ public:
 	unsigned char* ingadients; // Likely stores gradient information or similar visual data.
 	bool* visited;         // Boolean array to keep track of visited cells during traversals (e.g., BFS, DFS).
 	bool* clusterVisited;  // Boolean array to keep track of visited cells during cluster identification.
+	bool periodic = false; // Periodic (torus) boundaries: particles wrap around, paths wrap in x, clusters wrap in x and y.
+
+	// Backing store of the planes. The static members select the store of grids created from now on;
+	// mapped planes are released page-wise by `clear` instead of being rewritten.
+	static GridStorage storage;          // Store for new grids (HEAP by default).
+	static std::string backingDirectory; // Directory of the temporary files of FILE_MAP grids.
+	GridStorage planesStorage = HEAP;    // Store actually used by this grid (HEAP if mapping failed).
+	char* planes = NULL;                 // Start of the mapping holding all five planes.
+	size_t planeBytes = 0;               // Bytes per plane in the mapping (page aligned).
 
 	// Constructor: Initializes a Grid object with specified width and height.
 	Grid(int x, int y);
 
+	// Maps the five planes in one region (anonymous or file backed). Returns false if mapping is not possible.
+	bool mapPlanes(void);
+	// Releases the pages of a mapped region so they read back as zero. Returns false if not supported.
+	bool releasePages(void* from, size_t bytes);
+
 	// Clears the grid, resetting all cell states or visited flags.
 	void clear(void);
 	//double VerticalYoungModulus[maxDimension]; // Potentially for storing Young's Modulus values for vertical paths.
@@ -150,6 +164,11 @@ public:
 	iPoint toLocaldimensionsDown(double x, double y);
 	// Converts a rectangle defined by two points (x1, y1, x2, y2) to a grid `Range`.
 	Range fromRectangleToRange(double x1, double y1, double x2, double y2);
+	// Clamps a drawing region to the grid, or limits it to one period when the grid is periodic.
+	void clipRegion(Range* region);
+	// Maps (x, y) back into the grid when it is periodic (y only if `wrapY`).
+	// Returns false if the point is outside the grid after mapping.
+	bool wrap(int* x, int* y, bool wrapY);
 
 	// Shape checking methods:
 
@@ -236,6 +255,8 @@ public:
 	void show() const;
 	// Saves the current grid state to a disk file.
 	void saveToDisk(char* imageFileName, bool saveAsBMP);
+	// Saves the current grid state to a disk file in the given image format.
+	void saveToDisk(char* imageFileName, ImageFormat format);
 	// Saves the current grid state to a disk file at a specified path.
 	void saveToDisk(char* path, char* imageFileName, bool saveAsBMP);
 
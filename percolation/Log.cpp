@@ -0,0 +1,78 @@
+/*
+This file is part of Electric,Thermal, Mechanical Properties
+Estimation With Percolation Theory (ETMPEWPT) (2D version) program.
+
+Created from Eleftherios Lamprou lef27064@otenet.gr during PhD thesis (2017-2024)
+
+ETMPEWPT is free software : you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+ETMPEWPT is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Foobar.If not, see < https://www.gnu.org/licenses/>.
+
+Theory of this is published in two papers:
+1. E. Lambrou and L. N. Gergidis, A computational method for calculating the electrical and thermal properties of random composite ,
+Physica A: Statistical Mechanics and its Applications, Volume 642, 2024, 129760, ISSN 0378-4371,
+https://doi.org/10.1016/j.physa.2024.129760
+2. E. Lambrou and L. N. Gergidis, A particle digitization-based computational method for continuum percolation, Physica A: Statistical Mechanics
+and its Applications, vol. 590, p. 126738, 2022
+
+if you use this programm and write a paper or report please cite above papers
+
+*/
+
+#include "Log.h"
+#include <iostream>
+#include <mutex>
+#include <algorithm>  // std::transform
+#include <cctype>     // std::tolower
+
+LogLevel logLevel = INFO_LOG;
+
+static std::mutex logLock; // One message at a time on the console
+
+void logWrite(LogLevel level, const std::string& message)
+{
+	std::lock_guard<std::mutex> guard(logLock);
+	if (level == ERROR_LOG)
+		std::cout << "Error: ";
+	else if (level == WARNING_LOG)
+		std::cout << "Warning: ";
+	std::cout << message;
+}
+
+bool parseLogLevel(const std::string& value, LogLevel* level)
+{
+	static const char* names[] = { "error", "warning", "info", "detail", "debug" };
+	std::string name = value;
+	std::transform(name.begin(), name.end(), name.begin(), [](unsigned char c) { return (char)std::tolower(c); });
+	for (int i = ERROR_LOG; i <= DEBUG_LOG; i++)
+		if (name == names[i])
+		{
+			*level = (LogLevel)i;
+			return true;
+		}
+	return false;
+}
+
+LogRate::LogRate(double seconds)
+	: interval(std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(seconds))),
+	next(std::chrono::steady_clock::time_point::min())
+{
+}
+
+bool LogRate::ready(void)
+{
+	std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+	if (now < next)
+		return false;
+	next = now + interval;
+	return true;
+}
@@ -0,0 +1,96 @@
+/*
+This file is part of Electric,Thermal, Mechanical Properties
+Estimation With Percolation Theory (ETMPEWPT) (2D version) program.
+
+Created from Eleftherios Lamprou lef27064@otenet.gr during PhD thesis (2017-2024)
+
+ETMPEWPT is free software : you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+ETMPEWPT is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Foobar.If not, see < https://www.gnu.org/licenses/>.
+
+Theory of this is published in two papers:
+1. E. Lambrou and L. N. Gergidis, A computational method for calculating the electrical and thermal properties of random composite ,
+Physica A: Statistical Mechanics and its Applications, Volume 642, 2024, 129760, ISSN 0378-4371,
+https://doi.org/10.1016/j.physa.2024.129760
+2. E. Lambrou and L. N. Gergidis, A particle digitization-based computational method for continuum percolation, Physica A: Statistical Mechanics
+and its Applications, vol. 590, p. 126738, 2022
+
+if you use this programm and write a paper or report please cite above papers
+
+*/
+
+#pragma once // Ensures this header file is included only once in a compilation unit.
+
+#include <string>
+#include <sstream>
+#include <iostream>   // The locale of the console formats the messages.
+#include <chrono>
+
+// Console output of the runs, by level. A message is formatted only when its level is enabled,
+// and it is written as one block under a lock, so concurrent runs do not interleave their lines.
+// The debug level is compiled only with PERC_DEBUG_LOG defined; otherwise LOG_DEBUG is stripped.
+// Loops log progress through a LogRate, so they never write more often than its interval.
+
+enum LogLevel { ERROR_LOG, WARNING_LOG, INFO_LOG, DETAIL_LOG, DEBUG_LOG };
+
+// Most detailed level written (default INFO_LOG); set from the settings before the runs start.
+extern LogLevel logLevel;
+
+// True if messages of `level` are written.
+inline bool logEnabled(LogLevel level)
+{
+	return level <= logLevel;
+}
+
+// Writes a formatted message (warnings and errors are prefixed).
+void logWrite(LogLevel level, const std::string& message);
+
+// Level of a settings value: ERROR, WARNING, INFO, DETAIL or DEBUG (any case). False (level unchanged) if unknown.
+bool parseLogLevel(const std::string& value, LogLevel* level);
+
+// Lets a message through at most once per interval (the first one always). One per loop, not shared by threads.
+class LogRate {
+	std::chrono::steady_clock::duration interval;
+	std::chrono::steady_clock::time_point next;
+public:
+	explicit LogRate(double seconds);
+	// True if the interval has passed since the last message let through.
+	bool ready(void);
+};
+
+// Stream formatted message of `level`, e.g. LOG(INFO_LOG, "Case " << i << "\n").
+#define LOG(level, message) \
+	do { \
+		if (logEnabled(level)) { \
+			std::ostringstream logText_; \
+			logText_.imbue(std::cout.getloc()); \
+			logText_ << message; \
+			logWrite(level, logText_.str()); \
+		} \
+	} while (0)
+
+// Message of `level` let through by LogRate `rate` (its clock is read only when the level is enabled).
+#define LOG_EVERY(level, rate, message) \
+	do { \
+		if (logEnabled(level) && (rate).ready()) \
+			LOG(level, message); \
+	} while (0)
+
+#define LOG_ERROR(message) LOG(ERROR_LOG, message)
+#define LOG_WARNING(message) LOG(WARNING_LOG, message)
+#define LOG_INFO(message) LOG(INFO_LOG, message)
+#define LOG_DETAIL(message) LOG(DETAIL_LOG, message)
+#ifdef PERC_DEBUG_LOG
+#define LOG_DEBUG(message) LOG(DEBUG_LOG, message)
+#else
+#define LOG_DEBUG(message) do { } while (0)
+#endif
@@ -0,0 +1,152 @@
+/*
+This file is part of Electric,Thermal, Mechanical Properties
+Estimation With Percolation Theory (ETMPEWPT) (2D version) program.
+
+Created from Eleftherios Lamprou lef27064@otenet.gr during PhD thesis (2017-2024)
+
+ETMPEWPT is free software : you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+ETMPEWPT is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Foobar.If not, see < https://www.gnu.org/licenses/>.
+
+Theory of this is published in two papers:
+1. E. Lambrou and L. N. Gergidis, A computational method for calculating the electrical and thermal properties of random composite ,
+Physica A: Statistical Mechanics and its Applications, Volume 642, 2024, 129760, ISSN 0378-4371,
+https://doi.org/10.1016/j.physa.2024.129760
+2. E. Lambrou and L. N. Gergidis, A particle digitization-based computational method for continuum percolation, Physica A: Statistical Mechanics
+and its Applications, vol. 590, p. 126738, 2022
+
+if you use this programm and write a paper or report please cite above papers
+
+*/
+
+#include "OutputQueue.h"
+#include <stdio.h>  // fopen, fwrite, fclose.
+#include <iostream> // std::cerr.
+
+// 256 MiB of snapshots or 64 jobs in flight
+OutputQueue outputQueue(256u << 20, 64);
+
+// Writes `size` bytes to a new file, reporting (not throwing) errors: it runs on the writer thread
+static void writeWholeFile(const std::string& fileName, const void* data, size_t size)
+{
+	FILE* file = fopen(fileName.c_str(), "wb");
+	if (file == NULL)
+	{
+		std::cerr << "Error: Could not open or create file for writing: " << fileName << "\n";
+		return;
+	}
+	fwrite(data, 1, size, file);
+	if (fclose(file) != 0)
+		std::cerr << "*** Warning: Error writing at file " << fileName << " ****\n";
+}
+
+OutputQueue::OutputQueue(size_t iMaxBytes, size_t iMaxJobs) : maxBytes(iMaxBytes), maxJobs(iMaxJobs)
+{
+}
+
+OutputQueue::~OutputQueue(void)
+{
+	setEnabled(false);
+}
+
+void OutputQueue::setEnabled(bool enable)
+{
+	if (enable == enabled)
+		return;
+	if (enable)
+	{
+		stopping = false;
+		enabled = true;
+		writer = std::thread(&OutputQueue::run, this);
+		return;
+	}
+
+	// Disable: the writer empties the queue, then exits
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		stopping = true;
+	}
+	changed.notify_all();
+	writer.join();
+	enabled = false;
+}
+
+bool OutputQueue::isEnabled(void)
+{
+	return enabled;
+}
+
+void OutputQueue::run(void)
+{
+	std::unique_lock<std::mutex> guard(lock);
+	for (;;)
+	{
+		changed.wait(guard, [this] { return !jobs.empty() || stopping; });
+		if (jobs.empty()) // Stopping and nothing left
+			return;
+
+		std::function<void()> job = std::move(jobs.front());
+		size_t bytes = jobBytes.front();
+		jobs.pop_front();
+		jobBytes.pop_front();
+		busy = true;
+
+		guard.unlock();
+		job(); // The snapshot is released with the job
+		job = nullptr;
+		guard.lock();
+
+		busy = false;
+		queuedBytes -= bytes;
+		changed.notify_all(); // Room for blocked submitters, progress for flush
+	}
+}
+
+void OutputQueue::submit(std::function<void()> job, size_t bytes)
+{
+	if (!enabled)
+	{
+		job();
+		return;
+	}
+
+	std::unique_lock<std::mutex> guard(lock);
+	// Backpressure: wait for room (an empty queue takes any job)
+	changed.wait(guard, [this, bytes] {
+		return jobs.empty() || ((queuedBytes + bytes <= maxBytes) && (jobs.size() < maxJobs));
+		});
+	jobs.push_back(std::move(job));
+	jobBytes.push_back(bytes);
+	queuedBytes += bytes;
+	guard.unlock();
+	changed.notify_all();
+}
+
+void OutputQueue::writeFile(const std::string& fileName, std::string&& text)
+{
+	size_t bytes = text.size();
+	submit([fileName, text = std::move(text)]() { writeWholeFile(fileName, text.data(), text.size()); }, bytes);
+}
+
+void OutputQueue::writeFile(const std::string& fileName, std::vector<unsigned char>&& data)
+{
+	size_t bytes = data.size();
+	submit([fileName, data = std::move(data)]() { writeWholeFile(fileName, data.data(), data.size()); }, bytes);
+}
+
+void OutputQueue::flush(void)
+{
+	if (!enabled)
+		return;
+	std::unique_lock<std::mutex> guard(lock);
+	changed.wait(guard, [this] { return jobs.empty() && !busy; });
+}
@@ -0,0 +1,87 @@
+/*
+This file is part of Electric,Thermal, Mechanical Properties
+Estimation With Percolation Theory (ETMPEWPT) (2D version) program.
+
+Created from Eleftherios Lamprou lef27064@otenet.gr during PhD thesis (2017-2024)
+
+ETMPEWPT is free software : you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+ETMPEWPT is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Foobar.If not, see < https://www.gnu.org/licenses/>.
+
+Theory of this is published in two papers:
+1. E. Lambrou and L. N. Gergidis, A computational method for calculating the electrical and thermal properties of random composite ,
+Physica A: Statistical Mechanics and its Applications, Volume 642, 2024, 129760, ISSN 0378-4371,
+https://doi.org/10.1016/j.physa.2024.129760
+2. E. Lambrou and L. N. Gergidis, A particle digitization-based computational method for continuum percolation, Physica A: Statistical Mechanics
+and its Applications, vol. 590, p. 126738, 2022
+
+if you use this programm and write a paper or report please cite above papers
+
+*/
+
+#pragma once // Ensures this header file is included only once in a compilation unit.
+
+#include <string>             // File names and text outputs.
+#include <vector>             // Binary outputs.
+#include <deque>              // The queue of pending jobs.
+#include <functional>         // Jobs are std::function<void()>.
+#include <thread>             // The writer thread.
+#include <mutex>
+#include <condition_variable>
+
+// Definition of the OutputQueue class: a bounded queue of output jobs (image encodes, file writes)
+// run in order by one background writer thread, so that the compute threads go on with the next
+// realization while the previous outputs are written. Every job owns its data: callers hand over a
+// snapshot (a copy of the grid plane, the formatted text of a report) and never touch it again.
+// When the queued snapshots exceed `maxBytes` or `maxJobs`, submit() blocks until the writer
+// catches up (backpressure). When disabled, jobs run at once on the calling thread.
+class OutputQueue {
+	std::deque<std::function<void()>> jobs; // Pending jobs, oldest first.
+	std::deque<size_t> jobBytes;            // Snapshot bytes of every pending job.
+	size_t queuedBytes = 0;                 // Sum of jobBytes.
+	bool busy = false;                      // The writer is running a job.
+	bool stopping = false;                  // The writer exits once the queue is empty.
+	bool enabled = false;                   // Jobs go to the writer thread (else they run at once).
+	std::thread writer;
+	std::mutex lock;
+	std::condition_variable changed;        // Signals new jobs, finished jobs and stop.
+
+	// Body of the writer thread.
+	void run(void);
+
+public:
+	size_t maxBytes;  // Snapshot bytes allowed in the queue (a larger job still goes in when the queue is empty).
+	size_t maxJobs;   // Jobs allowed in the queue.
+
+	// Constructor: the queue starts disabled.
+	OutputQueue(size_t iMaxBytes, size_t iMaxJobs);
+	// Destructor: writes everything still queued and stops the writer.
+	~OutputQueue(void);
+
+	// Enables (starts the writer) or disables (after a flush) the background writes.
+	void setEnabled(bool enable);
+	// True when jobs are run by the writer thread.
+	bool isEnabled(void);
+
+	// Queues a job owning `bytes` of snapshot memory; blocks while the queue is full.
+	void submit(std::function<void()> job, size_t bytes);
+	// Queues the write of a whole text file.
+	void writeFile(const std::string& fileName, std::string&& text);
+	// Queues the write of a whole binary file.
+	void writeFile(const std::string& fileName, std::vector<unsigned char>&& data);
+
+	// Waits until every queued job has finished.
+	void flush(void);
+};
+
+// The output queue of the program (images, shapes files and reports of all runs).
+extern OutputQueue outputQueue;
@@ -0,0 +1,153 @@
+/*
+This file is part of Electric,Thermal, Mechanical Properties
+Estimation With Percolation Theory (ETMPEWPT) (2D version) program.
+
+Created from Eleftherios Lamprou lef27064@otenet.gr during PhD thesis (2017-2024)
+
+ETMPEWPT is free software : you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+ETMPEWPT is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Foobar.If not, see < https://www.gnu.org/licenses/>.
+
+Theory of this is published in two papers:
+1. E. Lambrou and L. N. Gergidis, A computational method for calculating the electrical and thermal properties of random composite ,
+Physica A: Statistical Mechanics and its Applications, Volume 642, 2024, 129760, ISSN 0378-4371,
+https://doi.org/10.1016/j.physa.2024.129760
+2. E. Lambrou and L. N. Gergidis, A particle digitization-based computational method for continuum percolation, Physica A: Statistical Mechanics
+and its Applications, vol. 590, p. 126738, 2022
+
+if you use this programm and write a paper or report please cite above papers
+
+*/
+
+#include "PerfCounters.h"
+#include <cstring>    // strerror.
+#include <fstream>    // perf_event_paranoid.
+#ifdef __linux__
+#include <errno.h>
+#include <unistd.h>   // syscall, read, close.
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#endif
+
+const char* perfEventNames[PERF_EVENTS] = { "cycles", "instructions", "llcMisses" };
+
+const char* cgSectionNames[CG_SECTIONS] = { "prod", "dot", "update" };
+
+PerfCounters::PerfCounters(void)
+{
+	for (int e = 0; e < PERF_EVENTS; e++)
+		fds[e] = -1;
+#ifdef __linux__
+	const uint32_t types[PERF_EVENTS] = { PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE };
+	const uint64_t configs[PERF_EVENTS] = { PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS, PERF_COUNT_HW_CACHE_MISSES };
+
+	for (int e = 0; e < PERF_EVENTS; e++)
+	{
+		perf_event_attr attr;
+		memset(&attr, 0, sizeof(attr));
+		attr.size = sizeof(attr);
+		attr.type = types[e];
+		attr.config = configs[e];
+		attr.disabled = (e == 0);   // The group starts with its leader
+		attr.exclude_kernel = 1;    // User space only: allowed up to perf_event_paranoid 2
+		attr.exclude_hv = 1;
+		attr.read_format = PERF_FORMAT_GROUP;
+		fds[e] = (int)syscall(SYS_perf_event_open, &attr, 0, -1, (e == 0) ? -1 : fds[0], 0);
+		if (fds[e] < 0)
+		{
+			state = std::string("perf_event_open (") + perfEventNames[e] + "): " + strerror(errno);
+			std::ifstream paranoid("/proc/sys/kernel/perf_event_paranoid");
+			int level;
+			if (paranoid >> level)
+				state += ", perf_event_paranoid = " + std::to_string(level);
+			for (int k = 0; k <= e; k++)
+				if (fds[k] >= 0)
+					close(fds[k]);
+			for (int k = 0; k < PERF_EVENTS; k++)
+				fds[k] = -1;
+			return;
+		}
+	}
+	ioctl(fds[0], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+	ioctl(fds[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+	available = true;
+	state = "counting";
+#else
+	state = "hardware counters need Linux perf_event_open";
+#endif
+}
+
+PerfCounters::~PerfCounters(void)
+{
+#ifdef __linux__
+	for (int e = PERF_EVENTS - 1; e >= 0; e--)
+		if (fds[e] >= 0)
+			close(fds[e]);
+#endif
+}
+
+bool PerfCounters::read(uint64_t values[PERF_EVENTS])
+{
+#ifdef __linux__
+	if (available)
+	{
+		uint64_t group[1 + PERF_EVENTS]; // Number of events, then their values
+		if ((::read(fds[0], group, sizeof(group)) == (ssize_t)sizeof(group)) && (group[0] == PERF_EVENTS))
+		{
+			for (int e = 0; e < PERF_EVENTS; e++)
+				values[e] = group[1 + e];
+			return true;
+		}
+	}
+#endif
+	for (int e = 0; e < PERF_EVENTS; e++)
+		values[e] = 0;
+	return false;
+}
+
+double CgProfile::cycleBytes(void) const
+{
+	double bytes = 0;
+	for (int s = 0; s < CG_SECTIONS; s++)
+		bytes += modelBytes[s];
+	return bytes;
+}
+
+double CgProfile::cycleFlops(void) const
+{
+	double flops = 0;
+	for (int s = 0; s < CG_SECTIONS; s++)
+		flops += modelFlops[s];
+	return flops;
+}
+
+CgSectionTimer::CgSectionTimer(CgProfile* iProfile, CgSection iSection) : profile(iProfile), section(iSection)
+{
+	if (profile == NULL)
+		return;
+	if (profile->counters != NULL)
+		profile->counters->read(startEvents);
+	start = std::chrono::steady_clock::now();
+}
+
+CgSectionTimer::~CgSectionTimer(void)
+{
+	if (profile == NULL)
+		return;
+	profile->wall[section] += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	uint64_t endEvents[PERF_EVENTS];
+	if ((profile->counters != NULL) && profile->counters->read(endEvents))
+		for (int e = 0; e < PERF_EVENTS; e++)
+			profile->events[section][e] += endEvents[e] - startEvents[e];
+	profile->calls[section]++;
+}
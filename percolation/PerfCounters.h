@@ -0,0 +1,113 @@
+/*
+This file is part of Electric,Thermal, Mechanical Properties
+Estimation With Percolation Theory (ETMPEWPT) (2D version) program.
+
+Created from Eleftherios Lamprou lef27064@otenet.gr during PhD thesis (2017-2024)
+
+ETMPEWPT is free software : you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+ETMPEWPT is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Foobar.If not, see < https://www.gnu.org/licenses/>.
+
+Theory of this is published in two papers:
+1. E. Lambrou and L. N. Gergidis, A computational method for calculating the electrical and thermal properties of random composite ,
+Physica A: Statistical Mechanics and its Applications, Volume 642, 2024, 129760, ISSN 0378-4371,
+https://doi.org/10.1016/j.physa.2024.129760
+2. E. Lambrou and L. N. Gergidis, A particle digitization-based computational method for continuum percolation, Physica A: Statistical Mechanics
+and its Applications, vol. 590, p. 126738, 2022
+
+if you use this programm and write a paper or report please cite above papers
+
+*/
+
+#pragma once // Ensures this header file is included only once in a compilation unit.
+
+#include <stdint.h>  // Counter values.
+#include <chrono>    // steady_clock, the wall clock of the sections.
+#include <string>
+
+// Hardware counters and roofline data of the FDM conjugate gradient solve (FD2DEL::dembx).
+// Counters are read with Linux perf_event_open, user space only and for the calling thread, so they
+// work without root when /proc/sys/kernel/perf_event_paranoid is 2 or less. Where they cannot be
+// opened (other systems, paranoid 3, containers without the syscall) only the timers are kept.
+
+// Hardware events counted as one group.
+enum PerfEvent {
+	CYCLES_EVENT,       // CPU cycles
+	INSTRUCTIONS_EVENT, // Retired instructions
+	LLC_MISSES_EVENT,   // Last level cache misses (each one a cache line from memory)
+	PERF_EVENTS         // Number of events
+};
+
+// Names of the events (benchmark output).
+extern const char* perfEventNames[PERF_EVENTS];
+
+// Bytes moved from memory per last level cache miss.
+const int cacheLineBytes = 64;
+
+// Sections of a CG cycle.
+enum CgSection {
+	CG_PROD_SECTION,   // prod: A * h over all sites
+	CG_DOT_SECTION,    // Dot products gg and hAh over the real sites
+	CG_UPDATE_SECTION, // Updates of the direction h and of the voltage and gradient vectors
+	CG_SECTIONS        // Number of sections
+};
+
+// Names of the sections (benchmark output).
+extern const char* cgSectionNames[CG_SECTIONS];
+
+// Counter group of the calling thread.
+class PerfCounters {
+	int fds[PERF_EVENTS];
+	bool available = false;
+	std::string state; // Why the counters are not available
+
+public:
+	PerfCounters(void);
+	~PerfCounters(void);
+	PerfCounters(const PerfCounters&) = delete;
+	PerfCounters& operator=(const PerfCounters&) = delete;
+
+	bool isAvailable(void) const { return available; };
+	// "counting", or why the counters could not be opened.
+	const std::string& status(void) const { return state; };
+	// Reads the current values of all events. Returns false if the counters are not available.
+	bool read(uint64_t values[PERF_EVENTS]);
+};
+
+// Time, counters and analytic traffic of the sections of one CG solve. Attached to FD2DEL::profile,
+// it is filled by dembx, which also sets the model from the grid. Events are counted only if
+// `counters` points to the (available) counters of the solving thread. A CG cycle calls prod once, so
+// per cycle figures are totals divided by the calls of the prod section.
+struct CgProfile {
+	PerfCounters* counters = NULL;
+	double wall[CG_SECTIONS] = {};
+	uint64_t events[CG_SECTIONS][PERF_EVENTS] = {};
+	uint32_t calls[CG_SECTIONS] = {};
+	double modelBytes[CG_SECTIONS] = {};  // Bytes a CG cycle streams in the section, every array read or written once
+	double modelFlops[CG_SECTIONS] = {};  // Floating point operations of a CG cycle in the section
+
+	// Model bytes and flops of a whole CG cycle.
+	double cycleBytes(void) const;
+	double cycleFlops(void) const;
+};
+
+// Times its scope as one call of a CG section (no-op without a profile).
+class CgSectionTimer {
+	CgProfile* profile;
+	CgSection section;
+	std::chrono::steady_clock::time_point start;
+	uint64_t startEvents[PERF_EVENTS];
+
+public:
+	CgSectionTimer(CgProfile* iProfile, CgSection iSection);
+	~CgSectionTimer(void);
+};
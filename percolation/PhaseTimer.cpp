@@ -0,0 +1,89 @@
+/*
+This file is part of Electric,Thermal, Mechanical Properties
+Estimation With Percolation Theory (ETMPEWPT) (2D version) program.
+
+Created from Eleftherios Lamprou lef27064@otenet.gr during PhD thesis (2017-2024)
+
+ETMPEWPT is free software : you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+ETMPEWPT is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Foobar.If not, see < https://www.gnu.org/licenses/>.
+
+Theory of this is published in two papers:
+1. E. Lambrou and L. N. Gergidis, A computational method for calculating the electrical and thermal properties of random composite ,
+Physica A: Statistical Mechanics and its Applications, Volume 642, 2024, 129760, ISSN 0378-4371,
+https://doi.org/10.1016/j.physa.2024.129760
+2. E. Lambrou and L. N. Gergidis, A particle digitization-based computational method for continuum percolation, Physica A: Statistical Mechanics
+and its Applications, vol. 590, p. 126738, 2022
+
+if you use this programm and write a paper or report please cite above papers
+
+*/
+
+#include "PhaseTimer.h"
+#include <math.h>     // log10.
+#ifdef _WIN32
+#include <windows.h>  // GetProcessTimes.
+#else
+#include <time.h>     // clock_gettime.
+#endif
+
+const char* timerPhaseNames[TIMER_PHASES] = { "clear", "placement", "rasterize", "percolate", "dfs", "bfs",
+	"pathProperties", "clusters", "fdmBond", "fdmCG", "imageSave" };
+
+const char* phaseHistogramLabels[phaseHistogramBins] = { "<10us", "<100us", "<1ms", "<10ms", "<100ms", "<1s", "<10s", "<100s", ">=100s" };
+
+static thread_local PhaseTimes* attachedTimes = NULL; // Record of the realization run by this thread
+
+double processCpuSeconds(void)
+{
+#ifdef _WIN32
+	FILETIME creation, exit, kernel, user;
+	if (!GetProcessTimes(GetCurrentProcess(), &creation, &exit, &kernel, &user))
+		return 0;
+	ULARGE_INTEGER k, u;
+	k.LowPart = kernel.dwLowDateTime;
+	k.HighPart = kernel.dwHighDateTime;
+	u.LowPart = user.dwLowDateTime;
+	u.HighPart = user.dwHighDateTime;
+	return (double)(k.QuadPart + u.QuadPart) * 1e-7; // 100 ns units
+#else
+	timespec now;
+	if (clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &now) != 0)
+		return 0;
+	return (double)now.tv_sec + 1e-9 * (double)now.tv_nsec;
+#endif
+}
+
+PhaseTimes* attachPhaseTimes(PhaseTimes* times)
+{
+	PhaseTimes* previous = attachedTimes;
+	attachedTimes = times;
+	return previous;
+}
+
+ScopedTimer::~ScopedTimer(void)
+{
+	if (attachedTimes == NULL)
+		return;
+	attachedTimes->wall[phase] += elapsed();
+	if (cpuStart >= 0)
+		attachedTimes->cpu[phase] += processCpuSeconds() - cpuStart;
+	attachedTimes->calls[phase]++;
+}
+
+int phaseHistogramBin(double seconds)
+{
+	if (seconds < 1e-5)
+		return 0;
+	int bin = (int)floor(log10(seconds)) + 6; // 1e-5 .. 1e-4 -> 1
+	return (bin < phaseHistogramBins) ? bin : phaseHistogramBins - 1;
+}
@@ -0,0 +1,104 @@
+/*
+This file is part of Electric,Thermal, Mechanical Properties
+Estimation With Percolation Theory (ETMPEWPT) (2D version) program.
+
+Created from Eleftherios Lamprou lef27064@otenet.gr during PhD thesis (2017-2024)
+
+ETMPEWPT is free software : you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+ETMPEWPT is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Foobar.If not, see < https://www.gnu.org/licenses/>.
+
+Theory of this is published in two papers:
+1. E. Lambrou and L. N. Gergidis, A computational method for calculating the electrical and thermal properties of random composite ,
+Physica A: Statistical Mechanics and its Applications, Volume 642, 2024, 129760, ISSN 0378-4371,
+https://doi.org/10.1016/j.physa.2024.129760
+2. E. Lambrou and L. N. Gergidis, A particle digitization-based computational method for continuum percolation, Physica A: Statistical Mechanics
+and its Applications, vol. 590, p. 126738, 2022
+
+if you use this programm and write a paper or report please cite above papers
+
+*/
+
+#pragma once // Ensures this header file is included only once in a compilation unit.
+
+#include <stdint.h>  // Call counters.
+#include <chrono>    // steady_clock, the wall clock of the timers.
+#include <string>
+#include <vector>
+
+// Per phase timing of a realization. A ScopedTimer measures the wall time (steady_clock) and the
+// process CPU time of its scope and adds them to the PhaseTimes attached to the calling thread,
+// so the phases timed inside Grid, FD2DEL or image code land in the record of the realization
+// that runs them. Threads without attached times (OpenMP workers) only measure.
+// Phases nest: percolate includes DFS, BFS and path properties; placement includes rasterize.
+// CPU time is that of the whole process (all OpenMP threads, and other inputs running at the
+// same time), so CPU / wall shows how many cores a phase kept busy.
+
+enum TimerPhase {
+	CLEAR_PHASE,           // Grid clear before a realization
+	PLACEMENT_PHASE,       // Particle (or lattice site) generation, including rasterize
+	RASTERIZE_PHASE,       // Digitization of the particles on the grid
+	PERCOLATE_PHASE,       // Percolation check (with path properties when enabled)
+	DFS_PHASE,             // Depth first searches from the first row
+	BFS_PHASE,             // Breadth first searches of the shortest paths
+	PATH_PROPERTIES_PHASE, // Electric, thermal and mechanical properties along the paths
+	CLUSTERS_PHASE,        // Cluster statistics and correlation length
+	FDM_BOND_PHASE,        // FDM phase map, volume fractions and bond conductances
+	FDM_CG_PHASE,          // FDM conjugate gradient solve
+	IMAGE_SAVE_PHASE,      // Image snapshots (encode and write, or their submission to the output queue)
+	TIMER_PHASES           // Number of phases
+};
+
+// Names of the phases (report and results file columns).
+extern const char* timerPhaseNames[TIMER_PHASES];
+
+// Wall and CPU seconds, and calls, of every phase of one realization.
+struct PhaseTimes {
+	double wall[TIMER_PHASES];
+	double cpu[TIMER_PHASES];
+	uint32_t calls[TIMER_PHASES];
+};
+
+// CPU seconds used by the process so far.
+double processCpuSeconds(void);
+
+// Attaches the record the timers of the calling thread add to (NULL: none). Returns the previous one.
+PhaseTimes* attachPhaseTimes(PhaseTimes* times);
+
+// Wall time since construction.
+class WallTimer {
+	std::chrono::steady_clock::time_point start;
+
+public:
+	WallTimer(void) : start(std::chrono::steady_clock::now()) {};
+	// Seconds since construction.
+	double elapsed(void) const
+	{
+		return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	};
+};
+
+// Times its scope as one call of a phase. Without `withCpu` only the wall time is taken (for
+// short scopes timed very often, where reading the process CPU time would cost more than the work).
+class ScopedTimer : public WallTimer {
+	TimerPhase phase;
+	double cpuStart;
+
+public:
+	explicit ScopedTimer(TimerPhase iPhase, bool withCpu = true) : phase(iPhase), cpuStart(withCpu ? processCpuSeconds() : -1) {};
+	~ScopedTimer(void);
+};
+
+// Histogram of the per realization wall times of every phase, in decades from 10 us to 100 s.
+const int phaseHistogramBins = 9;
+extern const char* phaseHistogramLabels[phaseHistogramBins];
+int phaseHistogramBin(double seconds);
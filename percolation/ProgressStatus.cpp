@@ -0,0 +1,258 @@
+/*
+This file is part of Electric,Thermal, Mechanical Properties
+Estimation With Percolation Theory (ETMPEWPT) (2D version) program.
+
+Created from Eleftherios Lamprou lef27064@otenet.gr during PhD thesis (2017-2024)
+
+ETMPEWPT is free software : you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+ETMPEWPT is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Foobar.If not, see < https://www.gnu.org/licenses/>.
+
+Theory of this is published in two papers:
+1. E. Lambrou and L. N. Gergidis, A computational method for calculating the electrical and thermal properties of random composite ,
+Physica A: Statistical Mechanics and its Applications, Volume 642, 2024, 129760, ISSN 0378-4371,
+https://doi.org/10.1016/j.physa.2024.129760
+2. E. Lambrou and L. N. Gergidis, A particle digitization-based computational method for continuum percolation, Physica A: Statistical Mechanics
+and its Applications, vol. 590, p. 126738, 2022
+
+if you use this programm and write a paper or report please cite above papers
+
+*/
+
+#include "ProgressStatus.h"
+#include <cmath>      // log10.
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <filesystem> // Atomic replace of the status file.
+#include <system_error>
+#include "general.h"  // NowToString, residentMemory, availableMemory.
+#ifdef _WIN32
+#include <process.h>  // _getpid.
+#define getpid _getpid
+#else
+#include <unistd.h>   // getpid.
+#endif
+
+ProgressStatus progressStatus;
+
+static thread_local JobProgress* attachedJob = NULL; // Run of this thread
+
+// Quotes a string for JSON.
+static std::string jsonString(const std::string& text)
+{
+	std::string quoted = "\"";
+	for (char c : text)
+	{
+		if ((c == '"') || (c == '\\'))
+			quoted += '\\';
+		if ((unsigned char)c < 0x20)
+			continue;
+		quoted += c;
+	}
+	return quoted + "\"";
+}
+
+// A number for JSON (no inf or nan).
+static std::string jsonNumber(double value)
+{
+	if (!std::isfinite(value))
+		return "null";
+	std::ostringstream s;
+	s << std::setprecision(6) << value;
+	return s.str();
+}
+
+double JobProgress::seconds(void) const
+{
+	return std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+}
+
+ProgressStatus::~ProgressStatus(void)
+{
+	stop();
+}
+
+void ProgressStatus::start(const std::string& iFileName, double intervalSeconds, int iInputs)
+{
+	std::lock_guard<std::mutex> guard(lock);
+	fileName = iFileName;
+	interval = intervalSeconds;
+	inputs = iInputs;
+	started = std::chrono::steady_clock::now();
+	if ((interval > 0) && !writer.joinable())
+	{
+		stopping = false;
+		writer = std::thread(&ProgressStatus::run, this);
+	}
+}
+
+void ProgressStatus::stop(void)
+{
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		if (!writer.joinable())
+			return;
+		stopping = true;
+	}
+	changed.notify_all();
+	writer.join();
+	std::lock_guard<std::mutex> guard(lock);
+	write(true);
+}
+
+void ProgressStatus::run(void)
+{
+	std::unique_lock<std::mutex> guard(lock);
+	while (!stopping)
+	{
+		write(false);
+		changed.wait_for(guard, std::chrono::duration<double>(interval), [&] { return stopping; });
+	}
+}
+
+JobProgress* ProgressStatus::addJob(const std::string& inputFile, const std::string& project, int width, int height)
+{
+	std::lock_guard<std::mutex> guard(lock);
+	jobs.emplace_back();
+	JobProgress* job = &jobs.back();
+	job->inputFile = inputFile;
+	job->project = project;
+	job->width = width;
+	job->height = height;
+	job->started = std::chrono::steady_clock::now();
+	return job;
+}
+
+void ProgressStatus::endJob(JobProgress* job)
+{
+	std::lock_guard<std::mutex> guard(lock);
+	for (auto it = jobs.begin(); it != jobs.end(); ++it)
+		if (&*it == job)
+		{
+			finishedInputs++;
+			finishedRealizations += job->completed - job->first;
+			jobs.erase(it);
+			return;
+		}
+}
+
+void ProgressStatus::write(bool finished)
+{
+	double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+	long long realizations = finishedRealizations;
+	for (JobProgress& job : jobs)
+		realizations += job.completed - job.first;
+
+	std::ostringstream s;
+	s << "{\n";
+	s << "  \"pid\": " << getpid() << ",\n";
+	s << "  \"updated\": " << jsonString(NowToString()) << ",\n";
+	s << "  \"finished\": " << (finished ? "true" : "false") << ",\n";
+	s << "  \"elapsedSeconds\": " << jsonNumber(elapsed) << ",\n";
+	s << "  \"inputs\": " << inputs << ",\n";
+	s << "  \"finishedInputs\": " << finishedInputs << ",\n";
+	s << "  \"realizations\": " << realizations << ",\n";
+	s << "  \"realizationsPerSecond\": " << jsonNumber((elapsed > 0) ? realizations / elapsed : 0) << ",\n";
+	s << "  \"residentMemoryBytes\": " << residentMemory() << ",\n";
+	s << "  \"availableMemoryBytes\": " << availableMemory() << ",\n";
+	s << "  \"runs\": [";
+	bool firstJob = true;
+	for (JobProgress& job : jobs)
+	{
+		double now = job.seconds();
+		int iterations = job.iterations;
+		int completed = job.completed;
+		double loopStart = job.loopStart;
+		double rate = ((loopStart >= 0) && (now > loopStart)) ? (completed - job.first) / (now - loopStart) : 0;
+
+		s << (firstJob ? "\n" : ",\n");
+		firstJob = false;
+		s << "    {\n";
+		s << "      \"inputFile\": " << jsonString(job.inputFile) << ",\n";
+		s << "      \"project\": " << jsonString(job.project) << ",\n";
+		s << "      \"grid\": [" << job.width << ", " << job.height << "],\n";
+		s << "      \"case\": " << job.currentCase + 1 << ",\n";
+		s << "      \"iterations\": " << iterations << ",\n";
+		s << "      \"completed\": " << completed << ",\n";
+		s << "      \"realizationsPerSecond\": " << jsonNumber(rate) << ",\n";
+		s << "      \"etaSeconds\": " << jsonNumber((rate > 0) ? (iterations - completed) / rate : NAN) << ",\n";
+		s << "      \"secondsSinceProgress\": " << jsonNumber(now - job.lastProgress) << ",\n";
+		int cgIteration = job.cgIteration;
+		if (cgIteration < 0)
+			s << "      \"cg\": null\n";
+		else
+		{
+			// Convergence rate in decades of the squared gradient norm per cycle, and the cycles left at that rate
+			double initial = job.cgInitialResidual, residual = job.cgResidual, target = job.cgTarget;
+			double rateDecades = ((cgIteration > 0) && (initial > 0) && (residual > 0)) ? log10(initial / residual) / cgIteration : NAN;
+			double left = ((rateDecades > 0) && (residual > target)) ? log10(residual / target) / rateDecades : NAN;
+			s << "      \"cg\": { \"iteration\": " << cgIteration << ", \"seconds\": " << jsonNumber(now - job.cgStart)
+				<< ", \"residual\": " << jsonNumber(residual) << ", \"target\": " << jsonNumber(target)
+				<< ", \"decadesPerIteration\": " << jsonNumber(rateDecades) << ", \"iterationsLeft\": " << jsonNumber(left) << " }\n";
+		}
+		s << "    }";
+	}
+	s << (firstJob ? "]\n" : "\n  ]\n");
+	s << "}\n";
+
+	std::string temporary = fileName + ".tmp";
+	{
+		std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+		if (!file)
+			return;
+		file << s.str();
+	}
+	std::error_code error;
+	std::filesystem::rename(temporary, fileName, error);
+}
+
+JobProgress* attachJobProgress(JobProgress* job)
+{
+	JobProgress* previous = attachedJob;
+	attachedJob = job;
+	return previous;
+}
+
+JobProgress* attachedJobProgress(void)
+{
+	return attachedJob;
+}
+
+void cgProgressStart(double residual, double target)
+{
+	if (attachedJob == NULL)
+		return;
+	double now = attachedJob->seconds();
+	attachedJob->cgStart = now;
+	attachedJob->cgInitialResidual = residual;
+	attachedJob->cgResidual = residual;
+	attachedJob->cgTarget = target;
+	attachedJob->lastProgress = now;
+	attachedJob->cgIteration = 0;
+}
+
+void cgProgress(int iteration, double residual)
+{
+	if (attachedJob == NULL)
+		return;
+	attachedJob->cgResidual = residual;
+	attachedJob->cgIteration = iteration;
+	attachedJob->lastProgress = attachedJob->seconds();
+}
+
+void cgProgressEnd(void)
+{
+	if (attachedJob == NULL)
+		return;
+	attachedJob->cgIteration = -1;
+}
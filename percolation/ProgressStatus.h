@@ -0,0 +1,114 @@
+/*
+This file is part of Electric,Thermal, Mechanical Properties
+Estimation With Percolation Theory (ETMPEWPT) (2D version) program.
+
+Created from Eleftherios Lamprou lef27064@otenet.gr during PhD thesis (2017-2024)
+
+ETMPEWPT is free software : you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+ETMPEWPT is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Foobar.If not, see < https://www.gnu.org/licenses/>.
+
+Theory of this is published in two papers:
+1. E. Lambrou and L. N. Gergidis, A computational method for calculating the electrical and thermal properties of random composite ,
+Physica A: Statistical Mechanics and its Applications, Volume 642, 2024, 129760, ISSN 0378-4371,
+https://doi.org/10.1016/j.physa.2024.129760
+2. E. Lambrou and L. N. Gergidis, A particle digitization-based computational method for continuum percolation, Physica A: Statistical Mechanics
+and its Applications, vol. 590, p. 126738, 2022
+
+if you use this programm and write a paper or report please cite above papers
+
+*/
+
+#pragma once // Ensures this header file is included only once in a compilation unit.
+
+#include <string>
+#include <list>
+#include <atomic>             // Progress fields are written by the runs and read by the status writer.
+#include <chrono>
+#include <thread>             // The status writer thread.
+#include <mutex>
+#include <condition_variable>
+
+// Machine readable progress of a batch for schedulers: a JSON status file, rewritten every few
+// seconds by a background thread (written to a temporary file and renamed, so readers never see
+// a partial file). It has the running inputs with their realizations/s and ETA, the CG solve in
+// progress with its convergence rate, the memory of the process, and the time since every run
+// last made progress, so stalled FDM solves can be spotted and killed.
+
+// Progress of one running input file. Updated by the thread that runs it, read by the status writer.
+struct JobProgress {
+	std::string inputFile;                 // Input file of the run
+	std::string project;                   // Project (output directory) of the run
+	int width = 0, height = 0;             // Grid of the run
+	std::chrono::steady_clock::time_point started; // Start of the run
+	std::atomic<int> iterations{ 0 };      // Realizations of the input
+	std::atomic<int> first{ 0 };           // Realizations restored from a checkpoint
+	std::atomic<int> completed{ 0 };       // Realizations finished (restored ones included)
+	std::atomic<int> currentCase{ -1 };    // Realization running (-1: none yet)
+	std::atomic<double> loopStart{ -1 };   // Seconds from start to the first new realization (-1: not yet)
+	std::atomic<double> lastProgress{ 0 }; // Seconds from start to the last realization end or CG progress
+	// CG solve of the running realization (cgIteration -1: none)
+	std::atomic<int> cgIteration{ -1 };
+	std::atomic<double> cgStart{ 0 };      // Seconds from start to the start of the solve
+	std::atomic<double> cgInitialResidual{ 0 }; // Squared norm of the first gradient
+	std::atomic<double> cgResidual{ 0 };   // Squared norm of the current gradient
+	std::atomic<double> cgTarget{ 0 };     // Squared norm that ends the solve (gtest)
+
+	// Seconds since the start of the run.
+	double seconds(void) const;
+};
+
+class ProgressStatus {
+	std::string fileName;              // Status file
+	double interval = 0;               // Seconds between rewrites (0: no status file)
+	std::list<JobProgress> jobs;       // Running inputs (list: records never move)
+	int inputs = 0;                    // Inputs of the batch
+	int finishedInputs = 0;            // Inputs whose runs have ended
+	long long finishedRealizations = 0; // New realizations of the ended runs
+	std::chrono::steady_clock::time_point started; // Start of the batch
+	bool stopping = false;
+	std::thread writer;
+	std::mutex lock;
+	std::condition_variable changed;   // Signals stop.
+
+	// Body of the writer thread.
+	void run(void);
+	// Writes the status file (lock held).
+	void write(bool finished);
+
+public:
+	~ProgressStatus(void);
+
+	// Starts rewriting `iFileName` every `intervalSeconds` (nothing if 0) for a batch of `iInputs` input files.
+	void start(const std::string& iFileName, double intervalSeconds, int iInputs);
+	// Writes the final status and stops the writer.
+	void stop(void);
+
+	// Record of a run starting now; valid until endJob.
+	JobProgress* addJob(const std::string& inputFile, const std::string& project, int width, int height);
+	// The run has ended.
+	void endJob(JobProgress* job);
+};
+
+// The progress status of the program (all runs of the batch).
+extern ProgressStatus progressStatus;
+
+// Attaches the run the calling thread works for (NULL: none). Returns the previous one.
+JobProgress* attachJobProgress(JobProgress* job);
+// The run attached to the calling thread (NULL: none).
+JobProgress* attachedJobProgress(void);
+
+// CG solve progress of the run attached to the calling thread (no-op without one): start with the
+// first gradient and the target, the residual of every cycle, and the end of the solve.
+void cgProgressStart(double residual, double target);
+void cgProgress(int iteration, double residual);
+void cgProgressEnd(void);
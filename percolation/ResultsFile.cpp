@@ -0,0 +1,245 @@
+/*
+This file is part of Electric,Thermal, Mechanical Properties
+Estimation With Percolation Theory (ETMPEWPT) (2D version) program.
+
+Created from Eleftherios Lamprou lef27064@otenet.gr during PhD thesis (2017-2024)
+
+ETMPEWPT is free software : you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+ETMPEWPT is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Foobar.If not, see < https://www.gnu.org/licenses/>.
+
+Theory of this is published in two papers:
+1. E. Lambrou and L. N. Gergidis, A computational method for calculating the electrical and thermal properties of random composite ,
+Physica A: Statistical Mechanics and its Applications, Volume 642, 2024, 129760, ISSN 0378-4371,
+https://doi.org/10.1016/j.physa.2024.129760
+2. E. Lambrou and L. N. Gergidis, A particle digitization-based computational method for continuum percolation, Physica A: Statistical Mechanics
+and its Applications, vol. 590, p. 126738, 2022
+
+if you use this programm and write a paper or report please cite above papers
+
+*/
+
+#include "ResultsFile.h"
+#include <string.h>  // memcpy, memcmp, strncpy.
+#include <algorithm> // std::fill, std::min.
+#include <iostream>  // std::cerr.
+#include <filesystem> // Cut of unfinished records on resume.
+
+// --- ResultsWriter ---
+
+ResultsWriter::~ResultsWriter(void)
+{
+	close();
+}
+
+void ResultsWriter::clearColumns(void)
+{
+	columns.clear();
+}
+
+void ResultsWriter::addColumn(const std::string& name, char type)
+{
+	ResultsColumn column = {};
+	strncpy(column.name, name.c_str(), sizeof(column.name) - 1);
+	column.type = type;
+	columns.push_back(column);
+}
+
+bool ResultsWriter::open(const std::string& iFileName, const std::string& project, int width, int height, int pixelsPerMinimumSize, int iterations, int totalComponents)
+{
+	close();
+	fileName = iFileName;
+	file = fopen(fileName.c_str(), "wb");
+	if (file == NULL)
+	{
+		std::cerr << "Error: Could not open or create file for writing: " << fileName << "\n";
+		return false;
+	}
+
+	ResultsFileHeader header = {};
+	memcpy(header.magic, resultsFileMagic, sizeof(header.magic));
+	header.version = 1;
+	header.columns = (uint32_t)columns.size();
+	header.recordBytes = (uint32_t)(8 * columns.size());
+	header.width = width;
+	header.height = height;
+	header.pixelsPerMinimumSize = pixelsPerMinimumSize;
+	header.iterations = iterations;
+	header.totalComponents = totalComponents;
+	strncpy(header.project, project.c_str(), sizeof(header.project) - 1);
+	fwrite(&header, sizeof(header), 1, file);
+	fwrite(columns.data(), sizeof(ResultsColumn), columns.size(), file);
+	fflush(file);
+
+	record.assign(header.recordBytes, 0);
+	filled = 0;
+	return true;
+}
+
+bool ResultsWriter::resume(const std::string& iFileName, const std::string& project, int width, int height, int pixelsPerMinimumSize, int iterations, int totalComponents, int records)
+{
+	// The stored file must have been written by the same input with the same columns
+	ResultsReader stored;
+	bool exists = std::filesystem::exists(iFileName);
+	bool same = exists && stored.open(iFileName) && (stored.header.width == width) && (stored.header.height == height)
+		&& (stored.header.pixelsPerMinimumSize == pixelsPerMinimumSize) && (stored.header.iterations == iterations)
+		&& (stored.header.totalComponents == totalComponents) && (stored.columns.size() == columns.size())
+		&& (memcmp(stored.columns.data(), columns.data(), columns.size() * sizeof(ResultsColumn)) == 0);
+	if (!same)
+	{
+		if (exists)
+			std::cerr << "*** Warning: results file " << iFileName << " does not belong to this run, it is created again ****\n";
+		open(iFileName, project, width, height, pixelsPerMinimumSize, iterations, totalComponents);
+		return false;
+	}
+
+	size_t kept = std::min((size_t)records, stored.count);
+	if (kept < (size_t)records)
+		std::cerr << "*** Warning: results file " << iFileName << " holds " << kept << " of " << records << " finished realizations ****\n";
+
+	// Unfinished records are cut before new ones are appended
+	close();
+	fileName = iFileName;
+	std::error_code error;
+	std::filesystem::resize_file(fileName, sizeof(ResultsFileHeader) + columns.size() * sizeof(ResultsColumn) + kept * stored.header.recordBytes, error);
+	file = error ? NULL : fopen(fileName.c_str(), "ab");
+	if (file == NULL)
+	{
+		std::cerr << "Error: Could not reopen results file " << fileName << "\n";
+		return false;
+	}
+	record.assign(stored.header.recordBytes, 0);
+	filled = 0;
+	return kept == (size_t)records;
+}
+
+bool ResultsWriter::isOpen(void)
+{
+	return file != NULL;
+}
+
+void ResultsWriter::put(char type, const void* value)
+{
+	if ((file == NULL) || (filled >= columns.size()))
+		return;
+	if (columns[filled].type != type)
+		std::cerr << "*** Warning: results column " << columns[filled].name << " written with type " << type << " ****\n";
+	memcpy(&record[8 * filled], value, 8);
+	filled++;
+}
+
+void ResultsWriter::put(double value)
+{
+	put('d', &value);
+}
+
+void ResultsWriter::put(int64_t value)
+{
+	put('q', &value);
+}
+
+void ResultsWriter::put(uint64_t value)
+{
+	put('Q', &value);
+}
+
+void ResultsWriter::endRecord(void)
+{
+	if (file == NULL)
+		return;
+	if (filled != columns.size())
+		std::cerr << "*** Warning: results record with " << filled << " of " << columns.size() << " columns ****\n";
+	// The record is on disk before the next realization starts
+	if ((fwrite(record.data(), 1, record.size(), file) != record.size()) || (fflush(file) != 0))
+		std::cerr << "*** Warning: Error writing at results file " << fileName << " ****\n";
+	std::fill(record.begin(), record.end(), 0);
+	filled = 0;
+}
+
+void ResultsWriter::close(void)
+{
+	if (file == NULL)
+		return;
+	if (fclose(file) != 0)
+		std::cerr << "*** Warning: Error writing at results file " << fileName << " ****\n";
+	file = NULL;
+}
+
+// --- ResultsReader ---
+
+bool ResultsReader::open(const std::string& fileName)
+{
+	columns.clear();
+	records.clear();
+	count = 0;
+
+	FILE* file = fopen(fileName.c_str(), "rb");
+	if (file == NULL)
+	{
+		std::cerr << "Error: Could not open results file " << fileName << "\n";
+		return false;
+	}
+	bool valid = (fread(&header, sizeof(header), 1, file) == 1) && (memcmp(header.magic, resultsFileMagic, sizeof(header.magic)) == 0)
+		&& (header.recordBytes == 8 * header.columns);
+	if (valid)
+	{
+		columns.resize(header.columns);
+		valid = (columns.empty() || (fread(columns.data(), sizeof(ResultsColumn), columns.size(), file) == columns.size()));
+	}
+	if (!valid)
+	{
+		std::cerr << "Error: " << fileName << " is not a results file\n";
+		fclose(file);
+		return false;
+	}
+
+	// Records up to the end of the file; a cut last record is dropped
+	unsigned char buffer[1 << 16];
+	size_t got;
+	while ((got = fread(buffer, 1, sizeof(buffer), file)) > 0)
+		records.insert(records.end(), buffer, buffer + got);
+	fclose(file);
+	count = (header.recordBytes > 0) ? records.size() / header.recordBytes : 0;
+	records.resize(count * header.recordBytes);
+	return true;
+}
+
+int ResultsReader::columnIndex(const std::string& name) const
+{
+	for (size_t k = 0; k < columns.size(); k++)
+		if (name == columns[k].name)
+			return (int)k;
+	return -1;
+}
+
+double ResultsReader::value(size_t recordNo, int column) const
+{
+	const unsigned char* field = &records[recordNo * header.recordBytes + 8 * (size_t)column];
+	switch (columns[column].type)
+	{
+	case 'q': { int64_t v; memcpy(&v, field, 8); return (double)v; }
+	case 'Q': { uint64_t v; memcpy(&v, field, 8); return (double)v; }
+	default: { double v; memcpy(&v, field, 8); return v; }
+	}
+}
+
+std::vector<double> ResultsReader::column(const std::string& name) const
+{
+	std::vector<double> values;
+	int k = columnIndex(name);
+	if (k < 0)
+		return values;
+	values.reserve(count);
+	for (size_t r = 0; r < count; r++)
+		values.push_back(value(r, k));
+	return values;
+}
@@ -0,0 +1,117 @@
+/*
+This file is part of Electric,Thermal, Mechanical Properties
+Estimation With Percolation Theory (ETMPEWPT) (2D version) program.
+
+Created from Eleftherios Lamprou lef27064@otenet.gr during PhD thesis (2017-2024)
+
+ETMPEWPT is free software : you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+ETMPEWPT is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Foobar.If not, see < https://www.gnu.org/licenses/>.
+
+Theory of this is published in two papers:
+1. E. Lambrou and L. N. Gergidis, A computational method for calculating the electrical and thermal properties of random composite ,
+Physica A: Statistical Mechanics and its Applications, Volume 642, 2024, 129760, ISSN 0378-4371,
+https://doi.org/10.1016/j.physa.2024.129760
+2. E. Lambrou and L. N. Gergidis, A particle digitization-based computational method for continuum percolation, Physica A: Statistical Mechanics
+and its Applications, vol. 590, p. 126738, 2022
+
+if you use this programm and write a paper or report please cite above papers
+
+*/
+
+#pragma once // Ensures this header file is included only once in a compilation unit.
+
+#include <stdio.h>   // FILE, fopen, fwrite, fflush.
+#include <stdint.h>  // Fixed size fields of the file layout.
+#include <string>
+#include <vector>
+
+// Per realization results file: a compact header (the input and a directory of typed columns)
+// followed by one fixed size record per realization. Every column takes 8 bytes, so column k of
+// record r is at header bytes + r * recordBytes + 8 * k and a reader can stride through a column
+// (or map the file) without parsing. Records are appended and flushed as each realization ends:
+// a crash loses at most the realization that was running, and a cut record at the end is ignored.
+//
+// Layout (little-endian): ResultsFileHeader, ResultsColumn[columns], records.
+
+const char resultsFileMagic[8] = { 'P', 'E', 'R', 'C', 'R', 'E', 'S', '1' };
+
+struct ResultsFileHeader {
+	char magic[8];            // resultsFileMagic
+	uint32_t version;         // 1
+	uint32_t columns;         // Entries of the column directory.
+	uint32_t recordBytes;     // 8 * columns
+	int32_t width, height;    // Grid of the input.
+	int32_t pixelsPerMinimumSize;
+	int32_t iterations;       // Realizations planned.
+	int32_t totalComponents;
+	char project[64];         // Project name (truncated).
+};
+
+struct ResultsColumn {
+	char name[31];            // Column name (zero terminated).
+	char type;                // 'd' float64, 'q' int64, 'Q' uint64
+};
+
+// Writes a results file record by record.
+class ResultsWriter {
+	FILE* file = NULL;
+	std::string fileName;
+	std::vector<ResultsColumn> columns;   // Column directory
+	std::vector<unsigned char> record;    // Record being filled
+	size_t filled = 0;                    // Columns put in the current record
+
+	void put(char type, const void* value);
+
+public:
+	ResultsWriter(void) {};
+	~ResultsWriter(void);
+
+	// Declares the columns (before open).
+	void clearColumns(void);
+	void addColumn(const std::string& name, char type);
+
+	// Creates the file and writes the header and the column directory.
+	// Returns false if the file cannot be created.
+	bool open(const std::string& iFileName, const std::string& project, int width, int height, int pixelsPerMinimumSize, int iterations, int totalComponents);
+	// Reopens the file of an interrupted run: the first `records` records are kept, later (unfinished)
+	// ones are cut, and new records are appended. A missing file, or one of another input or with
+	// other columns, is created again as by open. Returns false if the records were not kept.
+	bool resume(const std::string& iFileName, const std::string& project, int width, int height, int pixelsPerMinimumSize, int iterations, int totalComponents, int records);
+	bool isOpen(void);
+
+	// Fills one record, column after column in declaration order, then appends and flushes it.
+	void put(double value);
+	void put(int64_t value);
+	void put(uint64_t value);
+	void endRecord(void);
+
+	void close(void);
+};
+
+// Loads a results file for aggregation.
+class ResultsReader {
+public:
+	ResultsFileHeader header = {};
+	std::vector<ResultsColumn> columns;
+	std::vector<unsigned char> records;   // All complete records
+	size_t count = 0;                     // Number of complete records
+
+	// Reads a results file. Returns false if it is not a results file.
+	bool open(const std::string& fileName);
+	// Index of a column, -1 if it is missing.
+	int columnIndex(const std::string& name) const;
+	// Value of a column of a record, converted to double.
+	double value(size_t recordNo, int column) const;
+	// All values of a column (empty if it is missing).
+	std::vector<double> column(const std::string& name) const;
+};
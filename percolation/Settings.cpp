@@ -34,10 +34,12 @@ if you use this programm and write a paper or report please cite above papers
 #include <sys/stat.h>  // System/stat.h might be included for file status checks, though not directly used in the provided logic for reading.
 #include <string>      // For `std::string` manipulation.
 #include <fstream>     // For file input operations, specifically `std::ifstream`.
+#include <sstream>     // For `std::istringstream`, used to split settings lines with several fields.
 #include <iostream>    // For input/output operations, like `std::cout` and `std::cerr`.
 #include <stdexcept>   // For exception handling, specifically `std::invalid_argument` and `std::out_of_range` used with `std::stoi`.
 #include <limits>      // For `std::numeric_limits`, though not directly used in this snippet's logic.
 #include <chrono>      // For `std::chrono` functionalities, like `std::chrono::seconds`.
+#include <cstdlib>     // For `std::strtod`, used with the fraction of the FDM backbone setting.
 #include <thread>      // For `std::this_thread::sleep_for`.
 #include <map>         // For `std::map`, although not used in the final version of the `readFromFile` method, it was likely considered.
 #include <algorithm>   // For `std::transform` and `std::tolower`, used in the `toLower` helper function.
@@ -108,6 +110,27 @@ void Settings::readFromFile(char* fileName)
             settingVar = line; // Directly assign the read line to the setting variable.
             };
 
+        // Helper lambda: readOptionalBoolSetting
+        // Like `readBoolSetting`, but settings added after version 2.0 may be missing from
+        // older settings files. In that case the default value is kept.
+        auto readOptionalBoolSetting = [&](bool& settingVar) {
+            if (readNextValidLine(inputFile, line))
+                settingVar = (toLower(line) == "true");
+            };
+
+        // Helper lambda: readOptionalIntSetting
+        // Integer counterpart of `readOptionalBoolSetting`; a missing or invalid value keeps the default.
+        auto readOptionalIntSetting = [&](int& settingVar, const char* settingName) {
+            if (!readNextValidLine(inputFile, line))
+                return;
+            try {
+                settingVar = std::stoi(line);
+            }
+            catch (const std::exception& e) {
+                std::cerr << "Warning: Invalid value for " << settingName << ": '" << line << "', default is kept. " << e.what() << "\n";
+            }
+            };
+
         // --- Read 'saveImageFile' setting ---
         // Determines whether to save image files.
         readBoolSetting(saveImageFile, "saveImageFile");
@@ -148,12 +171,141 @@ void Settings::readFromFile(char* fileName)
         // Determines if images should be saved in BMP format. It reads a string
         // and checks if it's "bmp" (case-insensitive).
         readStringSetting(line, "saveAsBmpImage_format"); // Reads the format string into 'line'.
-        saveAsBmpImage = (toLower(line) == "bmp");         // Sets `saveAsBmpImage` based on the format.
+        if (toLower(line) == "png")
+            imageFormat = PNG_IMAGE;
+        else if (toLower(line) == "bmp")
+            imageFormat = BMP_IMAGE;
+        else
+            imageFormat = PGM_IMAGE;
+        saveAsBmpImage = (imageFormat == BMP_IMAGE);      // Sets `saveAsBmpImage` based on the format.
 
         // --- Read 'isLattice' setting ---
         // Determines if the simulation uses a lattice structure.
         readBoolSetting(isLattice, "isLattice");
 
+        // --- Read 'isPeriodic' setting (optional) ---
+        // Determines if particles wrap around the domain (periodic boundaries).
+        readOptionalBoolSetting(isPeriodic);
+
+        // --- Read 'tileSize' setting (optional) ---
+        // Tile edge for resolution-study grids that are rasterized tile by tile (0: full grids).
+        readOptionalIntSetting(tileSize, "tileSize");
+
+        // --- Read 'gridStorage' setting (optional) ---
+        // HEAP (malloc), MMAP (anonymous map, huge pages) or a directory for file backed maps.
+        if (readNextValidLine(inputFile, line))
+        {
+            if (toLower(line) == "mmap")
+                gridStorage = ANONYMOUS_MAP;
+            else if (toLower(line) != "heap")
+            {
+                gridStorage = FILE_MAP;
+                gridBackingDirectory = line;
+            }
+        }
+
+        // --- Read 'concurrentJobs' setting (optional) ---
+        // Input files run at the same time (0: as many as fit in the available memory).
+        readOptionalIntSetting(concurrentJobs, "concurrentJobs");
+
+        // --- Read 'asyncOutput' setting (optional) ---
+        // Determines if images, shapes files and reports are written on a background output queue.
+        readOptionalBoolSetting(asyncOutput);
+
+        // --- Read 'shapesFormat' setting (optional) ---
+        // TEXT, BINARY (float64 columns) or BINARY32 (float32 columns), "LZ" compresses the binary file.
+        if (readNextValidLine(inputFile, line))
+        {
+            string format = toLower(line);
+            if (format.compare(0, 4, "text") == 0)
+                shapesFormat = TEXT_SHAPES;
+            else if (format.compare(0, 8, "binary32") == 0)
+                shapesFormat = BINARY32_SHAPES;
+            else
+                shapesFormat = BINARY_SHAPES;
+            compressShapes = (format.find("lz") != string::npos);
+        }
+
+        // --- Read 'replayCases' setting (optional) ---
+        // NONE (generate new realizations), ALL or a list of saved realizations to replay (e.g. 0,3,7-9).
+        if (readNextValidLine(inputFile, line))
+            replayCases = toLower(line);
+
+        // --- Read 'checkpointInterval' and 'resume' settings (optional) ---
+        // Realizations between checkpoints (0: none), "RESUME" continues interrupted runs from their checkpoints.
+        // Both come from this line: without it the defaults (no checkpoints, no resume) are kept.
+        if (readNextValidLine(inputFile, line))
+        {
+            istringstream fields(line);
+            if (!(fields >> checkpointInterval) || (checkpointInterval < 0))
+            {
+                std::cerr << "Warning: Invalid value for checkpointInterval: '" << line << "', no checkpoints are written.\n";
+                checkpointInterval = 0;
+            }
+            resume = (toLower(line).find("resume") != string::npos);
+        }
+
+        // --- Read 'statusInterval' and 'statusFile' settings (optional) ---
+        // Seconds between rewrites of the status file (0: none), optionally followed by its name.
+        if (readNextValidLine(inputFile, line))
+        {
+            istringstream fields(line);
+            if (!(fields >> statusInterval) || (statusInterval < 0))
+            {
+                std::cerr << "Warning: Invalid value for statusInterval: '" << line << "', no status file is written.\n";
+                statusInterval = 0;
+            }
+            fields >> statusFile;
+        }
+
+        // --- Read 'consoleLevel' setting (optional) ---
+        // ERROR, WARNING, INFO, DETAIL or DEBUG (debug messages need a build with PERC_DEBUG_LOG).
+        if (readNextValidLine(inputFile, line) && !parseLogLevel(line, &consoleLevel))
+            std::cerr << "Warning: Invalid value for consoleLevel: '" << line << "', default is kept.\n";
+
+        // --- Read 'fdmSolver' setting (optional) ---
+        // CG (serial conjugate gradient), BLOCK_JACOBI (row strips per thread, block-Jacobi preconditioned)
+        // AMG (serial, algebraic multigrid preconditioned) or MIXED (serial, single precision arrays).
+        if (readNextValidLine(inputFile, line))
+        {
+            if (toLower(line) == "cg")
+                fdmSolver = CG_SOLVER;
+            else if (toLower(line) == "block_jacobi")
+                fdmSolver = BLOCK_JACOBI_SOLVER;
+            else if (toLower(line) == "amg")
+                fdmSolver = AMG_SOLVER;
+            else if (toLower(line) == "mixed")
+                fdmSolver = MIXED_SOLVER;
+            else
+                std::cerr << "Warning: Invalid value for fdmSolver: '" << line << "', default is kept.\n";
+        }
+
+        // --- Read 'distribute' setting (optional) ---
+        // REALIZATIONS or INPUTS: what the ranks of an MPI run share (no effect on a single process).
+        if (readNextValidLine(inputFile, line))
+        {
+            if (toLower(line) == "realizations")
+                distribute = DISTRIBUTE_REALIZATIONS;
+            else if (toLower(line) == "inputs")
+                distribute = DISTRIBUTE_INPUTS;
+            else
+                std::cerr << "Warning: Invalid value for distribute: '" << line << "', default is kept.\n";
+        }
+
+        // --- Read 'fdmBackbone' setting (optional) ---
+        // OFF (solve the whole grid) or the fraction of the strongest bond below which bonds are open.
+        if (readNextValidLine(inputFile, line))
+        {
+            char* end = NULL;
+            double cut = std::strtod(line.c_str(), &end);
+            if (toLower(line) == "off")
+                fdmBackbone = -1.0;
+            else if ((end != line.c_str()) && (cut >= 0.0) && (cut < 1.0))
+                fdmBackbone = cut;
+            else
+                std::cerr << "Warning: Invalid value for fdmBackbone: '" << line << "', default is kept.\n";
+        }
+
         inputFile.close(); // Always close the file after reading.
     }
     else // If the file could not be opened.
@@ -36,6 +36,7 @@ if you use this programm and write a paper or report please cite above papers
 #include <fstream>     // For file stream operations (e.g., reading/writing files)
 #include <string>      // For using the `std::string` class
 #include "general.h"   // Includes a custom header file likely containing common definitions and utility functions
+#include "Log.h"       // Levels of the console output
 #include <cstring>     // For C-style string manipulation functions (e.g., `memset`)
 
 using namespace std; // Brings all names from the `std` namespace into the current scope
@@ -50,10 +51,28 @@ public:
     int totalImagesToSave;    // Total number of images to save if `RandomSaveImageFile` is true
     bool saveShapes;          // Flag to determine if generated shapes should be saved
     bool saveAsBmpImage;      // Flag to determine if images should be saved in BMP format
+    ImageFormat imageFormat;  // File format of the saved images (BMP, PGM or PNG, default BMP)
     bool isLattice;           // Flag to determine if the simulation uses a lattice structure (default to true)
+    bool isPeriodic;          // Flag for periodic (torus) boundaries: particles wrap around the domain (default false)
+    int tileSize;             // Tile edge (pixels) for lazily materialized resolution-study grids, 0 for full grids (default 0)
+    GridStorage gridStorage;  // Backing store of the grid planes: heap, anonymous map or file map (default HEAP)
+    string gridBackingDirectory; // Directory of the temporary files when `gridStorage` is FILE_MAP
+    int concurrentJobs;       // Input files run at the same time, 0 to size it by grid memory against available RAM (default 0)
+    bool asyncOutput;         // Flag to write images, shapes files and reports on a background output queue (default false)
+    ShapesFormat shapesFormat; // File format of the saved shapes: text files or one binary file per input (default BINARY)
+    bool compressShapes;      // Flag to LZ compress the binary shapes file (default true)
+    string replayCases;       // Saved realizations replayed from the project's shapes file: "none", "all" or a list like "0,3,7-9" (default "none")
+    int checkpointInterval;   // Realizations between checkpoints of an input, 0 for no checkpoints (default 0)
+    bool resume;              // Flag to continue interrupted runs from their checkpoints (default false)
+    int statusInterval;       // Seconds between rewrites of the status file, 0 for no status file (default 0)
+    string statusFile;        // Status file with progress, ETA, memory and CG convergence of the runs (default "status.json")
+    LogLevel consoleLevel;    // Most detailed console output: errors, warnings, info (progress once per second), details of every realization or debug (default INFO_LOG)
+    FdmSolver fdmSolver;      // Solver of the FDM voltage field: serial CG, row strips per thread with block-Jacobi, serial algebraic multigrid preconditioned CG or serial mixed precision CG (default BLOCK_JACOBI_SOLVER)
+    DistributeMode distribute; // What the ranks of an MPI run share: the realizations of every input or whole inputs (default DISTRIBUTE_REALIZATIONS)
+    double fdmBackbone;       // FDM of the current carrying backbone only: bonds weaker than this fraction of the strongest are open, negative for the whole grid (default -1)
 
     // Default constructor: Initializes all settings with default values
-    Settings(void) : saveImageFile(true), RandomSaveImageFile(true), totalImagesToSave(1), saveShapes(true), saveAsBmpImage(true), isLattice(true) {};
+    Settings(void) : saveImageFile(true), RandomSaveImageFile(true), totalImagesToSave(1), saveShapes(true), saveAsBmpImage(true), imageFormat(BMP_IMAGE), isLattice(true), isPeriodic(false), tileSize(0), gridStorage(HEAP), gridBackingDirectory("."), concurrentJobs(0), asyncOutput(false), shapesFormat(BINARY_SHAPES), compressShapes(true), replayCases("none"), checkpointInterval(0), resume(false), statusInterval(0), statusFile("status.json"), consoleLevel(INFO_LOG), fdmSolver(BLOCK_JACOBI_SOLVER), distribute(DISTRIBUTE_REALIZATIONS), fdmBackbone(-1.0) {};
 
     // Parameterized constructor: Allows initializing settings with custom values
     // `isaveImageFile`: initial value for `saveImageFile`
@@ -62,7 +81,7 @@ public:
     // `isaveShapes`: initial value for `saveShapes`
     Settings(bool isaveImageFile, bool iRandomSaveImageFile, int itotalImagesToSave, bool isaveShapes)
         : saveImageFile(isaveImageFile), RandomSaveImageFile(iRandomSaveImageFile),
-        totalImagesToSave(itotalImagesToSave), saveShapes(isaveShapes), saveAsBmpImage(true), isLattice(true) {
+        totalImagesToSave(itotalImagesToSave), saveShapes(isaveShapes), saveAsBmpImage(true), imageFormat(BMP_IMAGE), isLattice(true), isPeriodic(false), tileSize(0), gridStorage(HEAP), gridBackingDirectory("."), concurrentJobs(0), asyncOutput(false), shapesFormat(BINARY_SHAPES), compressShapes(true), replayCases("none"), checkpointInterval(0), resume(false), statusInterval(0), statusFile("status.json"), consoleLevel(INFO_LOG), fdmSolver(BLOCK_JACOBI_SOLVER), distribute(DISTRIBUTE_REALIZATIONS), fdmBackbone(-1.0) {
     };
 
     // Member function to read settings from a specified file
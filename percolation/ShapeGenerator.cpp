@@ -109,7 +109,7 @@ void ShapeGenerator::areaSolve(void)
 		{
 			calcComponents[i] = (componentsArea[i] * specialWeights[i]) / sum; // Calculate normalized weight
 			sumError = sumError + abs(calcComponents[i] - components[i]);    // Accumulate absolute error
-			// debug cout <<"COMPONENT["<<i<<"] Area="<< componentsArea[i] <<" Error="<< calcComponents[i] - components[i] <<"\n";
+			LOG_DEBUG("COMPONENT[" << i << "] Area=" << componentsArea[i] << " Error=" << calcComponents[i] - components[i] << "\n");
 		}
 
 		sumAreas = 0; // Reset sumAreas for each iteration
@@ -122,16 +122,19 @@ void ShapeGenerator::areaSolve(void)
 
 	} while (sumError > epsilon); // Continue until error is below epsilon
 
-	cout << "Solve from % Weights to % Area\n";
 	// Print some information about the solution
-	cout << "Component            %Area          %Weight        Estimation Error \n";
+	std::ostringstream table;
+	table.imbue(cout.getloc());
+	table << "Solve from % Weights to % Area\n";
+	table << "Component            %Area          %Weight        Estimation Error \n";
 	for (int i = 0; i < totalComponents; i++)
 	{
 		componentsArea[i] = componentsArea[i] / sumAreas; // Normalize component areas
-		cout << setw(13) << i << setw(13) << componentsArea[i] << setw(13) << components[i] << setw(25) << calcComponents[i] - components[i] << "\n";
+		table << setw(13) << i << setw(13) << componentsArea[i] << setw(13) << components[i] << setw(25) << calcComponents[i] - components[i] << "\n";
 	}
-	cout << "Total error e=" << sumError << " - Total iterations= " << iter << "\n";
-	cout << "--------------------------------------------------------------------------------------------------------------\n";
+	table << "Total error e=" << sumError << " - Total iterations= " << iter << "\n";
+	table << "--------------------------------------------------------------------------------------------------------------\n";
+	logWrite(INFO_LOG, table.str());
 }
 
 // Checks if a Point (double coordinates) is inside the grid
@@ -166,22 +169,21 @@ void ShapeGenerator::scale(Point orig, Point* scaled, double scaleX, double scal
 // It will be fixed for multi-phase (3) and above media in the future.
 void ShapeGenerator::setupCaseLattice(int caseNo, double* setUpTime)
 {
-	clock_t start = clock(); // Start timer
+	ScopedTimer timer(PLACEMENT_PHASE); // Setup time (wall)
 	int i, j;
 	double what; // Random value
 	size_t totalSites = 0; // Count of 'HARD' sites
 
-	std::random_device rd;   // Will be used to obtain a seed for the random number engine
-	std::mt19937 gen(rd());  // Standard mersenne_twister_engine seeded with rd()
 	std::uniform_real_distribution<> dis(0.000, 1.00000); // Uniform distribution for random numbers
 
+	// Sites are drawn in a fixed order from the engine seeded for this case (monteCarlo), so the
+	// seed of the results file and of the checkpoint regenerates the lattice
 	thresh = componentsArea[1]; // Threshold based on the second component's area
 	for (i = 0; i < width; i++)
 	{
-#pragma omp parallel for schedule(dynamic) // OpenMP directive for parallel processing
 		for (j = 0; j < height; j++)
 		{
-			what = dis(gen); // Generate a random number
+			what = dis(eng); // Generate a random number
 			if (what < thresh)
 			{
 				grid->set(i, j, CellState::HARD); // Set cell state to HARD
@@ -196,54 +198,59 @@ void ShapeGenerator::setupCaseLattice(int caseNo, double* setUpTime)
 		}
 	}
 
-	clock_t end = clock(); // End timer
-	*setUpTime = ((double)(end - start)) / CLOCKS_PER_SEC; // Calculate setup time
+	*setUpTime = timer.elapsed(); // Calculate setup time
 
 	// Calculate real component areas based on total sites
 	realComponentAreas[caseNo * 2 + 1] = 1.0 * totalSites / (width * height);
 	realComponentAreas[caseNo * 2] = 1.0 - realComponentAreas[caseNo * 2 + 1];
-	cout << "% Real component Area[0]=" << realComponentAreas[caseNo * 2] << "\n";
+	LOG_DETAIL("% Real component Area[0]=" << realComponentAreas[caseNo * 2] << "\n");
 }
 
-// Prints particle information for a given case
-void ShapeGenerator::printParticles(int caseNo, vector<int> totalEllipsesPerComponent, vector<int> totalCirclesPerComponent, vector<int> totalRectanglesPerComponent, vector<int> totalSlopedRectanglesPerComponent)
+// Prints particle information for a given case (detail level)
+void ShapeGenerator::printParticles(int caseNo, const vector<int>& totalEllipsesPerComponent, const vector<int>& totalCirclesPerComponent, const vector<int>& totalRectanglesPerComponent, const vector<int>& totalSlopedRectanglesPerComponent)
 {
+	if (!logEnabled(DETAIL_LOG))
+		return;
+
 	double matrixRealArea = 1.0; // Real area of the matrix component
 	int whereMatrix = 0; // Index of the matrix component
 
-	cout << "Component  |     Particle Type      | Total Praticles | Real Area in Lattice % | Goal Area % |  Error %    \n";
+	std::ostringstream table; // The table is written as one message
+	table.imbue(std::cout.getloc());
+	table << "Component  |     Particle Type      | Total Praticles | Real Area in Lattice % | Goal Area % |  Error %    \n";
 	for (int i = 0; i < totalComponents; i++)
 	{
 		if (componentsType[i] != ShapeType::NOTHING) // If it's a particle component
 		{
 			matrixRealArea = matrixRealArea - realComponentAreas[caseNo * totalComponents + i]; // Subtract particle area from matrix area
-			cout << setw(10) << i; // Print component index
+			table << setw(10) << i; // Print component index
 
 			// Print particle type and total particles based on ShapeType
 			switch (componentsType[i]) {
 			case ShapeType::SLOPEDRECTANGLE:
-				cout << setw(21) << "Sloped Rectangles" << setw(12) << totalSlopedRectanglesPerComponent[i];
+				table << setw(21) << "Sloped Rectangles" << setw(12) << totalSlopedRectanglesPerComponent[i];
 				break;
 			case ShapeType::RECTANGLE:
-				cout << setw(21) << "Rectangles" << setw(12) << totalRectanglesPerComponent[i];
+				table << setw(21) << "Rectangles" << setw(12) << totalRectanglesPerComponent[i];
 				break;
 			case ShapeType::ELLIPSE:
-				cout << setw(21) << "Ellipses" << setw(12) << totalEllipsesPerComponent[i];
+				table << setw(21) << "Ellipses" << setw(12) << totalEllipsesPerComponent[i];
 				break;
 			case ShapeType::CIRCLE:
-				cout << setw(21) << "Circles" << setw(12) << totalCirclesPerComponent[i];
+				table << setw(21) << "Circles" << setw(12) << totalCirclesPerComponent[i];
 				break;
 			}
 
 			// Print real area, goal area, and error
-			cout << setw(25) << realComponentAreas[caseNo * totalComponents + i] << setw(22) << componentsArea[i] << setw(17) << componentsArea[i] - realComponentAreas[caseNo * totalComponents + i] << "\n";
+			table << setw(25) << realComponentAreas[caseNo * totalComponents + i] << setw(22) << componentsArea[i] << setw(17) << componentsArea[i] - realComponentAreas[caseNo * totalComponents + i] << "\n";
 		}
 		else
 			whereMatrix = i; // Store index of the matrix component
 	}
 
 	// Print information for the matrix component
-	cout << setw(10) << whereMatrix << setw(21) << "Matrix" << setw(12) << "N/A" << setw(25) << matrixRealArea << setw(22) << componentsArea[whereMatrix] << setw(17) << componentsArea[whereMatrix] - matrixRealArea << "\n";
+	table << setw(10) << whereMatrix << setw(21) << "Matrix" << setw(12) << "N/A" << setw(25) << matrixRealArea << setw(22) << componentsArea[whereMatrix] << setw(17) << componentsArea[whereMatrix] - matrixRealArea << "\n";
+	logWrite(DETAIL_LOG, table.str());
 }
 
 // Sets up the simulation case, generating shapes and populating the grid
@@ -267,20 +274,19 @@ void ShapeGenerator::setupCase(int caseNo, double* setUpTime)
 	Rectangle cRectangle(Point(0, 0), Point(0, 0)); // Note: cRectangle is not used directly
 	SlopedRectangle sRectangle(Point(0, 0), 0, 0, 0);
 
-	clock_t start = clock(); // Start timer for setup time
+	ScopedTimer timer(PLACEMENT_PHASE); // Setup time (wall)
+
+	particles.clear(); // Start the realization with an empty particle store
 
 	double realComponentsArea = 0; // Accumulator for real area of all components
+	bool textShapes = settings->saveShapes && (settings->shapesFormat == TEXT_SHAPES); // Text shapes files (else the binary file of monteCarlo)
 
 	for (int i = 0; i < totalComponents; i++)
 	{
-		ofstream componentFile; // Output file stream for component data
+		ostringstream componentFile; // Component data, written as a whole on the output queue
 		string Base = "_shapes.txt"; // Base filename extension
 		string FileName = projectName + "/shapes/case_" + to_string(caseNo) + "_component_" + to_string(i) + Base; // Full filename
 
-		// Open report file if saving shapes and it's a particle component
-		if ((settings->saveShapes) && (componentsType[i] != ShapeType::NOTHING))
-			componentFile.open(FileName);
-
 		// Initialize shape counters for the current component
 		totalEllipses = 0;
 		totalCircles = 0;
@@ -297,7 +303,7 @@ void ShapeGenerator::setupCase(int caseNo, double* setUpTime)
 			double maxComp = componentsArea[i] * grid->width * grid->height;
 
 			// Print headers to the component file if saving shapes
-			if (settings->saveShapes)
+			if (textShapes)
 			{
 				componentFile << "Component " << i << " maximum area=" << componentsArea[i] << " [on " << grid->width << "x" << grid->height << "]\n";
 				switch (componentsType[i]) {
@@ -334,11 +340,13 @@ void ShapeGenerator::setupCase(int caseNo, double* setUpTime)
 					sRectangle = addOneSlopedRectangle(caseNo, i, size, &totalRectangles, &totalSlopedRectangles, &totalEllipses, &totalCircles, &hoop);
 
 					// Save information to file if required
-					if (settings->saveShapes)
+					if (textShapes)
+					{
 						if (totalRectangles > 0) // If a regular rectangle was added
 							componentFile << setw(11) << i << setw(1) << "," << setw(5) << totalRectangles << setw(1) << "," << setw(11) << sRectangle.center.x << setw(1) << "," << setw(11) << sRectangle.center.y << setw(1) << "," << setw(11) << sRectangle.width << setw(1) << "," << setw(11) << sRectangle.height << setw(1) << "," << setw(11) << hoop << setw(4) << "," << setw(11) << sRectangle.slope << "\n";
-					if (totalSlopedRectangles > 0) // If a sloped rectangle was added
-						componentFile << setw(11) << i << setw(1) << "," << setw(5) << totalSlopedRectangles << setw(1) << "," << setw(11) << sRectangle.center.x << setw(1) << "," << setw(11) << sRectangle.center.y << setw(1) << "," << setw(11) << sRectangle.width << setw(1) << "," << setw(11) << sRectangle.height << setw(1) << "," << setw(11) << hoop << setw(4) << "," << setw(11) << sRectangle.slope << "\n";
+						if (totalSlopedRectangles > 0) // If a sloped rectangle was added
+							componentFile << setw(11) << i << setw(1) << "," << setw(5) << totalSlopedRectangles << setw(1) << "," << setw(11) << sRectangle.center.x << setw(1) << "," << setw(11) << sRectangle.center.y << setw(1) << "," << setw(11) << sRectangle.width << setw(1) << "," << setw(11) << sRectangle.height << setw(1) << "," << setw(11) << hoop << setw(4) << "," << setw(11) << sRectangle.slope << "\n";
+					}
 				}
 
 				// If the shape is a circle or ellipse
@@ -350,18 +358,20 @@ void ShapeGenerator::setupCase(int caseNo, double* setUpTime)
 					cEllipse = addOneEllipse(caseNo, i, size, &totalRectangles, &totalSlopedRectangles, &totalEllipses, &totalCircles, &hoop);
 
 					// Save information to file if required
-					if (settings->saveShapes)
+					if (textShapes)
+					{
 						if (totalCircles > 0) // If a circle was added
 							componentFile << setw(11) << i << setw(1) << "," << setw(5) << totalCircles << setw(1) << "," << setw(11) << cEllipse.center.x << setw(1) << "," << setw(11) << cEllipse.center.y << setw(1) << "," << setw(11) << cEllipse.a << setw(1) << "," << setw(11) << cEllipse.b << setw(1) << "," << setw(11) << hoop << setw(4) << "," << setw(11) << cEllipse.slope << "\n";
-					if (totalEllipses > 0) // If an ellipse was added
-						componentFile << setw(11) << i << setw(1) << "," << setw(5) << totalEllipses << setw(1) << "," << setw(11) << cEllipse.center.x << setw(1) << "," << setw(11) << cEllipse.center.y << setw(1) << "," << setw(11) << cEllipse.a << setw(1) << "," << setw(11) << cEllipse.b << setw(1) << "," << setw(11) << hoop << setw(4) << "," << setw(11) << cEllipse.slope << "\n";
+						if (totalEllipses > 0) // If an ellipse was added
+							componentFile << setw(11) << i << setw(1) << "," << setw(5) << totalEllipses << setw(1) << "," << setw(11) << cEllipse.center.x << setw(1) << "," << setw(11) << cEllipse.center.y << setw(1) << "," << setw(11) << cEllipse.a << setw(1) << "," << setw(11) << cEllipse.b << setw(1) << "," << setw(11) << hoop << setw(4) << "," << setw(11) << cEllipse.slope << "\n";
+					}
 				}
 			} while (realComponentAreas[caseNo * totalComponents + i] < maxComp); // Continue until target area is met
 
 			if (swissCheese)
 			{
 				grid->inverse(); // Invert the grid for "Swiss Cheese" effect
-				cout << "Inverting array for solving Swiss Cheese problem...\n";
+				LOG_DETAIL("Inverting array for solving Swiss Cheese problem...\n");
 			}
 
 			// Normalize the real component area
@@ -397,7 +407,7 @@ void ShapeGenerator::setupCase(int caseNo, double* setUpTime)
 			}
 
 			// Print summary to file if saving shapes
-			if (settings->saveShapes)
+			if (textShapes)
 			{
 				componentFile << "------------------------------------------------------------------------------\n";
 				componentFile << "Component[" << i << "]";
@@ -419,9 +429,9 @@ void ShapeGenerator::setupCase(int caseNo, double* setUpTime)
 				componentFile << "\n";
 				componentFile << "Component[" << i << "] Real area in [" << grid->width << "x" << grid->height << "]= " << realComponentAreas[caseNo * totalComponents + i] << "%=\n";
 				componentFile << "------------------------------------------------------------------------------\n";
+				outputQueue.writeFile(FileName, componentFile.str()); // Write the component file
 			}
 			realComponentsArea = realComponentsArea + realComponentAreas[caseNo * totalComponents + i]; // Accumulate real area
-			componentFile.close(); // Close the component file
 		}
 		else // If it's a "NOTHING" component (matrix)
 		{
@@ -433,8 +443,7 @@ void ShapeGenerator::setupCase(int caseNo, double* setUpTime)
 		}
 	}
 
-	clock_t end = clock(); // End timer
-	*setUpTime = ((double)(end - start)) / CLOCKS_PER_SEC; // Calculate setup time
+	*setUpTime = timer.elapsed(); // Calculate setup time
 
 	// Calculate the real area of the matrix component
 	realComponentAreas[caseNo * totalComponents] = 1.0 - realComponentsArea;
@@ -442,12 +451,144 @@ void ShapeGenerator::setupCase(int caseNo, double* setUpTime)
 	printParticles(caseNo, totalEllipsesPerComponent, totalCirclesPerComponent, totalRectanglesPerComponent, totalSlopedRectanglesPerComponent);
 }
 
+// Selects the saved realizations to replay: ALL, or numbers and ranges such as "0,3,7-9".
+// The shapes file may come from another ppms value; its particles are then scaled to this grid.
+bool ShapeGenerator::openReplay(void)
+{
+	replayCases.clear();
+	if ((settings->replayCases == "none") || settings->replayCases.empty() || settings->isLattice)
+		return false;
+
+	string fileName = projectName + "/shapes/shapes.bin";
+	if (!shapesReader.open(fileName))
+	{
+		LOG_WARNING("Replay: cannot read " << fileName << ", new realizations are generated\n");
+		return false;
+	}
+	const ShapesFileHeader& header = shapesReader.header;
+	replayScale = (header.width > 0) ? (double)grid->width / header.width : 0;
+	if ((header.totalComponents != totalComponents) || (replayScale <= 0) || (lround(header.height * replayScale) != grid->height))
+	{
+		LOG_WARNING("Replay: " << fileName << " (" << header.width << "x" << header.height << ", " << header.totalComponents
+			<< " components) does not match this input, new realizations are generated\n");
+		shapesReader.close();
+		return false;
+	}
+
+	auto isStored = [&](int caseNo) {
+		for (const ShapesIndexEntry& entry : shapesReader.index)
+			if (entry.caseNo == caseNo)
+				return true;
+		return false;
+	};
+
+	if (settings->replayCases == "all")
+	{
+		for (const ShapesIndexEntry& entry : shapesReader.index)
+			replayCases.push_back(entry.caseNo);
+	}
+	else
+	{
+		string list = settings->replayCases;
+		std::replace(list.begin(), list.end(), ',', ' ');
+		istringstream tokens(list);
+		string token;
+		while (tokens >> token)
+		{
+			int first, last;
+			try {
+				size_t dash = token.find('-', 1);
+				first = std::stoi(token.substr(0, dash));
+				last = (dash == string::npos) ? first : std::stoi(token.substr(dash + 1));
+			}
+			catch (const std::exception& e) {
+				LOG_WARNING("Replay: invalid realization '" << token << "' is skipped. " << e.what() << "\n");
+				continue;
+			}
+			for (int caseNo = first; caseNo <= last; caseNo++)
+			{
+				if (isStored(caseNo))
+					replayCases.push_back(caseNo);
+				else
+					LOG_WARNING("Replay: realization " << caseNo << " is not in " << fileName << "\n");
+			}
+		}
+	}
+
+	if (replayCases.empty())
+	{
+		LOG_WARNING("Replay: no saved realization selected, new realizations are generated\n");
+		shapesReader.close();
+		return false;
+	}
+	iterations = (int)replayCases.size();
+	LOG_INFO("Replay of " << iterations << " realizations from " << fileName << " (scale " << replayScale << ")\n");
+	return true;
+}
+
+// Sets up a case from realization sourceCase of the shapes file. The particles are drawn in
+// generation order by drawParticles, so the grid is the one of the original run (at this ppms).
+void ShapeGenerator::replayCase(int caseNo, int sourceCase, double* setUpTime)
+{
+	ScopedTimer timer(PLACEMENT_PHASE); // Setup time (wall)
+
+	ParticleSet stored; // Particles in the pixels of the shapes file
+	if (!shapesReader.read(sourceCase, &stored))
+		LOG_WARNING("Replay: realization " << sourceCase << " cannot be read, the RVE is left empty\n");
+	stored.scaleTo(replayScale, &particles);
+	drawParticles(grid, &particles);
+
+	// Real areas and particle counts per component, as setupCase reports them
+	vector<int> totalEllipsesPerComponent(totalComponents, 0);
+	vector<int> totalCirclesPerComponent(totalComponents, 0);
+	vector<int> totalRectanglesPerComponent(totalComponents, 0);
+	vector<int> totalSlopedRectanglesPerComponent(totalComponents, 0);
+	for (int i = 0; i < totalComponents; i++)
+		realComponentAreas[caseNo * totalComponents + i] = 0;
+	for (size_t k = 0; k < particles.size(); k++)
+	{
+		int i = particles.component[k];
+		if (i >= totalComponents)
+			continue;
+		realComponentAreas[caseNo * totalComponents + i] += particles.realArea[k];
+		switch (particles.type[k])
+		{
+		case ShapeType::SLOPEDRECTANGLE: totalSlopedRectanglesPerComponent[i]++; break;
+		case ShapeType::RECTANGLE: totalRectanglesPerComponent[i]++; break;
+		case ShapeType::ELLIPSE: totalEllipsesPerComponent[i]++; break;
+		case ShapeType::CIRCLE: totalCirclesPerComponent[i]++; break;
+		default: break;
+		}
+	}
+	double realComponentsArea = 0; // Real area of all particle components
+	for (int i = 0; i < totalComponents; i++)
+		if (componentsType[i] != ShapeType::NOTHING)
+		{
+			realComponentAreas[caseNo * totalComponents + i] = realComponentAreas[caseNo * totalComponents + i] / ((grid->width) * grid->height);
+			realComponentsArea = realComponentsArea + realComponentAreas[caseNo * totalComponents + i];
+		}
+
+	*setUpTime = timer.elapsed(); // Calculate setup time
+
+	// Calculate the real area of the matrix component
+	realComponentAreas[caseNo * totalComponents] = 1.0 - realComponentsArea;
+	LOG_DETAIL("Replay of realization " << sourceCase << "\n");
+	printParticles(caseNo, totalEllipsesPerComponent, totalCirclesPerComponent, totalRectanglesPerComponent, totalSlopedRectanglesPerComponent);
+}
+
+// Upper limit for particle centres. On a periodic grid the whole torus [0, width) x [0, height)
+// is available, otherwise centres stay on the last pixel row/column.
+Point ShapeGenerator::placementLimit(void)
+{
+	if (grid->periodic)
+		return Point(grid->width, grid->height);
+	return Point(grid->width - 1, grid->height - 1);
+}
+
 // Adds one sloped rectangle to the grid
 SlopedRectangle ShapeGenerator::addOneSlopedRectangle(int caseNo, int ingradient, std::normal_distribution<double> size, int* totalRectangles, int* totalSlopedRectangles, int* totalEllipses, int* totalCircles, double* hoop)
 {
 	iPoint Center(0, 0); // Integer center coordinates
-	iPoint dims(0, 0);   // Integer dimensions
-	Point dCenter(0, 0); // Double center coordinates (not used)
 	double maxAngle = 0; // Maximum rotation angle
 	double minAngle = 0; // Minimum rotation angle
 
@@ -463,21 +604,21 @@ SlopedRectangle ShapeGenerator::addOneSlopedRectangle(int caseNo, int ingradient
 	*hoop = hoops[ingradient] * factor; // Calculate hoop distance
 
 	// Generate a random sloped rectangle within the grid boundaries
-	sRectangle = generateSlopedRectangle(Point(0.0, 0.0), Point(grid->width - 1, grid->height - 1), rectWidth, rectHeight, maxAngle, minAngle);
+	sRectangle = generateSlopedRectangle(Point(0.0, 0.0), placementLimit(), rectWidth, rectHeight, maxAngle, minAngle);
 	// Convert double coordinates to integer grid coordinates
 	Center = grid->toLocaldimensions(sRectangle.center.x, sRectangle.center.y);
-	dims = grid->toLocaldimensionsUp(sRectangle.width, sRectangle.height);
 	double pSlope = sRectangle.slope; // Get the slope of the generated rectangle
 
-	// Create the final SlopedRectangle object with grid-aligned coordinates
-	sRectangle = SlopedRectangle(Point(Center.x, Center.y), double(dims.x), double(dims.y), pSlope);
-	// sharedArea = grid->countPixelsInsidelopedRectange(Center.x, Center.y, dims.x, dims.y, sRectangle.slope, CellState::HARD);
+	// Store the particle (cos/sin are computed once here) and draw it
+	size_t k = particles.add(Center.x, Center.y, rectWidth, rectHeight, pSlope, *hoop, ingradient, componentsType[ingradient]);
+	swissCheeseCheckAndDraw(&particles, k, grid);
 
-	// Apply Swiss Cheese logic and draw the shape
-	swissCheeseCheckAndDraw(ingradient, rectWidth, rectHeight, &sRectangle, *hoop);
+	// Rectangle returned to the caller for the shapes report
+	sRectangle = SlopedRectangle(Point(Center.x, Center.y), rectWidth, rectHeight, pSlope);
+	sRectangle.realArea = particles.realArea[k];
 
 	// Accumulate the real area of the component
-	realComponentAreas[caseNo * totalComponents + ingradient] = realComponentAreas[caseNo * totalComponents + ingradient] + sRectangle.realArea; // -sharedArea;
+	realComponentAreas[caseNo * totalComponents + ingradient] = realComponentAreas[caseNo * totalComponents + ingradient] + sRectangle.realArea;
 
 	return sRectangle; // Return the generated sloped rectangle
 }
@@ -490,7 +631,6 @@ Ellipse ShapeGenerator::addOneEllipse(int caseNo, int ingradient, std::normal_di
 
 	double maxAngle = 0; // Maximum rotation angle
 	double minAngle = 0; // Minimum rotation angle
-	// double sharedArea = 0; // Shared area with existing shapes (commented out)
 
 	Ellipse cEllipse(Point(0, 0), 0, 0, 0); // Temporary Ellipse object
 
@@ -500,30 +640,24 @@ Ellipse ShapeGenerator::addOneEllipse(int caseNo, int ingradient, std::normal_di
 	// Calculate hoop distance (half)
 	*hoop = 0.5 * hoops[ingradient] * factor;
 
-	// randomize maxTries (commented out)
-	// maxTries = 3;
-
 	iPoint Center(0, 0); // Integer center coordinates
-	iPoint axes(0, 0);   // Integer axes dimensions
-	Point dCenter(0, 0); // Double center coordinates (not used)
 
 	// Generate a random ellipse within the grid boundaries
-	cEllipse = generateEllipse(Point(0, 0), Point(grid->width - 1, grid->height - 1), a, b, maxAngle, minAngle);
+	cEllipse = generateEllipse(Point(0, 0), placementLimit(), a, b, maxAngle, minAngle);
 	// Convert double coordinates to integer grid coordinates
 	Center = grid->toLocaldimensions(cEllipse.center.x, cEllipse.center.y);
-	axes = grid->toLocaldimensionsUp(cEllipse.a, cEllipse.b);
 	double pSlope = cEllipse.slope; // Get the slope of the generated ellipse
-	// Create the final Ellipse object with grid-aligned coordinates
-	cEllipse = Ellipse(Point(Center.x, Center.y), double(axes.x), double(axes.y), pSlope);
 
-	// sharedArea = grid->countPixelsInsideEllipse(Center.x, Center.y, axes.x, axes.y, cEllipse.slope, CellState::HARD);
+	// Store the particle (cos/sin are computed once here) and draw it
+	size_t k = particles.add(Center.x, Center.y, a, b, pSlope, *hoop, ingradient, componentsType[ingradient]);
+	swissCheeseCheckAndDraw(&particles, k, grid);
 
-	// Apply Swiss Cheese logic and draw the shape
-	swissCheeseCheckAndDraw(ingradient, a, b, &cEllipse, *hoop);
+	// Ellipse returned to the caller for the shapes report
+	cEllipse = Ellipse(Point(Center.x, Center.y), a, b, pSlope);
+	cEllipse.realArea = particles.realArea[k];
 
 	// Accumulate the real area of the component
-	realComponentAreas[caseNo * totalComponents + ingradient] = realComponentAreas[caseNo * totalComponents + ingradient] + cEllipse.realArea; // -sharedArea;
-	// debug only cout << "Area=" << realComponentAreas[caseNo * totalComponents + ingradient] << " " << cEllipse.realArea << "\n";
+	realComponentAreas[caseNo * totalComponents + ingradient] = realComponentAreas[caseNo * totalComponents + ingradient] + cEllipse.realArea;
 
 	return cEllipse; // Return the generated ellipse
 }
@@ -583,69 +717,584 @@ void ShapeGenerator::SetupSizes(int ingradient, double idimensionY, double idime
 	}
 }
 
-// Handles drawing an ellipse with or without "Swiss Cheese" effect
-void ShapeGenerator::swissCheeseCheckAndDraw(int ingradient, double a, double b, Ellipse* cEllipse, double hoop)
+// Draws particle k with or without "Swiss Cheese" effect.
+// Without it the hoop shell (core + hoop) is drawn SOFT and the core HARD; with it the
+// particle outline is drawn SOFT and the hole (core - hoop) HARD. The digitized core
+// area is stored in the particle store.
+void ShapeGenerator::swissCheeseCheckAndDraw(ParticleSet* iParticles, size_t k, Grid* iGrid)
+{
+	ScopedTimer timer(RASTERIZE_PHASE, false); // One particle: wall time only
+	double hoop = iParticles->hoop[k]; // Hoop thickness of the particle
+	bool isEllipse = (iParticles->type[k] == ShapeType::ELLIPSE) || (iParticles->type[k] == ShapeType::CIRCLE);
+
+	double outerA = iParticles->a[k] + hoop; // Size of the SOFT shell (a or width)
+	double outerB = iParticles->b[k] + hoop; // Size of the SOFT shell (b or height)
+	double coreA = iParticles->a[k];         // Size of the HARD core (a or width)
+	double coreB = iParticles->b[k];         // Size of the HARD core (b or height)
+	if (swissCheese) // "Swiss Cheese" effect (draw matrix as HARD, particles as holes)
+	{
+		outerA = iParticles->a[k];
+		outerB = iParticles->b[k];
+		coreA = iParticles->a[k] - hoop;
+		coreB = iParticles->b[k] - hoop;
+	}
+
+	// Draw the shell as SOFT
+	if (hoop > 0)
+	{
+		if (isEllipse)
+			digitizeEllipse(*iParticles, k, outerA, outerB, iGrid, CellState::SOFT);
+		else
+			digitizeSlopedRectangle(*iParticles, k, outerA, outerB, iGrid, CellState::SOFT);
+	}
+
+	// Draw the core as HARD and keep its real area
+	if (isEllipse)
+		digitizeEllipse(*iParticles, k, coreA, coreB, iGrid, &iParticles->realArea[k], CellState::HARD);
+	else
+		digitizeSlopedRectangle(*iParticles, k, coreA, coreB, iGrid, &iParticles->realArea[k], CellState::HARD);
+}
+
+// Draws the particles of iParticles on iGrid, component after component as in setupCase.
+// Returns the digitized particle area in pixels.
+double ShapeGenerator::drawParticles(Grid* iGrid, ParticleSet* iParticles)
 {
-	if (!swissCheese) // Standard drawing (no "Swiss Cheese" effect)
+	double realArea = 0; // Digitized particle area (pixels)
+	for (int i = 0; i < totalComponents; i++)
 	{
-		// Add core plus hoop area
-		if (hoop > 0)
+		if (componentsType[i] == ShapeType::NOTHING)
+			continue;
+
+		// Particles are stored in generation order, so drawing per component keeps the overlaps of setupCase
+		for (size_t k = 0; k < iParticles->size(); k++)
+			if (iParticles->component[k] == i)
+			{
+				swissCheeseCheckAndDraw(iParticles, k, iGrid);
+				realArea = realArea + iParticles->realArea[k];
+			}
+
+		if (swissCheese)
+			iGrid->inverse(); // Same inversion as setupCase
+	}
+	return realArea;
+}
+
+// Draws the stored particles of the current realization on iGrid, scaled by iScale.
+// The geometry is the one generated by setupCase, only its digitization changes.
+double ShapeGenerator::rasterize(Grid* iGrid, double iScale)
+{
+	ParticleSet scaled; // Particles in iGrid pixels
+	particles.scaleTo(iScale, &scaled);
+
+	return drawParticles(iGrid, &scaled) / ((double)iGrid->width * iGrid->height);
+}
+
+// Percolation and clusters of the current realization on a lazily materialized grid.
+// Particles are binned by the tile of their centre; every tile is drawn from the particles of
+// the bins within reach of the largest particle (with their periodic images), labelled and evicted.
+int ShapeGenerator::percolateTiled(TiledGrid* tGrid, double iScale, double* realArea)
+{
+	ParticleSet scaled; // Particles in tGrid pixels
+	particles.scaleTo(iScale, &scaled);
+
+	int T = tGrid->tileSize;
+	vector<vector<size_t>> bins((size_t)tGrid->tilesX * tGrid->tilesY); // Particle indices per tile of the centre
+	double maxExtent = 0; // Largest half extent of a drawn particle (pixels)
+	for (size_t k = 0; k < scaled.size(); k++)
+	{
+		bool isEllipse = (scaled.type[k] == ShapeType::ELLIPSE) || (scaled.type[k] == ShapeType::CIRCLE);
+		double outerA = scaled.a[k] + (swissCheese ? 0 : scaled.hoop[k]); // Outer size, as in swissCheeseCheckAndDraw
+		double outerB = scaled.b[k] + (swissCheese ? 0 : scaled.hoop[k]);
+		double extentX = isEllipse ? scaled.ellipseExtentX(k, outerA, outerB) : scaled.rectangleExtentX(k, outerA, outerB);
+		double extentY = isEllipse ? scaled.ellipseExtentY(k, outerA, outerB) : scaled.rectangleExtentY(k, outerA, outerB);
+		maxExtent = std::max(maxExtent, std::max(extentX, extentY) + 2); // + sampling margin of the digitizers
+
+		int bx = std::min(std::max((int)floor(scaled.centerX[k] / T), 0), tGrid->tilesX - 1);
+		int by = std::min(std::max((int)floor(scaled.centerY[k] / T), 0), tGrid->tilesY - 1);
+		bins[(size_t)by * tGrid->tilesX + bx].push_back(k);
+	}
+	int reach = (int)ceil((maxExtent + 1) / T); // Tiles a particle may spill into
+
+	tGrid->clear();
+	*realArea = 0;
+	ParticleSet tileParticles; // Particles touching the current tile, in tile pixels
+	vector<pair<size_t, Point>> selected; // (particle, tile offset) of the current tile
+	for (int ty = 0; ty < tGrid->tilesY; ty++)
+		for (int tx = 0; tx < tGrid->tilesX; tx++)
 		{
-			cEllipse->a = a + hoop; // Increase semi-major axis for hoop
-			cEllipse->b = b + hoop; // Increase semi-minor axis for hoop
-			digitizeEllipse(ingradient, *cEllipse, grid, CellState::SOFT); // Draw hoop as SOFT
+			Range region = tGrid->tileRange(tx, ty);
+			selected.clear();
+			for (int dy = -reach; dy <= reach; dy++)
+				for (int dx = -reach; dx <= reach; dx++)
+				{
+					int bx = tx + dx, by = ty + dy;
+					double shiftX = -region.from.x, shiftY = -region.from.y;
+					if (tGrid->periodic) // Periodic image of the bin
+					{
+						while (bx < 0) { bx += tGrid->tilesX; shiftX -= tGrid->width; }
+						while (bx >= tGrid->tilesX) { bx -= tGrid->tilesX; shiftX += tGrid->width; }
+						while (by < 0) { by += tGrid->tilesY; shiftY -= tGrid->height; }
+						while (by >= tGrid->tilesY) { by -= tGrid->tilesY; shiftY += tGrid->height; }
+					}
+					else if ((bx < 0) || (bx >= tGrid->tilesX) || (by < 0) || (by >= tGrid->tilesY))
+						continue;
+
+					const vector<size_t>& bin = bins[(size_t)by * tGrid->tilesX + bx];
+					for (size_t m = 0; m < bin.size(); m++)
+						selected.push_back({ bin[m], Point(shiftX, shiftY) });
+				}
+
+			// Generation order, so overlaps are resolved as on a full grid
+			std::sort(selected.begin(), selected.end(), [](const pair<size_t, Point>& p1, const pair<size_t, Point>& p2) { return p1.first < p2.first; });
+			tileParticles.clear();
+			for (size_t m = 0; m < selected.size(); m++)
+			{
+				size_t k = selected[m].first;
+				tileParticles.add(scaled.centerX[k] + selected[m].second.x, scaled.centerY[k] + selected[m].second.y, scaled.a[k], scaled.b[k],
+					scaled.slope[k], scaled.hoop[k], scaled.component[k], scaled.type[k]);
+			}
+
+			Grid* tile = tGrid->materialize(tx, ty);
+			*realArea = *realArea + drawParticles(tile, &tileParticles);
+			tGrid->addTile(tx, ty);
 		}
-		// Add only core area
-		cEllipse->a = a; // Reset semi-major axis to original size
-		cEllipse->b = b; // Reset semi-minor axis to original size
-		digitizeEllipse(ingradient, *cEllipse, grid, &cEllipse->realArea, CellState::HARD); // Draw core as HARD
-	}
-	else // "Swiss Cheese" effect (draw matrix as HARD, particles as holes)
+	tGrid->finish();
+
+	*realArea = *realArea / ((double)tGrid->width * tGrid->height);
+	return tGrid->percolates;
+}
+
+// Runs the current realization at every extra resolution of the study
+void ShapeGenerator::resolutionStudy(int caseNo, vector<Grid*>& studyGrids, vector<TiledGrid*>& studyTiledGrids)
+{
+	for (size_t r = 0; r < studyPixelsPerMinimumSize.size(); r++)
 	{
-		// Draw the outer boundary of the hole as SOFT (the particle itself)
-		if (hoop > 0)
+		size_t n = r * iterations + caseNo; // Index of this (resolution, case) entry
+		double scale = (double)studyPixelsPerMinimumSize[r] / pixelsPerMinimumSize;
+		Grid* sGrid = studyGrids[r];
+		TiledGrid* tGrid = studyTiledGrids[r];
+
+		WallTimer timer; // Rasterization + percolation time (wall)
+		double totalPaths = 0;
+		int sWidth, sHeight;
+
+		if (tGrid != NULL) // Lazy grid: percolation and cluster connectivity only
 		{
-			cEllipse->a = a; // Use original semi-major axis
-			cEllipse->b = b; // Use original semi-minor axis
-			digitizeEllipse(ingradient, *cEllipse, grid, CellState::SOFT); // Draw particle boundary as SOFT
+			sWidth = tGrid->width;
+			sHeight = tGrid->height;
+			studyResults[n] = percolateTiled(tGrid, scale, &studyRealAreas[n]);
+			totalPaths = studyResults[n];
+			studyElectricConductivity[n] = 0;
+			studyClusters[n] = (double)tGrid->totalClusters;
+			studyMaxClusterSize[n] = (double)tGrid->maxClusterSize;
 		}
-		// Draw the "hole" (inner part of the particle) as HARD (matrix phase)
-		cEllipse->a = a - hoop; // Decrease semi-major axis for the hole
-		cEllipse->b = b - hoop; // Decrease semi-minor axis for the hole
-		digitizeEllipse(ingradient, *cEllipse, grid, &cEllipse->realArea, CellState::HARD); // Draw inner hole as HARD
+		else
+		{
+			sWidth = sGrid->width;
+			sHeight = sGrid->height;
+			sGrid->clear();
+			studyRealAreas[n] = rasterize(sGrid, scale);
+
+			double meanLength = 0, meanRealLength = 0, processTime = 0;
+			double resistance = 0, thermalResistance = 0, youngModulus = 0, poissonRatio = 0;
+			if (calcElectricConductivity)
+				studyResults[n] = sGrid->percolateWithRealPathLength(&totalPaths, &meanLength, &meanRealLength, &processTime,
+					materialsElectricConductivity, &resistance, materialsThermalConductivity, &thermalResistance,
+					materialsYoungModulus, &youngModulus, materialsPoissonRatio, &poissonRatio);
+			else
+			{
+				studyResults[n] = sGrid->percolate(&processTime);
+				if (studyResults[n])
+					totalPaths = 1; // At least one path
+			}
+			if (!studyResults[n])
+				totalPaths = 0;
+
+			if ((totalPaths > 0) && (resistance > 0))
+				studyElectricConductivity[n] = (1 / resistance) * totalPaths / sGrid->width;
+			else
+				studyElectricConductivity[n] = 0;
+
+			if (calcElectricConductivityWithFDM)
+				solveFDM(sGrid, &studyFDResults[2 * n], &studyFDResults[2 * n + 1], NULL);
+		}
+		studyPaths[n] = totalPaths;
+
+		studyTimes[n] = timer.elapsed();
+
+		LOG_DETAIL("ppms=" << setw(5) << studyPixelsPerMinimumSize[r] << " [" << sWidth << "x" << sHeight << "] "
+			<< "Real area=" << studyRealAreas[n] << " Percolate=" << studyResults[n] << " Paths=" << totalPaths
+			<< ((tGrid != NULL) ? " Clusters=" + to_string(tGrid->totalClusters) + " Max cluster=" + to_string(tGrid->maxClusterSize) : string()) << "\n");
 	}
 }
 
-// Handles drawing a sloped rectangle with or without "Swiss Cheese" effect
-void ShapeGenerator::swissCheeseCheckAndDraw(int ingradient, double rectWidth, double rectHeight, SlopedRectangle* sRectangle, double hoop)
+// Solves the electric conductivity of iGrid with the Finite Differences Method
+void ShapeGenerator::solveFDM(Grid* iGrid, double* currX, double* currY, char* imageFileName, int* cgIterations)
+{
+	int x = iGrid->width;
+	int y = x; // Assuming square grid for FDM
+	FD2DEL fd2Del(totalComponents, maxComponents); // Create FDM solver object
+	fd2Del.solver = settings->fdmSolver;           // Serial CG, row strips per thread, multigrid or mixed precision (before the arrays)
+	fd2Del.initValues(x, y);                       // Initialize values
+	fd2Del.intitArrays();                          // Initialize arrays
+	fd2Del.readFromArray(iGrid->ingadients, materialsElectricConductivity); // Read material data from grid
+	fd2Del.backboneCut = settings->fdmBackbone;    // Backbone only, or the whole grid
+	char m[] = "m1.dat";   // Input file for FDM (not directly used in `run` with grid data)
+	char out[] = "out.bmp"; // Output bitmap file name
+
+	fd2Del.run(m, out, totalComponents); // Run FDM simulation
+
+	if (imageFileName != NULL)
+		queueImageSnapshot(fd2Del.pix, iGrid->height + 2, iGrid->width + 2, imageFileName, generateBitmapImageFortranStyle); // Generate bitmap image
+
+	*currX = fd2Del.currx; // Result for x-direction
+	*currY = fd2Del.curry; // Result for y-direction
+	if (cgIterations != NULL)
+		*cgIterations = fd2Del.cgIterations;
+}
+
+// Columns of results.bin: one record per case, written as soon as the case ends
+void ShapeGenerator::openResultsFile(int resumeCases)
 {
-	if (!swissCheese) // Standard drawing
+	resultsFile.clearColumns();
+	resultsFile.addColumn("case", 'q');
+	resultsFile.addColumn("seed", 'Q');
+	resultsFile.addColumn("setupTime", 'd');
+	resultsFile.addColumn("time", 'd');
+	resultsFile.addColumn("percolates", 'q');
+	resultsFile.addColumn("paths", 'd');
+	resultsFile.addColumn("meanPathLength", 'd');
+	resultsFile.addColumn("meanRealPathLength", 'd');
+	resultsFile.addColumn("electricConductivity", 'd');
+	resultsFile.addColumn("thermalConductivity", 'd');
+	resultsFile.addColumn("youngModulus", 'd');
+	resultsFile.addColumn("poissonRatio", 'd');
+	resultsFile.addColumn("fdCurrentX", 'd');
+	resultsFile.addColumn("fdCurrentY", 'd');
+	resultsFile.addColumn("cgIterations", 'q');
+	resultsFile.addColumn("clusters", 'q');
+	resultsFile.addColumn("maxClusterPoints", 'q');
+	resultsFile.addColumn("correlationLength", 'd');
+	for (int c = 0; c < totalComponents; c++)
+		resultsFile.addColumn("realArea" + to_string(c), 'd');
+	for (int p = 0; p < TIMER_PHASES; p++)
 	{
-		// Add core plus hoop area
-		if (hoop > 0)
+		resultsFile.addColumn(string(timerPhaseNames[p]) + "Wall", 'd');
+		resultsFile.addColumn(string(timerPhaseNames[p]) + "Cpu", 'd');
+	}
+
+	if (resumeCases > 0)
+		resultsFile.resume(projectName + "/results.bin", projectName, grid->width, grid->height, pixelsPerMinimumSize, iterations, totalComponents, resumeCases);
+	else
+		resultsFile.open(projectName + "/results.bin", projectName, grid->width, grid->height, pixelsPerMinimumSize, iterations, totalComponents);
+}
+
+void ShapeGenerator::summarizeCase(int caseNo, double correlationLength)
+{
+	// Cluster summary of the grid (filled when statistics are calculated)
+	int64_t clusters = 0;
+	int64_t maxClusterPoints = 0;
+	double maxClusterRadius = 0;
+	for (size_t k = 0; k < grid->Clusters.size(); k++)
+		if (grid->Clusters[k].totalPoints > 0)
 		{
-			// Create a temporary SlopedRectangle with hoop size
-			SlopedRectangle sRectWithHoop(Point(sRectangle->center.x, sRectangle->center.y), rectWidth + hoop, rectHeight + hoop, sRectangle->slope);
-			digitizeSlopedRectangle(ingradient, sRectWithHoop, grid, CellState::SOFT); // Draw hoop as SOFT
+			clusters++;
+			maxClusterPoints = std::max(maxClusterPoints, (int64_t)grid->Clusters[k].totalPoints);
+			maxClusterRadius = std::max(maxClusterRadius, grid->Clusters[k].radius);
 		}
+	caseClusters[caseNo] = clusters;
+	caseMaxClusterPoints[caseNo] = maxClusterPoints;
+	caseMaxClusterRadius[caseNo] = maxClusterRadius;
+	caseCorrelationLengths[caseNo] = correlationLength;
+}
+
+void ShapeGenerator::appendResults(int caseNo)
+{
+	if (!resultsFile.isOpen())
+		return;
+
+	resultsFile.put((int64_t)caseNo);
+	resultsFile.put(seeds[caseNo]);
+	resultsFile.put(setUpTimes[caseNo]);
+	resultsFile.put(Times[caseNo]);
+	resultsFile.put((int64_t)Results[caseNo]);
+	resultsFile.put(paths[caseNo]);
+	resultsFile.put(meanPathLength[caseNo]);
+	resultsFile.put(meanRealPathLength[caseNo]);
+	resultsFile.put(electricConductivity[caseNo]);
+	resultsFile.put(thermalConductivities[caseNo]);
+	resultsFile.put(YoungModulus[caseNo]);
+	resultsFile.put(PoissonRatio[caseNo]);
+	resultsFile.put((double)FDResults[2 * caseNo]);
+	resultsFile.put((double)FDResults[2 * caseNo + 1]);
+	resultsFile.put((int64_t)FDIterations[caseNo]);
+	resultsFile.put(caseClusters[caseNo]);
+	resultsFile.put(caseMaxClusterPoints[caseNo]);
+	resultsFile.put(caseCorrelationLengths[caseNo]);
+	for (int c = 0; c < totalComponents; c++)
+		resultsFile.put(realComponentAreas[caseNo * totalComponents + c]);
+	for (int p = 0; p < TIMER_PHASES; p++)
+	{
+		resultsFile.put(phaseTimes[caseNo].wall[p]);
+		resultsFile.put(phaseTimes[caseNo].cpu[p]);
+	}
+	resultsFile.endRecord();
+}
+
+// FNV-1a hash of the input and of the settings that change its realizations
+uint64_t ShapeGenerator::inputFingerprint(void)
+{
+	uint64_t hash = 14695981039346656037ull;
+	auto add = [&hash](const void* data, size_t size) {
+		const unsigned char* bytes = (const unsigned char*)data;
+		for (size_t k = 0; k < size; k++)
+			hash = (hash ^ bytes[k]) * 1099511628211ull;
+	};
+	int values[] = { iterations, width, height, totalComponents, pixelsPerMinimumSize, swissCheese, calcElectricConductivity,
+		calcElectricConductivityWithFDM, calcStatistcs, settings->isLattice, settings->isPeriodic, settings->tileSize };
+	add(values, sizeof(values));
+	add(components, sizeof(components));
+	add(specialWeights, sizeof(specialWeights));
+	add(dimensionX, sizeof(dimensionX));
+	add(dimensionY, sizeof(dimensionY));
+	add(componentsType, sizeof(componentsType));
+	add(componentsSizeType, sizeof(componentsSizeType));
+	add(hoops, sizeof(hoops));
+	add(materialsElectricConductivity, sizeof(materialsElectricConductivity));
+	add(materialsThermalConductivity, sizeof(materialsThermalConductivity));
+	add(materialsYoungModulus, sizeof(materialsYoungModulus));
+	add(materialsPoissonRatio, sizeof(materialsPoissonRatio));
+	add(studyPixelsPerMinimumSize.data(), studyPixelsPerMinimumSize.size() * sizeof(int));
+	add(settings->replayCases.data(), settings->replayCases.size());
+	return hash;
+}
+
+void ShapeGenerator::saveCheckpoint(int completed)
+{
+	Checkpoint checkpoint;
+	checkpoint.header.fingerprint = inputFingerprint();
+	checkpoint.header.iterations = iterations;
+	checkpoint.header.completed = completed;
+	checkpoint.header.width = width;
+	checkpoint.header.height = height;
+	checkpoint.header.pixelsPerMinimumSize = pixelsPerMinimumSize;
+	checkpoint.header.totalComponents = totalComponents;
+
+	checkpoint.add("Results", Results);
+	checkpoint.add("FDResults", FDResults);
+	checkpoint.add("Times", Times);
+	checkpoint.add("setUpTimes", setUpTimes);
+	checkpoint.add("paths", paths);
+	checkpoint.add("meanPathLength", meanPathLength);
+	checkpoint.add("meanRealPathLength", meanRealPathLength);
+	checkpoint.add("seeds", seeds);
+	checkpoint.add("FDIterations", FDIterations);
+	checkpoint.add("phaseTimes", phaseTimes);
+	checkpoint.add("electricConductivity", electricConductivity);
+	checkpoint.add("thermalConductivities", thermalConductivities);
+	checkpoint.add("YoungModulus", YoungModulus);
+	checkpoint.add("PoissonRatio", PoissonRatio);
+	checkpoint.add("meanRVEResistances", meanRVEResistances);
+	checkpoint.add("meanRVEThermalResist", meanRVEThermalResistance);
+	checkpoint.add("meanRVEYoungModulus", meanRVEYoungModulus);
+	checkpoint.add("meanRVEPoissoonRatio", meanRVEPoissoonRatio);
+	checkpoint.add("realComponentAreas", realComponentAreas);
+	checkpoint.add("correleationLengths", correleationLengths);
+	checkpoint.add("caseMaxClusterRadius", caseMaxClusterRadius);
+	checkpoint.add("studyResults", studyResults);
+	checkpoint.add("studyRealAreas", studyRealAreas);
+	checkpoint.add("studyPaths", studyPaths);
+	checkpoint.add("studyElectricCond", studyElectricConductivity);
+	checkpoint.add("studyFDResults", studyFDResults);
+	checkpoint.add("studyTimes", studyTimes);
+	checkpoint.add("studyClusters", studyClusters);
+	checkpoint.add("studyMaxClusterSize", studyMaxClusterSize);
+
+	// The shapes records of these cases reach the disk before the checkpoint that counts them
+	shapesWriter.flush();
+	string fileName = projectName + "/checkpoint.bin";
+	size_t bytes = checkpoint.bytes();
+	outputQueue.submit([checkpoint = std::move(checkpoint), fileName]() { checkpoint.save(fileName); }, bytes);
+}
+
+int ShapeGenerator::restoreCheckpoint(void)
+{
+	Checkpoint checkpoint;
+	string fileName = projectName + "/checkpoint.bin";
+	if (!settings->resume || !checkpoint.load(fileName))
+		return 0;
+
+	// Ranks sharing the realizations: the restored cases are rank 0's, the others add only theirs to the sums
+	if (distributed.sharesRealizations() && (distributed.rank != 0))
+		return 0;
+
+	const CheckpointHeader& header = checkpoint.header;
+	if ((header.fingerprint != inputFingerprint()) || (header.iterations != iterations) || (header.width != width) || (header.height != height)
+		|| (header.pixelsPerMinimumSize != pixelsPerMinimumSize) || (header.totalComponents != totalComponents)
+		|| (header.completed <= 0) || (header.completed > iterations))
+	{
+		LOG_WARNING("Checkpoint " << fileName << " is of another input, the run starts from the first realization\n");
+		return 0;
+	}
+
+	bool restored = checkpoint.get("Results", Results) && checkpoint.get("FDResults", FDResults) && checkpoint.get("Times", Times)
+		&& checkpoint.get("setUpTimes", setUpTimes) && checkpoint.get("paths", paths) && checkpoint.get("meanPathLength", meanPathLength)
+		&& checkpoint.get("meanRealPathLength", meanRealPathLength) && checkpoint.get("seeds", seeds) && checkpoint.get("FDIterations", FDIterations)
+		&& checkpoint.get("phaseTimes", phaseTimes)
+		&& checkpoint.get("electricConductivity", electricConductivity) && checkpoint.get("thermalConductivities", thermalConductivities)
+		&& checkpoint.get("YoungModulus", YoungModulus) && checkpoint.get("PoissonRatio", PoissonRatio)
+		&& checkpoint.get("meanRVEResistances", meanRVEResistances) && checkpoint.get("meanRVEThermalResist", meanRVEThermalResistance)
+		&& checkpoint.get("meanRVEYoungModulus", meanRVEYoungModulus) && checkpoint.get("meanRVEPoissoonRatio", meanRVEPoissoonRatio)
+		&& checkpoint.get("realComponentAreas", realComponentAreas)
+		&& checkpoint.get("correleationLengths", correleationLengths, false) && checkpoint.get("caseMaxClusterRadius", caseMaxClusterRadius)
+		&& checkpoint.get("studyResults", studyResults) && checkpoint.get("studyRealAreas", studyRealAreas) && checkpoint.get("studyPaths", studyPaths)
+		&& checkpoint.get("studyElectricCond", studyElectricConductivity) && checkpoint.get("studyFDResults", studyFDResults)
+		&& checkpoint.get("studyTimes", studyTimes) && checkpoint.get("studyClusters", studyClusters)
+		&& checkpoint.get("studyMaxClusterSize", studyMaxClusterSize);
+	if (!restored)
+	{
+		LOG_WARNING("Checkpoint " << fileName << " does not fit this run, the run starts from the first realization\n");
+		correleationLengths.clear();
+		caseMaxClusterRadius.assign(iterations, 0);
+		return 0;
+	}
+
+	LOG_INFO("Resumed from checkpoint: " << header.completed << " of " << iterations << " realizations finished\n");
+	return header.completed;
+}
+
+void ShapeGenerator::mergeCases(int from, int to)
+{
+	// The shapes of these cases reach the disk before rank 0's checkpoint counts them
+	if (settings->checkpointInterval > 0)
+	{
+		shapesWriter.flush();
+		outputQueue.flush();
+	}
+
+	// Sums into rank 0, the other ranks start again from zeros (their cases are in rank 0's sums)
+	auto merge = [](auto& values) {
+		distributed.sumToRoot(values);
+		if (distributed.rank != 0)
+			std::fill(values.begin(), values.end(), typename std::decay_t<decltype(values)>::value_type());
+	};
+	merge(Results);
+	merge(FDResults);
+	merge(Times);
+	merge(setUpTimes);
+	merge(paths);
+	merge(meanPathLength);
+	merge(meanRealPathLength);
+	merge(seeds);
+	merge(FDIterations);
+	merge(phaseTimes);
+	merge(electricConductivity);
+	merge(thermalConductivities);
+	merge(YoungModulus);
+	merge(PoissonRatio);
+	merge(meanRVEResistances);
+	merge(meanRVEThermalResistance);
+	merge(meanRVEYoungModulus);
+	merge(meanRVEPoissoonRatio);
+	merge(realComponentAreas);
+	merge(caseClusters);
+	merge(caseMaxClusterPoints);
+	merge(caseMaxClusterRadius);
+	merge(caseCorrelationLengths);
+	merge(studyResults);
+	merge(studyRealAreas);
+	merge(studyPaths);
+	merge(studyElectricConductivity);
+	merge(studyFDResults);
+	merge(studyTimes);
+	merge(studyClusters);
+	merge(studyMaxClusterSize);
+	if (distributed.rank != 0)
+		return;
+
+	// Correlation lengths in case order, after the merged ones
+	if (calcStatistcs)
+	{
+		correleationLengths.resize(from);
+		for (int k = from; k < to; k++)
+			correleationLengths.push_back(caseCorrelationLengths[k]);
+	}
+
+	// Records of the new cases and a checkpoint of the finished ones
+	for (int k = from; k < to; k++)
+		appendResults(k);
+	if ((settings->checkpointInterval > 0) && (from < to))
+		saveCheckpoint(to);
+}
 
-		sRectangle->width = rectWidth;   // Reset width to original
-		sRectangle->height = rectHeight; // Reset height to original
-		digitizeSlopedRectangle(ingradient, *sRectangle, grid, &sRectangle->realArea, CellState::HARD); // Draw core as HARD
+void ShapeGenerator::mergeShapes(int cases)
+{
+	string folder = projectName + "/shapes/";
+	string fileName = folder + "shapes.bin";
+	vector<string> parts; // Files of the ranks, then the one of an earlier merge (newer records first)
+	std::error_code error;
+	for (const auto& entry : std::filesystem::directory_iterator(folder, error))
+	{
+		string name = entry.path().filename().string();
+		if ((name.size() > 11) && (name.compare(0, 7, "shapes.") == 0) && (name.compare(name.size() - 4, 4, ".bin") == 0)
+			&& (name.find_first_not_of("0123456789", 7) == name.size() - 4))
+			parts.push_back(folder + name);
 	}
-	else // "Swiss Cheese" effect
+	if (std::filesystem::exists(fileName, error))
+		parts.push_back(fileName);
+	if (parts.empty())
+		return;
+
+	if (cases > 0)
 	{
-		// Draw the outer boundary of the hole as SOFT (the particle itself)
-		if (hoop > 0)
+		int merged = mergeShapesFiles(parts, fileName, cases);
+		if (merged < 0)
+			return; // The files of the ranks are kept
+		if (merged < cases)
+			LOG_WARNING("Shapes file " << fileName << " holds " << merged << " of " << cases << " realizations\n");
+	}
+	for (const string& part : parts)
+		if ((part != fileName) || (cases == 0))
+			std::filesystem::remove(part, error);
+}
+
+// Estimates the peak memory of a monteCarlo() run (grid planes, study grids and FDM arrays)
+size_t ShapeGenerator::memoryFootprint(void)
+{
+	const size_t planeBytes = 5;                                   // cell, visited, ingadients, cluster, clusterVisited
+	// FDM arrays per padded site of the selected solver (peak RSS of the solvers on a 512 x 512 grid:
+	// 56 bytes CG, 72 BLOCK_JACOBI, 400 AMG, 36 MIXED)
+	const size_t amgBytes = 43 * sizeof(double); // Multigrid levels: matrices (complexity ~2.5), P, R and vectors of the levels and of the CG
+	size_t fdmBytes = 6 * sizeof(double) + 2 * sizeof(int); // gx, gy, u, gb, h, ah, pix, list
+	if ((settings != NULL) && (settings->fdmSolver == MIXED_SOLVER))
+		fdmBytes = sizeof(double) + 5 * sizeof(float) + 2 * sizeof(int); // u, single precision gx, gy, gb, h, ah, pix, list
+	if ((settings != NULL) && (settings->fdmSolver == BLOCK_JACOBI_SOLVER))
+		fdmBytes += 2 * sizeof(double); // Preconditioned gradient and inverse diagonal of the strips
+	if ((settings != NULL) && (settings->fdmSolver == AMG_SOLVER))
+		fdmBytes += amgBytes;
+	if ((settings != NULL) && (settings->fdmBackbone >= 0.0) && (settings->fdmSolver != MIXED_SOLVER)) // Search arrays, reduced network and its multigrid (all sites kept at worst)
+		fdmBytes += 7 * sizeof(int) + 2 * sizeof(double) + amgBytes;
+
+	size_t bytes = planeBytes * (size_t)width * height;
+	size_t fdm = calcElectricConductivityWithFDM ? fdmBytes * (size_t)(width + 2) * (height + 2) : 0;
+
+	bool tiled = (settings != NULL) && (settings->tileSize > 0);
+	bool lattice = (settings != NULL) && settings->isLattice;
+	for (size_t r = 0; !lattice && (r < studyPixelsPerMinimumSize.size()); r++)
+	{
+		double scale = (double)studyPixelsPerMinimumSize[r] / pixelsPerMinimumSize;
+		size_t sWidth = (size_t)lround(width * scale);
+		size_t sHeight = (size_t)lround(height * scale);
+		if (tiled) // One tile in memory at a time, no FDM
+			bytes += planeBytes * (size_t)settings->tileSize * settings->tileSize;
+		else
 		{
-			sRectangle->width = rectWidth;   // Use original width
-			sRectangle->height = rectHeight; // Use original height
-			digitizeSlopedRectangle(ingradient, *sRectangle, grid, CellState::SOFT); // Draw particle boundary as SOFT
+			bytes += planeBytes * sWidth * sHeight;
+			if (calcElectricConductivityWithFDM) // FDM systems are solved one after the other
+				fdm = std::max(fdm, fdmBytes * (sWidth + 2) * (sHeight + 2));
 		}
-		// Draw the "hole" (inner part of the particle) as HARD (matrix phase)
-		SlopedRectangle sRectWithHoop(Point(sRectangle->center.x, sRectangle->center.y), rectWidth - hoop, rectHeight - hoop, sRectangle->slope);
-		digitizeSlopedRectangle(ingradient, sRectWithHoop, grid, &sRectangle->realArea, CellState::HARD); // Draw inner hole as HARD
 	}
+	return bytes + fdm;
 }
 
 // Performs Monte Carlo simulations
@@ -667,34 +1316,202 @@ void ShapeGenerator::monteCarlo(void)
 	double meanRVEPathWidth = 0;        // Mean path width
 	int totalConductivesRSE = 0;        // Count of RSEs that conducted
 
-	cout << "--------------------------------------------------------------------------------------------------------------\n";
-	cout << "Pixels Per minimum Size (ppms)=" << pixelsPerMinimumSize << "\n";
-	cout << "Minimum Size " << min << "\n"; // Note: 'min' is a global or member variable, not passed as argument
-	cout << "Factor [ppms/ minimumSize]" << factor << "\n";
+	LOG_INFO("--------------------------------------------------------------------------------------------------------------\n"
+		<< "Pixels Per minimum Size (ppms)=" << pixelsPerMinimumSize << "\n"
+		<< "Minimum Size " << min << "\n" // Note: 'min' is a global or member variable, not passed as argument
+		<< "Factor [ppms/ minimumSize]" << factor << "\n");
+	LogRate caseProgress(1.0); // One progress line per second at most
+
+	// Saved realizations replayed instead of new ones (settings replayCases), this sets the iterations
+	bool replay = openReplay();
+
+	// Results per case, as many as the iterations of this input
+	size_t cases = (size_t)iterations;
+	realComponentAreas.assign(maxComponents * cases, 0);
+	Results.assign(cases, 0);
+	FDResults.assign(2 * cases, 0);
+	Times.assign(cases, 0);
+	setUpTimes.assign(cases, 0);
+	paths.assign(cases, 0);
+	meanPathLength.assign(cases, 0);
+	meanRealPathLength.assign(cases, 0);
+	electricConductivity.assign(cases, 0);
+	thermalConductivities.assign(cases, 0);
+	YoungModulus.assign(cases, 0);
+	PoissonRatio.assign(cases, 0);
+	meanRVEResistances.assign(cases, 0);
+	meanRVEThermalResistance.assign(cases, 0);
+	meanRVEYoungModulus.assign(cases, 0);
+	meanRVEPoissoonRatio.assign(cases, 0);
+	seeds.assign(cases, 0);
+	FDIterations.assign(cases, 0);
+	phaseTimes.assign(cases, PhaseTimes());
+	caseClusters.assign(cases, 0);
+	caseMaxClusterPoints.assign(cases, 0);
+	caseMaxClusterRadius.assign(cases, 0);
+	caseCorrelationLengths.assign(cases, 0);
+
+	// Grids of the resolution study (same domain, different pixel size)
+	vector<Grid*> studyGrids;
+	vector<TiledGrid*> studyTiledGrids; // Lazy grids (settings tileSize > 0), NULL entries otherwise
+	if (settings->isLattice)
+		studyPixelsPerMinimumSize.clear(); // Lattice cases have no particle geometry to re-rasterize
+	for (size_t r = 0; r < studyPixelsPerMinimumSize.size(); r++)
+	{
+		double scale = (double)studyPixelsPerMinimumSize[r] / pixelsPerMinimumSize;
+		int sWidth = (int)lround(grid->width * scale);
+		int sHeight = (int)lround(grid->height * scale);
+		if (settings->tileSize > 0) // Rasterized tile by tile, never held in memory as a whole
+		{
+			TiledGrid* tGrid = new TiledGrid(sWidth, sHeight, settings->tileSize);
+			tGrid->periodic = grid->periodic;
+			studyTiledGrids.push_back(tGrid);
+			studyGrids.push_back(NULL);
+		}
+		else
+		{
+			Grid* sGrid = new Grid(sWidth, sHeight);
+			sGrid->periodic = grid->periodic;
+			studyGrids.push_back(sGrid);
+			studyTiledGrids.push_back(NULL);
+		}
+		LOG_INFO("Resolution study: ppms=" << studyPixelsPerMinimumSize[r] << " on " << sWidth << "x" << sHeight << " grid"
+			<< ((settings->tileSize > 0) ? " (tiles of " + to_string(settings->tileSize) + "x" + to_string(settings->tileSize) + ")" : string()) << "\n");
+	}
+	size_t studyEntries = studyPixelsPerMinimumSize.size() * iterations;
+	studyResults.assign(studyEntries, 0);
+	studyRealAreas.assign(studyEntries, 0);
+	studyPaths.assign(studyEntries, 0);
+	studyElectricConductivity.assign(studyEntries, 0);
+	studyFDResults.assign(2 * studyEntries, 0);
+	studyTimes.assign(studyEntries, 0);
+	studyClusters.assign(studyEntries, 0);
+	studyMaxClusterSize.assign(studyEntries, 0);
+
+	// Finished realizations of an interrupted run (settings resume): the run continues after them
+	int first = restoreCheckpoint();
+
+	// Progress of the run for the status file (if the batch writes one)
+	JobProgress* job = attachedJobProgress();
+	if (job != NULL)
+	{
+		job->iterations = iterations;
+		job->first = first;
+		job->completed = first;
+		job->loopStart = job->seconds();
+		job->lastProgress = job->seconds();
+	}
+	auto addCase = [&](int k) { // Adds a finished case to the sums, as accumulated in the loop below
+		if (Results[k])
+		{
+			sumPathLength += (meanRealPathLength[k] * paths[k]);
+			sumPaths += paths[k];
+			sumPercolation += Results[k];
+		}
+		sumTime += Times[k];
+		sumSetupTime += setUpTimes[k];
+		if (paths[k] > 0)
+			totalConductivesRSE++;
+		sumElectricConductivity += electricConductivity[k];
+		sumThemalConductivity += thermalConductivities[k];
+		sumYoungModulus += YoungModulus[k];
+		sumPoissonRatio += PoissonRatio[k];
+	};
+	for (int k = 0; k < first; k++) // Sums of the finished cases
+		addCase(k);
+	if (sumPaths > 0)
+		meanRVEPathLength = sumPathLength / sumPaths;
+	int finished = first; // Finished cases (of this rank, when the ranks share the realizations)
+
+	// Ranks sharing the realizations (MPI) take the next case from a shared counter, so faster
+	// ranks take more; the results of all ranks are merged into rank 0 every checkpointInterval
+	// cases (for its checkpoints) and after the last one
+	bool shared = distributed.sharesRealizations();
+	int merged = first; // Cases in rank 0's results, the same on every rank
+	if (shared)
+	{
+		int64_t restored = first; // Only rank 0 restores the checkpoint
+		distributed.fromRoot(restored);
+		merged = (int)restored;
+	}
+	auto nextMerge = [&]() {
+		int interval = settings->checkpointInterval;
+		return (interval > 0) ? std::min(iterations, (merged / interval + 1) * interval) : iterations;
+	};
+
+	// One binary shapes file for all realizations of this input. Ranks sharing the realizations write the
+	// cases they run to files of their own, merged into it by rank 0 (see mergeShapes): the files of an
+	// interrupted run before the ranks open theirs again, and those of this run after the last case.
+	bool binaryShapes = settings->saveShapes && (settings->shapesFormat != TEXT_SHAPES) && !settings->isLattice && !replay && (first < iterations);
+	if (shared && binaryShapes && (distributed.rank == 0))
+		mergeShapes(first);
+	if (shared)
+		distributed.resetCounter(first); // Collective: no rank opens its shapes file before rank 0's merge
+	if (binaryShapes)
+	{
+		if (shared)
+			shapesWriter.open(projectName + "/shapes/shapes." + to_string(distributed.rank) + ".bin", grid->width, grid->height, totalComponents,
+				settings->shapesFormat == BINARY32_SHAPES, settings->compressShapes);
+		else if (first > 0)
+			shapesWriter.resume(projectName + "/shapes/shapes.bin", grid->width, grid->height, totalComponents,
+				settings->shapesFormat == BINARY32_SHAPES, settings->compressShapes, first);
+		else
+			shapesWriter.open(projectName + "/shapes/shapes.bin", grid->width, grid->height, totalComponents,
+				settings->shapesFormat == BINARY32_SHAPES, settings->compressShapes);
+	}
 
-	for (int i = 0; i < iterations; i++) // Loop for each Monte Carlo iteration
+	// Per realization results, appended as every case ends (by rank 0 after the merge when the ranks share them)
+	if ((first < iterations) && (!shared || (distributed.rank == 0)))
+		openResultsFile(first);
+
+	for (int i = shared ? (int)distributed.next() : first; i < iterations; i = shared ? (int)distributed.next() : i + 1) // Loop for each Monte Carlo iteration
 	{
-		std::seed_seq seed{ r(), r(), r(), r(), r(), r(), r(), r(), r() }; // Seed for random number engine
+		// A rank that takes a case past the next merge has finished all its cases before it, and so
+		// have the others once all of them have taken one: the merge is collective (every rank merges
+		// at every boundary, the ones after its last case once it leaves the loop)
+		while (shared && (i >= nextMerge()))
+		{
+			int to = nextMerge();
+			mergeCases(merged, to);
+			merged = to;
+		}
+
+		// 64 bit seed of the case, kept in the results file so the realization can be generated again
+		seeds[i] = ((uint64_t)r() << 32) | r();
+		std::seed_seq seed{ (uint32_t)seeds[i], (uint32_t)(seeds[i] >> 32) }; // Seed for random number engine
 		eng.seed(seed); // Apply the seed
+		if (job != NULL)
+			job->currentCase = i;
 
-		cout << "\n--------------------------------------------";
-		cout << "Case " << setw(6) << (i + 1) << " of " << setw(6) << iterations;
-		cout << "--------------------------------------------\n";
+		LOG_DETAIL("\n--------------------------------------------"
+			<< "Case " << setw(6) << (i + 1) << " of " << setw(6) << iterations
+			<< "--------------------------------------------\n");
 		string Base;
 
 		// Determine output image file extension
-		if (!settings->saveAsBmpImage)
+		if (settings->imageFormat == PNG_IMAGE)
+			Base = "_Result.png";
+		else if (settings->imageFormat == PGM_IMAGE)
 			Base = "_Result.pgm";
 		else
 			Base = "_Result.bmp";
 		Results[i] = 0; // Initialize result for current case
-		grid->clear();  // Clear the grid for a new simulation
+		phaseTimes[i] = {};
+		attachPhaseTimes(&phaseTimes[i]); // Phases timed from here on belong to this case
+		{
+			ScopedTimer timer(CLEAR_PHASE);
+			grid->clear(); // Clear the grid for a new simulation
+		}
 
 		// Setup the case (lattice or detailed shape generation)
 		if (settings->isLattice)
 			setupCaseLattice(i, &setUpTimes[i]);
+		else if (replay)
+			replayCase(i, replayCases[i], &setUpTimes[i]);
 		else
 			setupCase(i, &setUpTimes[i]);
+		if (shapesWriter.isOpen())
+			shapesWriter.append(i, particles); // Geometry of the realization to the shapes file
 
 		// Initialize path-related variables for current case
 		paths[i] = 0;
@@ -722,14 +1539,14 @@ void ShapeGenerator::monteCarlo(void)
 		if (!Results[i]) // If RSE did not percolate
 		{
 			paths[i] = 0; // No paths found
-			cout << sPercolate[Results[i]]; // "RSE not percolated\n";
+			LOG_DETAIL(sPercolate[Results[i]]); // "RSE not percolated\n";
 		}
 		else // If RSE percolated
 		{
 			sumPathLength += (meanRealPathLength[i] * paths[i]); // Accumulate path length
 			sumPaths += paths[i];         // Accumulate total paths
 			sumPercolation += Results[i]; // Accumulate percolation success
-			cout << sPercolate[Results[i]]; // "RSE percolated\n";
+			LOG_DETAIL(sPercolate[Results[i]]); // "RSE percolated\n";
 		}
 
 		sumTime += Times[i];       // Accumulate simulation time
@@ -750,8 +1567,13 @@ void ShapeGenerator::monteCarlo(void)
 			PoissonRatio[i] = meanRVEPoissoonRatio[i];               // Poisson's ratio
 			totalConductivesRSE++;                                    // Increment count of conductive RSEs
 		}
-		// Print current percolation probability
-		cout << "RSE's Percolation Probability:" << ((1.0 * totalConductivesRSE) / (i + 1.0)) * 100.0 << "% \n";
+		finished++;
+		// Print current percolation probability (once per second at most, every case at the detail level)
+		if (logEnabled(DETAIL_LOG))
+			LOG_DETAIL("RSE's Percolation Probability:" << ((1.0 * totalConductivesRSE) / finished) * 100.0 << "% \n");
+		else
+			LOG_EVERY(INFO_LOG, caseProgress, projectName << ": case " << (i + 1) << " of " << iterations
+				<< ", RSE's Percolation Probability:" << ((1.0 * totalConductivesRSE) / finished) * 100.0 << "% \n");
 
 		// Accumulate material properties for overall mean calculation
 		sumElectricConductivity += electricConductivity[i];
@@ -762,39 +1584,43 @@ void ShapeGenerator::monteCarlo(void)
 		// Calculate electric conductivity using Finite Differences Method if enabled
 		if (calcElectricConductivityWithFDM)
 		{
-			cout << "--------------------------------------------------------------------------------------------------------------\n";
-			cout << "Calculate Electric conductivity with Finite Differences Method..\n";
-			int x = this->grid->width;
-			int y = x; // Assuming square grid for FDM
-			FD2DEL fd2Del(totalComponents, maxComponents); // Create FDM solver object
-			fd2Del.initValues(x, y);                       // Initialize values
-			fd2Del.intitArrays();                          // Initialize arrays
-			fd2Del.readFromArray(this->grid->ingadients, materialsElectricConductivity); // Read material data from grid
-			char m[] = "m1.dat";   // Input file for FDM (not directly used in `run` with grid data)
-			char out[] = "out.bmp"; // Output bitmap file name
-
-			fd2Del.run(m, out, totalComponents); // Run FDM simulation
-
-			generateBitmapImageFortranStyle(fd2Del.pix, height + 2, width + 2, out); // Generate bitmap image
-
-			FDResults[i * 2] = fd2Del.currx;     // Store FDM result for x-direction
-			FDResults[i * 2 + 1] = fd2Del.curry; // Store FDM result for y-direction
+			LOG_DETAIL("--------------------------------------------------------------------------------------------------------------\n"
+				<< "Calculate Electric conductivity with Finite Differences Method..\n");
+			string out = projectName + "/out.bmp"; // Output bitmap file name (per project: inputs may run concurrently)
+			double currX = 0, currY = 0;
+			solveFDM(this->grid, &currX, &currY, &out[0u], &FDIterations[i]); // Run FDM simulation
+
+			FDResults[i * 2] = (float)currX;     // Store FDM result for x-direction
+			FDResults[i * 2 + 1] = (float)currY; // Store FDM result for y-direction
+		}
+
+		// Same geometry at the other resolutions of the study
+		if (!studyGrids.empty())
+		{
+			LOG_DETAIL("--------------------------------------------------------------------------------------------------------------\n"
+				<< "Resolution study..\n");
+			resolutionStudy(i, studyGrids, studyTiledGrids);
 		}
 
 		// Calculate statistics if enabled
+		double corrLength = 0; // Correlation length of the case
 		if (this->calcStatistcs)
 		{
-			cout << "--------------------------------------------------------------------------------------------------------------\n";
-			cout << "Calculate Statistics.. Mark Clusters,";
+			LOG_DETAIL("--------------------------------------------------------------------------------------------------------------\n"
+				<< "Calculate Statistics.. Mark Clusters,");
 
 			// Cluster cCluster = grid->markClusters(); // Mark clusters (commented out)
-			double corrLength = grid->findCorrelationLength(grid->Clusters); // Find correlation length
-			cout << "Correlation length=" << corrLength << "\n";
+			{
+				ScopedTimer timer(CLUSTERS_PHASE);
+				corrLength = grid->findCorrelationLength(grid->Clusters); // Find correlation length
+			}
+			LOG_DETAIL("Correlation length=" << corrLength << "\n");
 
 			correleationLengths.push_back(corrLength); // Store correlation length
 		}
 
-		char* fileName = "cluster.bmp"; // Filename for cluster image
+		string clusterFileName = projectName + "/cluster.bmp"; // Filename for cluster image (per project)
+		char* fileName = &clusterFileName[0u];
 
 		// Save image file if enabled
 		if (settings->saveImageFile)
@@ -804,14 +1630,16 @@ void ShapeGenerator::monteCarlo(void)
 
 			if (!settings->RandomSaveImageFile) // Save at fixed intervals
 			{
-				if (i % (iterations / settings->totalImagesToSave) == 0) // Check if it's time to save
+				if (i % std::max(1, iterations / settings->totalImagesToSave) == 0) // Check if it's time to save
 				{
-					cout << "Save image file .. " << FileName << "\n";
-					grid->saveToDisk(&FileName[0u], settings->saveAsBmpImage); // Save grid to disk
+					LOG_DETAIL("Save image file .. " << FileName << "\n");
+					grid->saveToDisk(&FileName[0u], settings->imageFormat); // Save grid to disk
 					if (calcStatistcs)
 					{
-						saveClustersAsBitmapImage(grid->cluster, grid->height, grid->width, 0xAA, fileName); // Save clusters as image
-						cout << "\nSave Clusters as image\n";
+						queueImageSnapshot(grid->cluster, grid->height, grid->width, fileName, [](unsigned char* image, int height, int width, char* name) {
+							saveClustersAsBitmapImage(image, height, width, 0xAA, name);
+							}); // Save clusters as image
+						LOG_DETAIL("\nSave Clusters as image\n");
 					}
 				}
 			}
@@ -819,13 +1647,53 @@ void ShapeGenerator::monteCarlo(void)
 			{
 				if ((rand() % iterations) < settings->totalImagesToSave) // Random chance to save
 				{
-					cout << "Save images files .. " << FileName << "\n";
-					grid->saveToDisk(&FileName[0u], settings->saveAsBmpImage); // Save grid to disk
+					LOG_DETAIL("Save images files .. " << FileName << "\n");
+					grid->saveToDisk(&FileName[0u], settings->imageFormat); // Save grid to disk
 				}
 			}
 		}
+		attachPhaseTimes(NULL);
+		summarizeCase(i, corrLength);
+		if (!shared)
+			appendResults(i); // Record of the case, on disk before the next one starts
+		if (job != NULL)
+		{
+			job->completed = finished;
+			job->lastProgress = job->seconds();
+		}
+
+		// Periodic checkpoint (and one at the end), so an interrupted run can continue after this case
+		if (!shared && (settings->checkpointInterval > 0) && (((i + 1) % settings->checkpointInterval == 0) || (i + 1 == iterations)))
+			saveCheckpoint(i + 1);
 	}
 
+	// Results of all ranks in rank 0, its sums those of a serial run
+	if (shared)
+	{
+		if (binaryShapes)
+		{
+			shapesWriter.close();
+			outputQueue.flush(); // On disk before rank 0 takes the sums (and then the files)
+		}
+		do
+		{
+			int to = nextMerge();
+			mergeCases(merged, to);
+			merged = to;
+		} while (merged < iterations);
+		if (binaryShapes && (distributed.rank == 0))
+			mergeShapes(iterations);
+		sumPercolation = sumTime = sumSetupTime = sumElectricConductivity = sumThemalConductivity = sumYoungModulus = sumPoissonRatio = 0;
+		sumPaths = sumPathLength = 0;
+		totalConductivesRSE = 0;
+		for (int k = 0; k < iterations; k++)
+			addCase(k);
+		meanRVEPathLength = (sumPaths > 0) ? sumPathLength / sumPaths : 0;
+	}
+	shapesWriter.close(); // Index of the shapes file
+	resultsFile.close();
+	shapesReader.close();
+
 	// Calculate overall mean values after all iterations
 	meanRVEPaths = sumPaths / iterations;                      // Mean paths per RVE
 	meanPercolation = sumPercolation / iterations;             // Mean percolation probability
@@ -860,20 +1728,26 @@ void ShapeGenerator::monteCarlo(void)
 	}
 
 	// Print final results
-	cout << "-----------------------------------Results (RSE)-------------------------------------------------------------\n";
-	cout << "Mean Percolation  =" << meanPercolation << "\n";
-	cout << "Mean Process Time  =" << meanTime << "\n";
-	cout << "Mean SetUp Time  =" << meanSetUpTime << "\n";
-	cout << "Mean Paths per RSE=" << meanRVEPaths << "\n";
-	cout << "Mean Paths Length per RSE=" << meanRVEPathLength << "\n";
-	cout << "Mean path Width =" << meanRVEPathWidth << "\n";
-	cout << "Mean Special Electric Conductivity =" << meanElectricConductivity << "\n";
-	cout << "Mean Special Thermal Conductivity =" << meanThermalConductivity << "\n";
-	cout << "Mean Young Modulus =" << meanYoungModulus << "\n";
-	cout << "Mean Poisson Ratio " << meanPoissonRatio << "\n";
-	cout << "--------------------------------------------------------------------------------------------------------------\n";
+	LOG_INFO("-----------------------------------Results (RSE)-------------------------------------------------------------\n"
+		<< "Mean Percolation  =" << meanPercolation << "\n"
+		<< "Mean Process Time  =" << meanTime << "\n"
+		<< "Mean SetUp Time  =" << meanSetUpTime << "\n"
+		<< "Mean Paths per RSE=" << meanRVEPaths << "\n"
+		<< "Mean Paths Length per RSE=" << meanRVEPathLength << "\n"
+		<< "Mean path Width =" << meanRVEPathWidth << "\n"
+		<< "Mean Special Electric Conductivity =" << meanElectricConductivity << "\n"
+		<< "Mean Special Thermal Conductivity =" << meanThermalConductivity << "\n"
+		<< "Mean Young Modulus =" << meanYoungModulus << "\n"
+		<< "Mean Poisson Ratio " << meanPoissonRatio << "\n"
+		<< "--------------------------------------------------------------------------------------------------------------\n");
 
 	grid->clear(); // Clear the grid at the end of the simulation
+
+	for (size_t r = 0; r < studyGrids.size(); r++)
+	{
+		delete studyGrids[r];
+		delete studyTiledGrids[r];
+	}
 }
 
 void ShapeGenerator::calcMeanCorrellationLength()
@@ -891,14 +1765,13 @@ void ShapeGenerator::saveResultstoReport(ReportType ireportType)
 {
     string seperator; // Separator character for CSV (comma or semicolon)
     string FileName;  // Name of the report file
-    ofstream File;    // Output file stream
+    ostringstream File; // Report text, written as a whole on the output queue
 
     // Determine separator and filename based on report type
     if (ireportType == SEMICOLON)
     {
         seperator = ";";
         FileName = projectName + "/ReportWithSemicolon.csv";
-        File.open(FileName);
         std::locale cpploc{ "" }; // Set locale for correct number formatting
         File.imbue(cpploc);
     }
@@ -906,7 +1779,6 @@ void ShapeGenerator::saveResultstoReport(ReportType ireportType)
     {
         seperator = ",";
         FileName = projectName + "/report.csv";
-        File.open(FileName);
     }
 
     // Write general information to the report
@@ -945,6 +1817,7 @@ void ShapeGenerator::saveResultstoReport(ReportType ireportType)
     File << "Maximum Dimension:" << seperator << max << "\n"; // Max dimension used in generation
     File << "Minimum Dimension:" << seperator << min << "\n"; // Min dimension used in generation
     File << "Grid size" << seperator << grid->width << seperator << "x" << seperator << grid->height << "\n";
+    File << "Periodic boundaries:" << seperator << (grid->periodic ? "TRUE" : "FALSE") << "\n";
     File << "Total iterations: " << seperator << iterations << "\n";
 
     File << "---------------------------------------------------------------------------------------------------\n";
@@ -982,7 +1855,7 @@ void ShapeGenerator::saveResultstoReport(ReportType ireportType)
         }
         // Write statistics results if enabled
         if (calcStatistcs)
-            File << seperator << setw(13) << this->grid->cMaxClusterRadius[i]
+            File << seperator << setw(13) << caseMaxClusterRadius[i]
             << seperator << setw(13) << correleationLengths[i];
         double eleCondu;
         // Calculate electric conductivity based on paths
@@ -1036,7 +1909,92 @@ void ShapeGenerator::saveResultstoReport(ReportType ireportType)
 
         File << "Mean Area of component[" << j << "]=" << seperator << mean << "\n";
     }
-    File.close(); // Close the report file
+
+    // Write the resolution study (same geometry at every ppms)
+    if (!studyPixelsPerMinimumSize.empty())
+    {
+        File << "---------------------------------------------------------------------------------------------------\n";
+        File << "Resolution study\n";
+        File << "Realization No" << seperator << "ppms" << seperator << "Percolate" "Y[1]/N[0]" << seperator << "% Real Area" << seperator
+            << "Total Conductive Paths" << seperator << "Current Electric Conductivity" << seperator << "FDM Ix" << seperator << "FDM Iy" << seperator << "Process Time" << seperator << "Clusters (tiled)" << seperator << "Max Cluster Size (tiled)" << "\n";
+        for (int i = 0; i < iterations; i++)
+        {
+            // Generation resolution first, then the re-rasterized ones
+            double realArea = 0;
+            for (int j = 1; j < totalComponents; j++)
+                realArea = realArea + realComponentAreas[i * totalComponents + j];
+            double eleCondu = (paths[i] > 0) ? (1 / this->meanRVEResistances[i]) * this->paths[i] / width : 0;
+            File << setw(7) << i + 1 << seperator << setw(6) << pixelsPerMinimumSize << seperator << setw(6) << Results[i] << seperator << setw(13) << realArea
+                << seperator << setw(13) << paths[i] << seperator << setw(13) << eleCondu
+                << seperator << setw(13) << FDResults[2 * i] << seperator << setw(13) << FDResults[2 * i + 1] << seperator << setw(13) << Times[i] << seperator << seperator << "\n";
+            for (size_t r = 0; r < studyPixelsPerMinimumSize.size(); r++)
+            {
+                size_t n = r * iterations + i;
+                File << setw(7) << i + 1 << seperator << setw(6) << studyPixelsPerMinimumSize[r] << seperator << setw(6) << studyResults[n] << seperator << setw(13) << studyRealAreas[n]
+                    << seperator << setw(13) << studyPaths[n] << seperator << setw(13) << studyElectricConductivity[n]
+                    << seperator << setw(13) << studyFDResults[2 * n] << seperator << setw(13) << studyFDResults[2 * n + 1] << seperator << setw(13) << studyTimes[n]
+                    << seperator << setw(13) << studyClusters[n] << seperator << setw(13) << studyMaxClusterSize[n] << "\n";
+            }
+        }
+
+        // Mean values per resolution
+        File << "ppms" << seperator << "Mean Percolation" << seperator << "Mean % Real Area" << seperator << "Mean Paths" << seperator
+            << "Mean Electric Conductivity" << seperator << "Mean FDM Ix" << seperator << "Mean FDM Iy" << "\n";
+        for (size_t r = 0; r < studyPixelsPerMinimumSize.size(); r++)
+        {
+            double sumPercolation = 0, sumArea = 0, sumPaths = 0, sumConductivity = 0, sumIx = 0, sumIy = 0;
+            for (int i = 0; i < iterations; i++)
+            {
+                size_t n = r * iterations + i;
+                sumPercolation += studyResults[n];
+                sumArea += studyRealAreas[n];
+                sumPaths += studyPaths[n];
+                sumConductivity += studyElectricConductivity[n];
+                sumIx += studyFDResults[2 * n];
+                sumIy += studyFDResults[2 * n + 1];
+            }
+            File << studyPixelsPerMinimumSize[r] << seperator << sumPercolation / iterations << seperator << sumArea / iterations << seperator << sumPaths / iterations
+                << seperator << sumConductivity / iterations << seperator << sumIx / iterations << seperator << sumIy / iterations << "\n";
+        }
+    }
+
+    // Wall and CPU time per phase over all realizations, with a histogram of the per realization wall times
+    File << "---------------------------------------------------------------------------------------------------\n";
+    File << "Phase times (wall: steady clock; CPU: all threads of the process, not taken for rasterize and DFS; phases nest: percolate includes DFS, BFS and path properties, placement includes rasterize)\n";
+    File << std::defaultfloat << std::setprecision(6);
+    File << "Phase" << seperator << "Calls" << seperator << "Total Wall (s)" << seperator << "Mean Wall (s)" << seperator << "Min Wall (s)" << seperator
+        << "Max Wall (s)" << seperator << "Total CPU (s)" << seperator << "CPU/Wall";
+    for (int b = 0; b < phaseHistogramBins; b++)
+        File << seperator << phaseHistogramLabels[b];
+    File << "\n";
+    for (int p = 0; p < TIMER_PHASES; p++)
+    {
+        double totalWall = 0, totalCpu = 0, minWall = 0, maxWall = 0;
+        uint64_t calls = 0;
+        int histogram[phaseHistogramBins] = {};
+        for (int i = 0; i < iterations; i++)
+        {
+            double wall = phaseTimes[i].wall[p];
+            totalWall += wall;
+            totalCpu += phaseTimes[i].cpu[p];
+            calls += phaseTimes[i].calls[p];
+            minWall = (i == 0) ? wall : std::min(minWall, wall);
+            maxWall = std::max(maxWall, wall);
+            histogram[phaseHistogramBin(wall)]++;
+        }
+        if (calls == 0) // Phase not run (analysis disabled)
+            continue;
+        File << setw(15) << timerPhaseNames[p] << seperator << setw(9) << calls << seperator << setw(13) << totalWall << seperator << setw(13) << totalWall / iterations
+            << seperator << setw(13) << minWall << seperator << setw(13) << maxWall << seperator;
+        if (totalCpu > 0)
+            File << setw(13) << totalCpu << seperator << setw(9) << ((totalWall > 0) ? totalCpu / totalWall : 0);
+        else // Wall time only
+            File << setw(13) << "" << seperator << setw(9) << "";
+        for (int b = 0; b < phaseHistogramBins; b++)
+            File << seperator << setw(6) << histogram[b];
+        File << "\n";
+    }
+    outputQueue.writeFile(FileName, File.str()); // Write the report file
 }
 
 // Saves results to a report with comma as a separator
@@ -1054,12 +2012,10 @@ void ShapeGenerator::ReportWithSemicolon()
 // Generates and saves a statistics report
 void ShapeGenerator::ReportStatistics(string seperator)
 {
-    ofstream File; // Output file stream
+    ostringstream File; // Report text, written as a whole on the output queue
 
     string FileName = projectName + "/Statistics.csv"; // Statistics report filename
 
-    File.open(FileName); // Open the file
-
     File << info.program;  // Program name
     File << info.version;  // Program version
 
@@ -1097,7 +2053,7 @@ void ShapeGenerator::ReportStatistics(string seperator)
         File << "\n";
     }
     File << "---------------------------------------------------------------------------------------------------\n";
-    File.close(); // Close the file
+    outputQueue.writeFile(FileName, File.str()); // Write the report file
 }
 
 // Generates and saves a statistics report with semicolon as a separator (default)
@@ -1145,164 +2101,182 @@ Ellipse ShapeGenerator::generateEllipse(Point downleft, Point upRight, double ia
     return Result; // Return the generated ellipse
 }
 
-// Digitizes a sloped rectangle onto the grid without calculating real area
-void ShapeGenerator::digitizeSlopedRectangle(int ingradient, SlopedRectangle sRect, Grid* iGrid, CellState state)
+// Digitizes particle k as a sloped rectangle onto the grid without calculating real area
+void ShapeGenerator::digitizeSlopedRectangle(const ParticleSet& iParticles, size_t k, double rectWidth, double rectHeight, Grid* iGrid, CellState state)
 {
     int i, j;
+    double centerX = iParticles.centerX[k];   // Rectangle center
+    double centerY = iParticles.centerY[k];
+    double cosTheta = iParticles.cosTheta[k]; // Precomputed rotation
+    double sinTheta = iParticles.sinTheta[k];
+    double halfWidth = rectWidth / 2.0;
+    double halfHeight = rectHeight / 2.0;
+    unsigned char ingradient = iParticles.component[k];
+    double extentX = iParticles.rectangleExtentX(k, rectWidth, rectHeight);
+    double extentY = iParticles.rectangleExtentY(k, rectWidth, rectHeight);
+
     // Calculate the bounding box (region) for iterating over grid cells
-    Range region(iGrid->toLocaldimensionsDown(sRect.minX() - 1, sRect.minY() - 1), iGrid->toLocaldimensionsUp(sRect.maxX() + 1, sRect.maxY() + 1));
-
-    // Clamp region coordinates to grid boundaries
-    if (region.from.x < 0)
-        region.from.x = 0;
-    if (region.from.y < 0)
-        region.from.y = 0;
-    if (region.to.x > iGrid->width)
-        region.to.x = iGrid->width;
-    if (region.to.y > iGrid->height)
-        region.to.y = iGrid->height;
+    Range region(iGrid->toLocaldimensionsDown(centerX - extentX - 1, centerY - extentY - 1), iGrid->toLocaldimensionsUp(centerX + extentX + 1, centerY + extentY + 1));
+
+    // Clamp region coordinates to grid boundaries (one period on periodic grids)
+    iGrid->clipRegion(&region);
 
     // Iterate over grid cells within the bounding box
     for (i = region.from.x; i < region.to.x; i++)
         for (j = region.from.y; j < region.to.y; j++)
         {
-            // Transform (rotate) the current grid cell's coordinates back to the rectangle's local coordinate system
-            Point rotated = Point::transform(i, j, sRect.center.x, sRect.center.y, -sRect.slope);
+            // Rotate the grid cell by -slope into the rectangle's local coordinate system
+            double dx = i - centerX;
+            double dy = j - centerY;
+            double rotatedX = dx * cosTheta - dy * sinTheta;
+            double rotatedY = dx * sinTheta + dy * cosTheta;
+            int x = i, y = j; // Grid cell to write (wrapped on periodic grids)
+            iGrid->wrap(&x, &y, true);
             // Check if the rotated point is inside the rectangle's dimensions
-            if ((1.0 * rotated.x <= (1.0 * sRect.center.x + (sRect.width / 2.0)))
-                && (1.0 * rotated.x >= (1.0 * sRect.center.x - (sRect.width / 2.0)))
-                && (1.0 * rotated.y <= (1.0 * sRect.center.y + (sRect.height / 2.0)))
-                && (1.0 * rotated.y >= (1.0 * sRect.center.y - (sRect.height / 2.0))))
+            if ((rotatedX <= halfWidth) && (rotatedX >= -halfWidth) && (rotatedY <= halfHeight) && (rotatedY >= -halfHeight))
             {
                 if (state == CellState::HARD) // If drawing a HARD cell
                 {
-                    iGrid->set(i, j, state);                  // Set cell state to HARD
-                    iGrid->ingadients[j * width + i] = (unsigned char)(ingradient); // Set component gradient
+                    iGrid->set(x, y, state);                  // Set cell state to HARD
+                    iGrid->ingadients[y * iGrid->width + x] = ingradient; // Set component gradient
                 }
                 else // If drawing a SOFT cell (e.g., hoop)
-                    if (iGrid->get(i, j) != CellState::HARD) // Only set if not already HARD
+                    if (iGrid->get(x, y) != CellState::HARD) // Only set if not already HARD
                     {
-                        iGrid->ingadients[j * width + i] = (unsigned char)(ingradient); // Set component gradient
-                        iGrid->set(i, j, state); // Set cell state to SOFT
+                        iGrid->ingadients[y * iGrid->width + x] = ingradient; // Set component gradient
+                        iGrid->set(x, y, state); // Set cell state to SOFT
                     }
             }
         }
 }
 
-// Digitizes a sloped rectangle onto the grid and calculates its real area
-void ShapeGenerator::digitizeSlopedRectangle(int ingradient, SlopedRectangle sRect, Grid* iGrid, double* realArea, CellState state)
+// Digitizes particle k as a sloped rectangle onto the grid and calculates its real area
+void ShapeGenerator::digitizeSlopedRectangle(const ParticleSet& iParticles, size_t k, double rectWidth, double rectHeight, Grid* iGrid, double* realArea, CellState state)
 {
     int i, j;
+    double centerX = iParticles.centerX[k];   // Rectangle center
+    double centerY = iParticles.centerY[k];
+    double cosTheta = iParticles.cosTheta[k]; // Precomputed rotation
+    double sinTheta = iParticles.sinTheta[k];
+    double halfWidth = rectWidth / 2.0;
+    double halfHeight = rectHeight / 2.0;
+    unsigned char ingradient = iParticles.component[k];
+    double extentX = iParticles.rectangleExtentX(k, rectWidth, rectHeight);
+    double extentY = iParticles.rectangleExtentY(k, rectWidth, rectHeight);
+
     // Calculate the bounding box (region) for iterating over grid cells
-    Range region(iGrid->toLocaldimensionsDown(sRect.minX() - 1, sRect.minY() - 1), iGrid->toLocaldimensionsUp(sRect.maxX() + 1, sRect.maxY() + 1));
+    Range region(iGrid->toLocaldimensionsDown(centerX - extentX - 1, centerY - extentY - 1), iGrid->toLocaldimensionsUp(centerX + extentX + 1, centerY + extentY + 1));
     *realArea = 0; // Initialize real area count
 
-    // Clamp region coordinates to grid boundaries
-    if (region.from.x < 0)
-        region.from.x = 0;
-    if (region.from.y < 0)
-        region.from.y = 0;
-    if (region.to.x > iGrid->width)
-        region.to.x = iGrid->width;
-    if (region.to.y > iGrid->height)
-        region.to.y = iGrid->height;
+    // Clamp region coordinates to grid boundaries (one period on periodic grids)
+    iGrid->clipRegion(&region);
 
     // Iterate over grid cells within the bounding box
     for (i = region.from.x; i < region.to.x; i++)
         for (j = region.from.y; j < region.to.y; j++)
         {
-            // Transform (rotate) the center of the current grid cell back to the rectangle's local coordinate system
-            Point rotated = Point::transform(i + 0.5, j + 0.5, sRect.center.x, sRect.center.y, -sRect.slope);
+            // Rotate the center of the grid cell by -slope into the rectangle's local coordinate system
+            double dx = i + 0.5 - centerX;
+            double dy = j + 0.5 - centerY;
+            double rotatedX = dx * cosTheta - dy * sinTheta;
+            double rotatedY = dx * sinTheta + dy * cosTheta;
+            int x = i, y = j; // Grid cell to write (wrapped on periodic grids)
+            iGrid->wrap(&x, &y, true);
             // Check if the rotated point is inside the rectangle's dimensions
-            if ((rotated.x <= (sRect.center.x + (sRect.width / 2))) && (rotated.x >= (sRect.center.x - (sRect.width / 2))) && ((rotated.y <= (sRect.center.y + (sRect.height / 2))) && rotated.y >= (sRect.center.y - (sRect.height / 2))))
+            if ((rotatedX <= halfWidth) && (rotatedX >= -halfWidth) && (rotatedY <= halfHeight) && (rotatedY >= -halfHeight))
             {
-                char cPixel = iGrid->get(i, j); // Get current cell state
+                char cPixel = iGrid->get(x, y); // Get current cell state
                 if (state == CellState::HARD)    // If drawing a HARD cell
                 {
                     // If the cell is not already occupied by a hard phase or border (for "Swiss Cheese" effect)
                     if ((cPixel != 0) && (cPixel != CellState::HARD) && (cPixel != BORDER)) // in one step
                     {
-                        iGrid->ingadients[j * width + i] = (unsigned char)(ingradient); // Set component gradient
+                        iGrid->ingadients[y * iGrid->width + x] = ingradient; // Set component gradient
                         *realArea += 1.0; // Increment real area
                     }
-                    iGrid->set(i, j, state); // Set cell state to HARD
+                    iGrid->set(x, y, state); // Set cell state to HARD
                 }
                 else // If drawing a SOFT cell (e.g., hoop)
                     if (cPixel != CellState::HARD) // Only set if not already HARD
-                        iGrid->set(i, j, state); // Set cell state to SOFT
+                        iGrid->set(x, y, state); // Set cell state to SOFT
             }
         }
 }
 
-// Digitizes a sloped rectangle with a border onto the grid and calculates real area
-void ShapeGenerator::digitizeSlopedRectangleWithBorder(int ingradient, SlopedRectangle sRect, Grid* iGrid, double* realArea, CellState state)
+// Digitizes particle k as a sloped rectangle with a border onto the grid and calculates real area
+void ShapeGenerator::digitizeSlopedRectangleWithBorder(const ParticleSet& iParticles, size_t k, double rectWidth, double rectHeight, Grid* iGrid, double* realArea, CellState state)
 {
     int i, j;
     double zone = 0.90; // Defines the inner "core" zone as a percentage of the dimension
+    double centerX = iParticles.centerX[k];   // Rectangle center
+    double centerY = iParticles.centerY[k];
+    double cosTheta = iParticles.cosTheta[k]; // Precomputed rotation
+    double sinTheta = iParticles.sinTheta[k];
+    double halfWidth = rectWidth / 2.0;
+    double halfHeight = rectHeight / 2.0;
+    unsigned char ingradient = iParticles.component[k];
+    double extentX = iParticles.rectangleExtentX(k, rectWidth, rectHeight);
+    double extentY = iParticles.rectangleExtentY(k, rectWidth, rectHeight);
+
     // Calculate the bounding box (region) for iterating over grid cells
-    Range region(iGrid->toLocaldimensionsDown(sRect.minX() - 1, sRect.minY() - 1), iGrid->toLocaldimensionsUp(sRect.maxX() + 1, sRect.maxY() + 1));
+    Range region(iGrid->toLocaldimensionsDown(centerX - extentX - 1, centerY - extentY - 1), iGrid->toLocaldimensionsUp(centerX + extentX + 1, centerY + extentY + 1));
     *realArea = 0; // Initialize real area count
 
-    // Clamp region coordinates to grid boundaries
-    if (region.from.x < 0)
-        region.from.x = 0;
-    if (region.from.y < 0)
-        region.from.y = 0;
-    if (region.to.x > iGrid->width)
-        region.to.x = iGrid->width;
-    if (region.to.y > iGrid->height)
-        region.to.y = iGrid->height;
+    // Clamp region coordinates to grid boundaries (one period on periodic grids)
+    iGrid->clipRegion(&region);
 
     // Iterate over grid cells within the bounding box
     for (i = region.from.x; i < region.to.x; i++)
         for (j = region.from.y; j < region.to.y; j++)
         {
-            // Transform (rotate) the center of the current grid cell back to the rectangle's local coordinate system
-            Point rotated = Point::transform(i + 0.5, j + 0.5, sRect.center.x, sRect.center.y, -sRect.slope);
+            // Rotate the center of the grid cell by -slope into the rectangle's local coordinate system
+            double dx = i + 0.5 - centerX;
+            double dy = j + 0.5 - centerY;
+            double rotatedX = dx * cosTheta - dy * sinTheta;
+            double rotatedY = dx * sinTheta + dy * cosTheta;
+            int x = i, y = j; // Grid cell to write (wrapped on periodic grids)
+            iGrid->wrap(&x, &y, true);
 
             // Check if the rotated point is inside the overall rectangle's dimensions
-            if ((rotated.x <= (sRect.center.x + (sRect.width / 2))) && (rotated.x >= (sRect.center.x - (sRect.width / 2))) && ((rotated.y <= (sRect.center.y + (sRect.height / 2))) && rotated.y >= (sRect.center.y - (sRect.height / 2))))
+            if ((rotatedX <= halfWidth) && (rotatedX >= -halfWidth) && (rotatedY <= halfHeight) && (rotatedY >= -halfHeight))
             {
                 // Check if the point is within the "border" zone
-                if ((rotated.x <= sRect.center.x + (sRect.width / 2) && rotated.x >= sRect.center.x + (zone * sRect.width / 2)) ||
-                    (rotated.x >= sRect.center.x - (sRect.width / 2) && rotated.x <= sRect.center.x - (zone * sRect.width / 2)) ||
-                    (rotated.y <= sRect.center.y + (sRect.height / 2) && rotated.y >= sRect.center.y + (zone * sRect.height / 2)) ||
-                    (rotated.y >= sRect.center.y - (sRect.height / 2) && rotated.y <= sRect.center.y - (zone * sRect.height / 2)))
+                if ((rotatedX >= zone * halfWidth) || (rotatedX <= -zone * halfWidth) ||
+                    (rotatedY >= zone * halfHeight) || (rotatedY <= -zone * halfHeight))
                 {
                     if (state == CellState::HARD) // If drawing a HARD cell (core)
                     {
-                        if (iGrid->get(i, j) != 0) // If the cell is not empty
+                        if (iGrid->get(x, y) != 0) // If the cell is not empty
                         {
                             *realArea += 1.0; // Increment real area
-                            iGrid->ingadients[j * width + i] = (unsigned char)(ingradient); // Set component gradient
+                            iGrid->ingadients[y * iGrid->width + x] = ingradient; // Set component gradient
                         }
-                        iGrid->set(i, j, BORDER); // Set cell state to BORDER
+                        iGrid->set(x, y, BORDER); // Set cell state to BORDER
                     }
                     else // If drawing a SOFT cell (e.g., hoop)
-                        if (iGrid->get(i, j) != CellState::HARD) // Only set if not already HARD
-                            iGrid->set(i, j, BORDER); // Set cell state to BORDER
+                        if (iGrid->get(x, y) != CellState::HARD) // Only set if not already HARD
+                            iGrid->set(x, y, BORDER); // Set cell state to BORDER
                 }
                 else // Point is within the "core" of the rectangle
                     if (state == CellState::HARD) // If drawing a HARD cell (core)
                     {
-                        if (iGrid->get(i, j) != 0) // If the cell is not empty
+                        if (iGrid->get(x, y) != 0) // If the cell is not empty
                         {
                             *realArea += 1.0; // Increment real area
-                            iGrid->ingadients[j * width + i] = (unsigned char)(ingradient); // Set component gradient
+                            iGrid->ingadients[y * iGrid->width + x] = ingradient; // Set component gradient
                         }
-                        iGrid->set(i, j, state); // Set cell state to HARD
+                        iGrid->set(x, y, state); // Set cell state to HARD
                     }
                     else // If drawing a SOFT cell (e.g., hoop)
-                        if (iGrid->get(i, j) != CellState::HARD) // Only set if not already HARD
-                            iGrid->set(i, j, state); // Set cell state to SOFT
+                        if (iGrid->get(x, y) != CellState::HARD) // Only set if not already HARD
+                            iGrid->set(x, y, state); // Set cell state to SOFT
             }
         }
 }
 
-// Digitizes an ellipse onto the grid and calculates its real area using OpenMP for parallelization
-void ShapeGenerator::digitizeEllipse(int ingradient, Ellipse iEllipse, Grid* iGrid, double* realArea, CellState state)
+// Digitizes particle k as an ellipse onto the grid and calculates its real area using OpenMP for parallelization
+void ShapeGenerator::digitizeEllipse(const ParticleSet& iParticles, size_t k, double ia, double ib, Grid* iGrid, double* realArea, CellState state)
 {
-    // omp_set_num_threads(4); // Set number of OpenMP threads (commented out)
     *realArea = 0;      // Initialize real area count
     double subsum[4] = {}; // Array to store partial sums from parallel sections
 
@@ -1310,16 +2284,16 @@ void ShapeGenerator::digitizeEllipse(int ingradient, Ellipse iEllipse, Grid* iGr
 #pragma omp sections nowait // Divide work into sections, no waiting at the end of each section
     {
 #pragma omp section // First section: digitize top-right quadrant
-        digitizeEllipseDiv4(ingradient, iEllipse, iGrid, &subsum[0], state, true, true);
+        digitizeEllipseDiv4(iParticles, k, ia, ib, iGrid, &subsum[0], state, true, true);
 
 #pragma omp section // Second section: digitize top-left quadrant
-        digitizeEllipseDiv4(ingradient, iEllipse, iGrid, &subsum[1], state, false, true);
+        digitizeEllipseDiv4(iParticles, k, ia, ib, iGrid, &subsum[1], state, false, true);
 
 #pragma omp section // Third section: digitize bottom-right quadrant
-        digitizeEllipseDiv4(ingradient, iEllipse, iGrid, &subsum[2], state, true, false);
+        digitizeEllipseDiv4(iParticles, k, ia, ib, iGrid, &subsum[2], state, true, false);
 
 #pragma omp section // Fourth section: digitize bottom-left quadrant
-        digitizeEllipseDiv4(ingradient, iEllipse, iGrid, &subsum[3], state, false, false);
+        digitizeEllipseDiv4(iParticles, k, ia, ib, iGrid, &subsum[3], state, false, false);
     }
 
     // Sum up partial results from all sections to get total real area
@@ -1330,7 +2304,7 @@ void ShapeGenerator::digitizeEllipse(int ingradient, Ellipse iEllipse, Grid* iGr
 }
 
 // Helper function to digitize one quadrant of an ellipse
-void ShapeGenerator::digitizeEllipseDiv4(int ingradient, Ellipse iEllipse, Grid* iGrid, double* realArea, CellState state, bool x, bool y)
+void ShapeGenerator::digitizeEllipseDiv4(const ParticleSet& iParticles, size_t k, double ia, double ib, Grid* iGrid, double* realArea, CellState state, bool x, bool y)
 {
     int i, j;
 
@@ -1341,23 +2315,26 @@ void ShapeGenerator::digitizeEllipseDiv4(int ingradient, Ellipse iEllipse, Grid*
     *realArea = 0;   // Initialize real area for this quadrant
     double density = 1.8; // Density factor for sampling (higher density means more sampled points)
 
-    bool isCircle = (iEllipse.a == iEllipse.b); // Check if it's a circle
+    bool isCircle = (ia == ib); // Check if it's a circle
     if (isCircle)
         density = 1.0; // Use lower density for circles as they are simpler
 
     double invDensity = 1 / density;     // Inverse of density
     double sqInvDensity = invDensity * invDensity; // Square of inverse density
 
-    double costhetaX = cos(iEllipse.slope); // Cosine of ellipse slope
-    double sinthetaX = sin(iEllipse.slope); // Sine of ellipse slope
+    double centerX = iParticles.centerX[k];    // Ellipse center
+    double centerY = iParticles.centerY[k];
+    double costhetaX = iParticles.cosTheta[k]; // Precomputed cosine of ellipse slope
+    double sinthetaX = iParticles.sinTheta[k]; // Precomputed sine of ellipse slope
+    unsigned char ingradient = iParticles.component[k];
 
-    double sqEllipsoidA = (iEllipse.a * iEllipse.a); // Square of semi-major axis
-    double sqEllipsoidB = (iEllipse.b * iEllipse.b); // Square of semi-minor axis
+    double sqEllipsoidA = (ia * ia); // Square of semi-major axis
+    double sqEllipsoidB = (ib * ib); // Square of semi-minor axis
 
     int maxi, maxj; // Maximum loop bounds for i and j
 
-    maxi = int(density * (iEllipse.a + 2)); // Calculate max i for sampling
-    maxj = int(density * (iEllipse.b + 2)); // Calculate max j for sampling
+    maxi = int(density * (ia + 2)); // Calculate max i for sampling
+    maxj = int(density * (ib + 2)); // Calculate max j for sampling
 
     int muli = 1; // Multiplier for x-direction (1 for positive, -1 for negative)
     int mulj = 1; // Multiplier for y-direction (1 for positive, -1 for negative)
@@ -1384,28 +2361,28 @@ void ShapeGenerator::digitizeEllipseDiv4(int ingradient, Ellipse iEllipse, Grid*
                 if (distance <= 1.0) // If the sampled point is inside the ellipse
                 {
                     if (!isCircle) // If it's an ellipse, rotate the sampled point
-                        rotated = Point::transform(invDensity * ii, invDensity * jj, 0, 0,
-                            iEllipse.slope, costhetaX, sinthetaX);
+                        rotated = { invDensity * (ii * costhetaX + jj * sinthetaX),
+                            invDensity * (-ii * sinthetaX + jj * costhetaX) };
                     else
                     {
                         rotated = { (double)ii,(double)jj }; // For circles, no rotation needed (simpler)
                     }
 
-                    rotated = { rotated.x + iEllipse.center.x, // Translate to global coordinates
-                        rotated.y + iEllipse.center.y };
+                    rotated = { rotated.x + centerX, // Translate to global coordinates
+                        rotated.y + centerY };
 
                     iRotated = rotated.round(); // Round to nearest integer grid coordinates
 
-                    if (isInsideGrid(iRotated, iGrid)) // Check if the point is within grid boundaries
+                    if (iGrid->wrap(&iRotated.x, &iRotated.y, true)) // Check if the point is within grid boundaries (wrapping on periodic grids)
                     {
-                        size_t where = (size_t)iRotated.y * width + iRotated.x; // Calculate 1D array index
+                        size_t where = (size_t)iRotated.y * iGrid->width + iRotated.x; // Calculate 1D array index
                         char cPixel = iGrid->cell[where]; // Get current cell state
 
                         if (state == CellState::HARD) // If drawing a HARD cell
                         {
                             if (cPixel != CellState::HARD) // If not already HARD
                             {
-                                iGrid->ingadients[where] = (unsigned char)(ingradient); // Set component gradient
+                                iGrid->ingadients[where] = ingradient; // Set component gradient
                                 *realArea = 1.0 + *realArea; // Increment real area
                             }
                             iGrid->cell[where] = CellState::HARD; // Set cell state to HARD
@@ -1414,7 +2391,7 @@ void ShapeGenerator::digitizeEllipseDiv4(int ingradient, Ellipse iEllipse, Grid*
                             if (cPixel != CellState::HARD) // If not already HARD
                             {
                                 iGrid->cell[where] = state; // Set cell state to SOFT
-                                iGrid->ingadients[where] = (unsigned char)(ingradient); // Set component gradient
+                                iGrid->ingadients[where] = ingradient; // Set component gradient
                             }
                     }
                 }
@@ -1422,107 +2399,112 @@ void ShapeGenerator::digitizeEllipseDiv4(int ingradient, Ellipse iEllipse, Grid*
     }
 }
 
-// Digitizes an ellipse onto the grid without calculating real area
-void ShapeGenerator::digitizeEllipse(int ingradient, Ellipse iEllipse, Grid* iGrid, CellState state)
+// Digitizes particle k as an ellipse onto the grid without calculating real area
+void ShapeGenerator::digitizeEllipse(const ParticleSet& iParticles, size_t k, double ia, double ib, Grid* iGrid, CellState state)
 {
     int i, j;
+    double centerX = iParticles.centerX[k];   // Ellipse center
+    double centerY = iParticles.centerY[k];
+    double cosTheta = iParticles.cosTheta[k]; // Precomputed rotation
+    double sinTheta = iParticles.sinTheta[k];
+    double invSqA = 1.0 / (ia * ia);
+    double invSqB = 1.0 / (ib * ib);
+    unsigned char ingradient = iParticles.component[k];
+    double extentX = iParticles.ellipseExtentX(k, ia, ib);
+    double extentY = iParticles.ellipseExtentY(k, ia, ib);
 
     // Calculate the bounding box (region) for iterating over grid cells
-    Range region(iGrid->toLocaldimensionsDown(iEllipse.minX() - 1, iEllipse.minY() - 1), iGrid->toLocaldimensionsUp(iEllipse.maxX() + 1, iEllipse.maxY() + 1));
-
-    // Clamp region coordinates to grid boundaries
-    if (region.from.x < 0)
-        region.from.x = 0;
-    if (region.from.y < 0)
-        region.from.y = 0;
-    if (region.to.x > iGrid->width)
-        region.to.x = iGrid->width;
-    if (region.to.y > iGrid->height)
-        region.to.y = iGrid->height;
+    Range region(iGrid->toLocaldimensionsDown(centerX - extentX - 1, centerY - extentY - 1), iGrid->toLocaldimensionsUp(centerX + extentX + 1, centerY + extentY + 1));
+
+    // Clamp region coordinates to grid boundaries (one period on periodic grids)
+    iGrid->clipRegion(&region);
 
     // Iterate over grid cells within the bounding box
     for (i = region.from.x; i < region.to.x; i++)
         for (j = region.from.y; j < region.to.y; j++)
         {
-            // Transform (rotate) the center of the current grid cell back to the ellipse's local coordinate system
-            Point rotated = Point::transform(i + 0.5, j + 0.5, iEllipse.center.x, iEllipse.center.y, -iEllipse.slope);
+            // Rotate the center of the grid cell by -slope into the ellipse's local coordinate system
+            double dx = i + 0.5 - centerX;
+            double dy = j + 0.5 - centerY;
+            double rotatedX = dx * cosTheta - dy * sinTheta;
+            double rotatedY = dx * sinTheta + dy * cosTheta;
+            int x = i, y = j; // Grid cell to write (wrapped on periodic grids)
+            iGrid->wrap(&x, &y, true);
 
             // Check if the rotated point is inside the ellipse (using ellipse equation)
-            if (pow(1.0 * (rotated.x - iEllipse.center.x) / (1.0 * iEllipse.a), 2.0) + pow(1.0 * (rotated.y - iEllipse.center.y) / (1.0 * iEllipse.b), 2.0) <= 1.0)
+            if (rotatedX * rotatedX * invSqA + rotatedY * rotatedY * invSqB <= 1.0)
             {
-                if (iGrid->get(i, j) != CellState::HARD) // If the cell is not already HARD
+                if (iGrid->get(x, y) != CellState::HARD) // If the cell is not already HARD
                 {
-                    if (state == CellState::HARD) // If drawing a HARD cell
-                    {
-                        iGrid->set(i, j, state);                  // Set cell state to HARD
-                        iGrid->set(iGrid->ingadients, i, j, ingradient); // Set component gradient
-                    }
-                    else // If drawing a SOFT cell
-                        if (iGrid->get(i, j) != CellState::HARD) // Again, only if not already HARD
-                        {
-                            iGrid->set(i, j, state);                  // Set cell state to SOFT
-                            iGrid->set(iGrid->ingadients, i, j, ingradient); // Set component gradient
-                        }
+                    iGrid->set(x, y, state);                  // Set cell state (HARD or SOFT)
+                    iGrid->set(iGrid->ingadients, x, y, ingradient); // Set component gradient
                 }
             }
         }
 }
 
-// Digitizes an ellipse with a border onto the grid and calculates its real area
-void ShapeGenerator::digitizeEllipseWithBorder(Ellipse iEllipse, Grid* iGrid, double* realArea, CellState state)
+// Digitizes particle k as an ellipse with a border onto the grid and calculates its real area
+void ShapeGenerator::digitizeEllipseWithBorder(const ParticleSet& iParticles, size_t k, double ia, double ib, Grid* iGrid, double* realArea, CellState state)
 {
     int i, j;
     double distance; // Distance from ellipse center in normalized coordinates
+    double centerX = iParticles.centerX[k];   // Ellipse center
+    double centerY = iParticles.centerY[k];
+    double cosTheta = iParticles.cosTheta[k]; // Precomputed rotation
+    double sinTheta = iParticles.sinTheta[k];
+    double invSqA = 1.0 / (ia * ia);
+    double invSqB = 1.0 / (ib * ib);
+    double extentX = iParticles.ellipseExtentX(k, ia, ib);
+    double extentY = iParticles.ellipseExtentY(k, ia, ib);
+
     // Calculate the bounding box (region) for iterating over grid cells
-    Range region(iGrid->toLocaldimensionsDown(iEllipse.minX() - 1, iEllipse.minY() - 1), iGrid->toLocaldimensionsUp(iEllipse.maxX() + 1, iEllipse.maxY() + 1));
+    Range region(iGrid->toLocaldimensionsDown(centerX - extentX - 1, centerY - extentY - 1), iGrid->toLocaldimensionsUp(centerX + extentX + 1, centerY + extentY + 1));
 
     *realArea = 0; // Initialize real area count
 
-    // Clamp region coordinates to grid boundaries
-    if (region.from.x < 0)
-        region.from.x = 0;
-    if (region.from.y < 0)
-        region.from.y = 0;
-    if (region.to.x > iGrid->width)
-        region.to.x = iGrid->width;
-    if (region.to.y > iGrid->height)
-        region.to.y = iGrid->height;
+    // Clamp region coordinates to grid boundaries (one period on periodic grids)
+    iGrid->clipRegion(&region);
 
     // Iterate over grid cells within the bounding box
     for (i = region.from.x; i < region.to.x; i++)
         for (j = region.from.y; j < region.to.y; j++)
         {
-            // Transform (rotate) the center of the current grid cell back to the ellipse's local coordinate system
-            Point rotated = Point::transform(i + 0.5, j + 0.5, iEllipse.center.x, iEllipse.center.y, -iEllipse.slope);
+            // Rotate the center of the grid cell by -slope into the ellipse's local coordinate system
+            double dx = i + 0.5 - centerX;
+            double dy = j + 0.5 - centerY;
+            double rotatedX = dx * cosTheta - dy * sinTheta;
+            double rotatedY = dx * sinTheta + dy * cosTheta;
+            int x = i, y = j; // Grid cell to write (wrapped on periodic grids)
+            iGrid->wrap(&x, &y, true);
             // Calculate normalized distance from ellipse center
-            distance = ((rotated.x - iEllipse.center.x) * (rotated.x - iEllipse.center.x) / (iEllipse.a * iEllipse.a)) + ((rotated.y - iEllipse.center.y) * (rotated.y - iEllipse.center.y) / (iEllipse.b * iEllipse.b));
+            distance = rotatedX * rotatedX * invSqA + rotatedY * rotatedY * invSqB;
             // Check if the point is within the "border" zone (between 0.8 and 1.0 normalized distance)
             if ((distance <= 1.0) && (distance >= 0.8))
             {
                 if (state == CellState::HARD) // If drawing a HARD cell (core)
                 {
-                    if (iGrid->get(i, j) != 0) // If the cell is not empty
+                    if (iGrid->get(x, y) != 0) // If the cell is not empty
                         *realArea += 1.0;     // Increment real area
 
-                    iGrid->set(i, j, BORDER); // Set cell state to BORDER
+                    iGrid->set(x, y, BORDER); // Set cell state to BORDER
                 }
                 else // If drawing a SOFT cell (e.g., hoop)
-                    if (iGrid->get(i, j) != CellState::HARD) // Only set if not already HARD
-                        iGrid->set(i, j, state); // Set cell state to SOFT (this will actually set to BORDER based on the outer condition)
+                    if (iGrid->get(x, y) != CellState::HARD) // Only set if not already HARD
+                        iGrid->set(x, y, state); // Set cell state to SOFT
             }
             else // Point is within the "core" of the ellipse (less than 0.8 normalized distance)
                 if ((distance < 0.8))
                 {
                     if (state == CellState::HARD) // If drawing a HARD cell (core)
                     {
-                        if (iGrid->get(i, j) != 0) // If the cell is not empty
+                        if (iGrid->get(x, y) != 0) // If the cell is not empty
                             *realArea += 1.0;     // Increment real area
 
-                        iGrid->set(i, j, CellState::HARD); // Set cell state to HARD
+                        iGrid->set(x, y, CellState::HARD); // Set cell state to HARD
                     }
                     else // If drawing a SOFT cell (e.g., hoop)
-                        if (iGrid->get(i, j) != CellState::HARD) // Only set if not already HARD
-                            iGrid->set(i, j, state); // Set cell state to SOFT
+                        if (iGrid->get(x, y) != CellState::HARD) // Only set if not already HARD
+                            iGrid->set(x, y, state); // Set cell state to SOFT
                 }
         }
 }
@@ -1728,7 +2710,20 @@ void ShapeGenerator::readFromFile(char* inputFileName)
             {
                 getline(inputFile, line);
             }
-            pixelsPerMinimumSize = std::stoi(line); // Read pixels per minimum size
+            // Read pixels per minimum size. Extra values on the same line (e.g. "67 101 135") start a
+            // resolution study: the geometry is generated at the first one and re-rasterized at the others.
+            std::vector<std::string> strPpms = split(line, ' ');
+            studyPixelsPerMinimumSize.clear();
+            pixelsPerMinimumSize = 0;
+            for (size_t i = 0; i < strPpms.size(); i++)
+            {
+                if (strPpms[i].empty())
+                    continue;
+                if (pixelsPerMinimumSize == 0)
+                    pixelsPerMinimumSize = std::stoi(strPpms[i]);
+                else
+                    studyPixelsPerMinimumSize.push_back(std::stoi(strPpms[i]));
+            }
 
             getline(inputFile, line);
             while (line[0] == '#')
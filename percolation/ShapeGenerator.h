@@ -56,12 +56,19 @@ if you use this programm and write a paper or report please cite above papers
 #include "Grid.h"       // Defines the Grid class for the simulation domain
 #include "Settings.h"   // Defines settings and configuration for the program
 #include "FD2DEL.h"     // Likely related to Finite Difference Method for 2D Electrical problems
+#include "TiledGrid.h"  // Lazily materialized (tile by tile) grid for very large RVEs
+#include "ShapesFile.h" // Binary shapes file of all realizations
+#include "ResultsFile.h" // Per realization results file
+#include "Checkpoint.h"  // Checkpoints of interrupted runs
+#include "PhaseTimer.h"  // Wall and CPU time per phase
+#include "ProgressStatus.h" // Progress of the runs for the status file
+#include "Log.h"          // Console output by level
+#include "Distributed.h"  // Ranks of an MPI run
 
 using namespace std; // Using the standard namespace to avoid std:: prefix
 
 // Preprocessor defines for maximum capacities
 #define maxComponents   5       // Maximum number of different material components
-#define maxCases        15000   // Maximum number of simulation cases to run
 
 /**
  * @brief The ShapeGenerator class is responsible for generating and managing
@@ -94,8 +101,8 @@ public:
     int width = 0;              // Width of the simulation grid
     int height = 0;             // Height of the simulation grid
     int totalComponents = 0;    // Total number of active material components
-    // Array to store the real area of each component for each case
-    double realComponentAreas[maxComponents * maxCases] = {};
+    // Real area of each component for each case ([case * totalComponents + component], sized in monteCarlo())
+    vector<double> realComponentAreas;
 
     double components[maxComponents] = {};          // Percentage weights of each component
     double specialWeights[maxComponents] = {};      // Special weights for components (specific use case)
@@ -113,27 +120,34 @@ public:
 
     Grid* grid; // Pointer to the simulation grid object
 
-    // Arrays to store simulation results for each case
-    int Results[maxCases] = {};                     // General integer results per case
-    float FDResults[maxCases * 2] = {};             // Finite Difference Method results (e.g., electrical potential)
-    double Times[maxCases] = {};                    // Total time taken for each case
-    double setUpTimes[maxCases] = {};               // Setup time for each case
+    // Simulation results for each case, sized by `iterations` in monteCarlo()
+    vector<int> Results;                            // General integer results per case
+    vector<float> FDResults;                        // Finite Difference Method results (x, y currents per case)
+    vector<double> Times;                           // Total time taken for each case
+    vector<double> setUpTimes;                      // Setup time for each case
     double calcComponents[maxComponents] = {};      // Calculation results specific to components
-    double paths[maxCases] = {};                    // Number of paths found (e.g., percolation paths)
-    double meanPathLength[maxCases] = {};           // Mean path length per case
-    double meanRealPathLength[maxCases] = {};       // Mean real path length per case
+    vector<double> paths;                           // Number of paths found (e.g., percolation paths)
+    vector<double> meanPathLength;                  // Mean path length per case
+    vector<double> meanRealPathLength;              // Mean real path length per case
+    vector<uint64_t> seeds;                         // Seed of the random engine per case
+    vector<int> FDIterations;                       // Conjugate gradient cycles of the FDM per case
+    vector<PhaseTimes> phaseTimes;                  // Wall and CPU time of every phase per case
+    vector<int64_t> caseClusters;                   // Clusters of the grid per case (statistics)
+    vector<int64_t> caseMaxClusterPoints;           // Points of the largest cluster per case (statistics)
+    vector<double> caseMaxClusterRadius;            // Largest cluster radius per case (statistics)
+    vector<double> caseCorrelationLengths;          // Correlation length per case (0 without statistics)
 
     // Calculated macroscopic properties for each case
-    double electricConductivity[maxCases] = {};     // Electric conductivity
-    double thermalConductivities[maxCases] = {};    // Thermal conductivity
-    double YoungModulus[maxCases] = {};             // Young's modulus
-    double PoissonRatio[maxCases] = {};             // Poisson's ratio
+    vector<double> electricConductivity;            // Electric conductivity
+    vector<double> thermalConductivities;           // Thermal conductivity
+    vector<double> YoungModulus;                    // Young's modulus
+    vector<double> PoissonRatio;                    // Poisson's ratio
 
     // Mean RVE (Representative Volume Element) properties for each case (related to averaging)
-    double meanRVEResistances[maxCases] = {};
-    double meanRVEThermalResistance[maxCases] = {};
-    double meanRVEYoungModulus[maxCases] = {};
-    double meanRVEPoissoonRatio[maxCases] = {};
+    vector<double> meanRVEResistances;
+    vector<double> meanRVEThermalResistance;
+    vector<double> meanRVEYoungModulus;
+    vector<double> meanRVEPoissoonRatio;
 
     // Overall mean properties across all cases
     double meanElectricConductivity = 0;
@@ -155,6 +169,25 @@ public:
 
     double thresh = 0;              // Threshold value (e.g., for percolation)
 
+    ParticleSet particles;          // Particles of the current realization (SoA, trig precomputed once per particle)
+    ShapesWriter shapesWriter;      // Binary shapes file of the realizations (settings shapesFormat BINARY/BINARY32)
+    ShapesReader shapesReader;      // Shapes file of a replayed run
+    vector<int> replayCases;        // Realizations replayed, one per case (empty: new realizations are generated)
+    double replayScale = 1;         // Resolution ratio between this grid and the grid of the shapes file
+    ResultsWriter resultsFile;      // Per realization results (results.bin), a record per finished case
+
+    // Resolution study: every realization is generated once at pixelsPerMinimumSize and re-rasterized
+    // at each of these extra ppms values. Results are stored per [resolution * iterations + case].
+    vector<int> studyPixelsPerMinimumSize;  // Extra ppms values (empty: no resolution study)
+    vector<int> studyResults;               // Percolation result (1/0)
+    vector<double> studyRealAreas;          // Digitized particle area fraction
+    vector<double> studyPaths;              // Number of conductive paths
+    vector<double> studyElectricConductivity; // Path based electric conductivity
+    vector<double> studyFDResults;          // FDM currents (x, y) per entry
+    vector<double> studyTimes;              // Rasterization + percolation time
+    vector<double> studyClusters;           // Number of HARD clusters (tiled grids only)
+    vector<double> studyMaxClusterSize;     // Pixels of the largest cluster (tiled grids only)
+
 public:
     /**
      * @brief Initializes project directories.
@@ -234,7 +267,7 @@ public:
      * @param totalRectanglesPerComponent Vector of rectangle counts per component.
      * @param totalSlopedRectanglesPerComponent Vector of sloped rectangle counts per component.
      */
-    void printParticles(int caseNo, vector<int> totalEllipsesPerComponent, vector<int> totalCirclesPerComponent, vector<int> totalRectanglesPerComponent, vector<int> totalSlopedRectanglesPerComponent);
+    void printParticles(int caseNo, const vector<int>& totalEllipsesPerComponent, const vector<int>& totalCirclesPerComponent, const vector<int>& totalRectanglesPerComponent, const vector<int>& totalSlopedRectanglesPerComponent);
 
     /**
      * @brief Sets up a general simulation case (non-lattice specific).
@@ -243,6 +276,144 @@ public:
      */
     void setupCase(int caseNo, double* setUpTime);
 
+    /**
+     * @brief Opens the project's binary shapes file and selects the realizations to replay
+     * (settings replayCases). On success `iterations` becomes the number of selected realizations.
+     * @return true if this run replays saved realizations instead of generating new ones.
+     */
+    bool openReplay(void);
+
+    /**
+     * @brief Sets up a case from a saved realization: its particles are read back, scaled to this
+     * grid and digitized in generation order, without random numbers.
+     * @param caseNo The current case number.
+     * @param sourceCase The realization number in the shapes file.
+     * @param setUpTime Pointer to store the setup time for this case.
+     */
+    void replayCase(int caseNo, int sourceCase, double* setUpTime);
+
+    /**
+     * @brief Returns the upper corner of the area where particle centres are placed.
+     * @return (width, height) on periodic grids, (width - 1, height - 1) otherwise.
+     */
+    Point placementLimit(void);
+
+    /**
+     * @brief Draws a set of particles on a grid, component after component as in setupCase
+     * (inverted for "swiss cheese").
+     * @param iGrid Pointer to the (cleared) target Grid.
+     * @param iParticles Particles in iGrid pixels.
+     * @return The digitized particle area in pixels.
+     */
+    double drawParticles(Grid* iGrid, ParticleSet* iParticles);
+
+    /**
+     * @brief Draws the particles of the current realization on another grid.
+     * Components are drawn in the same order as in setupCase (inverted for "swiss cheese").
+     * @param iGrid Pointer to the (cleared) target Grid.
+     * @param iScale Resolution ratio between iGrid and the generation grid.
+     * @return The digitized particle area fraction.
+     */
+    double rasterize(Grid* iGrid, double iScale);
+
+    /**
+     * @brief Percolation and cluster connectivity of the current realization on a tiled grid.
+     * Only one tile is materialized at a time.
+     * @param tGrid Pointer to the TiledGrid object.
+     * @param iScale Resolution ratio between tGrid and the generation grid.
+     * @param realArea Pointer to store the digitized particle area fraction.
+     * @return 1 if a cluster connects the first and the last row, 0 otherwise.
+     */
+    int percolateTiled(TiledGrid* tGrid, double iScale, double* realArea);
+
+    /**
+     * @brief Re-rasterizes the current realization at every extra ppms value and runs
+     * percolation (and FDM if enabled) on each resolution.
+     * @param caseNo The current case number.
+     * @param studyGrids One full grid per extra ppms value (NULL when tiled).
+     * @param studyTiledGrids One tiled grid per extra ppms value (NULL when full).
+     */
+    void resolutionStudy(int caseNo, vector<Grid*>& studyGrids, vector<TiledGrid*>& studyTiledGrids);
+
+    /**
+     * @brief Solves the electric conductivity of a grid with the Finite Differences Method.
+     * @param iGrid Pointer to the Grid object.
+     * @param currX Pointer to store the current in x-direction.
+     * @param currY Pointer to store the current in y-direction.
+     * @param imageFileName Bitmap of the solved phases (NULL: no image).
+     * @param cgIterations Pointer to store the conjugate gradient cycles (NULL: not needed).
+     */
+    void solveFDM(Grid* iGrid, double* currX, double* currY, char* imageFileName, int* cgIterations = NULL);
+
+    /**
+     * @brief Creates the per realization results file of the project (results.bin) with its columns.
+     * @param resumeCases Finished realizations of a resumed run: their records are kept (0: new file).
+     */
+    void openResultsFile(int resumeCases = 0);
+
+    /**
+     * @brief Keeps the cluster summary of the grid and the correlation length of a finished case.
+     * @param caseNo The case number.
+     * @param correlationLength Correlation length of the case (0 without statistics).
+     */
+    void summarizeCase(int caseNo, double correlationLength);
+
+    /**
+     * @brief Appends (and flushes) the record of a finished (and summarized) case to the results file.
+     * @param caseNo The case number.
+     */
+    void appendResults(int caseNo);
+
+    /**
+     * @brief Hash of everything that makes the realizations of this input (grid, components,
+     * materials, analyses and the settings that change them), kept in its checkpoints.
+     * @return 64 bit FNV-1a hash.
+     */
+    uint64_t inputFingerprint(void);
+
+    /**
+     * @brief Writes the per case results of the finished realizations to the project's
+     * checkpoint (checkpoint.bin), on the output queue after the shapes records of these cases.
+     * @param completed Finished realizations (cases 0 .. completed - 1).
+     */
+    void saveCheckpoint(int completed);
+
+    /**
+     * @brief Restores the per case results of an interrupted run from the project's checkpoint
+     * (settings resume). A checkpoint of another input or grid is ignored.
+     * @return The finished realizations, where the run continues (0: none).
+     */
+    int restoreCheckpoint(void);
+
+    /**
+     * @brief Sums the per case results of all ranks sharing the realizations into rank 0 (collective:
+     * every case was run by one rank, the others hold zeros, and hold zeros again after the sum).
+     * Rank 0 then orders the correlation lengths, appends the records of the new cases to the
+     * results file and writes a checkpoint of them.
+     * @param from Cases merged before (restored from the checkpoint or summed by an earlier call).
+     * @param to Cases finished by all ranks (cases from .. to - 1 are the new ones).
+     */
+    void mergeCases(int from, int to);
+
+    /**
+     * @brief Gathers the binary shapes files of the ranks sharing the realizations (shapes.<rank>.bin,
+     * and shapes.bin of an earlier merge) into shapes.bin, so the run can be replayed like a serial
+     * one. Called by rank 0 after the other ranks have closed their files.
+     * @param cases Realizations kept (cases 0 .. cases - 1); 0 removes the files of an earlier run.
+     */
+    void mergeShapes(int cases);
+
+    /**
+     * @brief Estimates the peak memory of a monteCarlo() run of this (already read) input:
+     * the five byte planes of the grid and of every resolution-study grid, plus the largest
+     * FDM system when FDM is enabled. Per padded site the FDM arrays of the selected solver are
+     * six double and two int arrays (CG), two more doubles for the strips (BLOCK_JACOBI), the
+     * multigrid hierarchy (AMG, about 43 doubles) or five float arrays in place of five of the
+     * doubles (MIXED), and the backbone's search arrays and multigrid when it is enabled.
+     * @return The estimated footprint in bytes.
+     */
+    size_t memoryFootprint(void);
+
     /**
      * @brief Adds a single sloped rectangle to the simulation.
      * @param caseNo The current case number.
@@ -292,24 +463,13 @@ public:
     void SetupSizes(int i, double dimensionY, double dimensionX, double factor, std::normal_distribution<double> size, SizeType componentsSizeType, double* rectWidth, double* rectHeight, ShapeType componentsType, double* maxAngle, double* minAngle, int* totalSlopedRectangles, int* totalRectangles, int* totalCircles, int* totalEllipses);
 
     /**
-     * @brief Checks and draws an ellipse for the "swiss cheese" model.
-     * @param ingradient Component index.
-     * @param a Semi-major axis.
-     * @param b Semi-minor axis.
-     * @param cEllipse Pointer to the Ellipse object.
-     * @param hoop Hoop distance.
-     */
-    void swissCheeseCheckAndDraw(int ingradient, double a, double b, Ellipse* cEllipse, double hoop);
-
-    /**
-     * @brief Checks and draws a sloped rectangle for the "swiss cheese" model.
-     * @param ingradient Component index.
-     * @param rectWidth Width of the rectangle.
-     * @param rectHeight Height of the rectangle.
-     * @param sRectangle Pointer to the SlopedRectangle object.
-     * @param hoop Hoop distance.
+     * @brief Draws particle k (hoop and core) on the grid, honouring the "swiss cheese" model.
+     * The digitized core area is stored in iParticles->realArea[k].
+     * @param iParticles Particle store holding the particle.
+     * @param k Index of the particle in the store.
+     * @param iGrid Pointer to the Grid object.
      */
-    void swissCheeseCheckAndDraw(int ingradient, double rectWidth, double rectHeight, SlopedRectangle* sRectangle, double hoop);
+    void swissCheeseCheckAndDraw(ParticleSet* iParticles, size_t k, Grid* iGrid);
 
     /**
      * @brief Runs the Monte Carlo simulation.
@@ -373,74 +533,88 @@ public:
     Ellipse generateEllipse(Point downleft, Point upRight, double ia, double ib, double maxAngle, double minAngle);
 
     /**
-     * @brief Digitizes a sloped rectangle onto the grid.
-     * @param ingradient Component index.
-     * @param sRect The SlopedRectangle object.
+     * @brief Digitizes particle k as a sloped rectangle onto the grid.
+     * @param iParticles Particle store (centre, precomputed cos/sin, component).
+     * @param k Index of the particle in the store.
+     * @param rectWidth Width to draw (core or core plus hoop).
+     * @param rectHeight Height to draw (core or core plus hoop).
      * @param iGrid Pointer to the Grid object.
      * @param state The cell state to set for digitized pixels.
      */
-    void digitizeSlopedRectangle(int ingradient, SlopedRectangle sRect, Grid* iGrid, CellState state);
+    void digitizeSlopedRectangle(const ParticleSet& iParticles, size_t k, double rectWidth, double rectHeight, Grid* iGrid, CellState state);
 
     /**
-     * @brief Digitizes a sloped rectangle onto the grid and calculates its real area.
-     * @param ingradient Component index.
-     * @param sRect The SlopedRectangle object.
+     * @brief Digitizes particle k as a sloped rectangle onto the grid and calculates its real area.
+     * @param iParticles Particle store (centre, precomputed cos/sin, component).
+     * @param k Index of the particle in the store.
+     * @param rectWidth Width to draw.
+     * @param rectHeight Height to draw.
      * @param iGrid Pointer to the Grid object.
      * @param realArea Pointer to store the calculated real area.
      * @param state The cell state to set for digitized pixels.
      */
-    void digitizeSlopedRectangle(int ingradient, SlopedRectangle sRect, Grid* iGrid, double* realArea, CellState state);
+    void digitizeSlopedRectangle(const ParticleSet& iParticles, size_t k, double rectWidth, double rectHeight, Grid* iGrid, double* realArea, CellState state);
 
     /**
-     * @brief Digitizes a sloped rectangle onto the grid including its border, and calculates its real area.
-     * @param ingradient Component index.
-     * @param sRect The SlopedRectangle object.
+     * @brief Digitizes particle k as a sloped rectangle including its border, and calculates its real area.
+     * @param iParticles Particle store (centre, precomputed cos/sin, component).
+     * @param k Index of the particle in the store.
+     * @param rectWidth Width to draw.
+     * @param rectHeight Height to draw.
      * @param iGrid Pointer to the Grid object.
      * @param realArea Pointer to store the calculated real area.
      * @param state The cell state to set for digitized pixels.
      */
-    void digitizeSlopedRectangleWithBorder(int ingradient, SlopedRectangle sRect, Grid* iGrid, double* realArea, CellState state);
+    void digitizeSlopedRectangleWithBorder(const ParticleSet& iParticles, size_t k, double rectWidth, double rectHeight, Grid* iGrid, double* realArea, CellState state);
 
     /**
-     * @brief Digitizes an ellipse onto the grid and calculates its real area.
-     * @param ingradient Component index.
-     * @param iEllipse The Ellipse object.
+     * @brief Digitizes particle k as an ellipse onto the grid and calculates its real area.
+     * @param iParticles Particle store (centre, precomputed cos/sin, component).
+     * @param k Index of the particle in the store.
+     * @param ia Semi-axis a to draw.
+     * @param ib Semi-axis b to draw.
      * @param iGrid Pointer to the Grid object.
      * @param realArea Pointer to store the calculated real area.
      * @param state The cell state to set for digitized pixels.
      */
-    void digitizeEllipse(int ingradient, Ellipse iEllipse, Grid* iGrid, double* realArea, CellState state);
+    void digitizeEllipse(const ParticleSet& iParticles, size_t k, double ia, double ib, Grid* iGrid, double* realArea, CellState state);
 
     /**
-     * @brief Digitizes an ellipse onto the grid.
-     * @param ingradient Component index.
-     * @param iEllipse The Ellipse object.
+     * @brief Digitizes particle k as an ellipse onto the grid.
+     * @param iParticles Particle store (centre, precomputed cos/sin, component).
+     * @param k Index of the particle in the store.
+     * @param ia Semi-axis a to draw.
+     * @param ib Semi-axis b to draw.
      * @param iGrid Pointer to the Grid object.
      * @param state The cell state to set for digitized pixels.
      */
-    void digitizeEllipse(int ingradient, Ellipse iEllipse, Grid* iGrid, CellState state);
+    void digitizeEllipse(const ParticleSet& iParticles, size_t k, double ia, double ib, Grid* iGrid, CellState state);
 
     /**
-     * @brief Digitizes an ellipse onto the grid including its border, and calculates its real area.
-     * @param iEllipse The Ellipse object.
+     * @brief Digitizes particle k as an ellipse including its border, and calculates its real area.
+     * @param iParticles Particle store (centre, precomputed cos/sin, component).
+     * @param k Index of the particle in the store.
+     * @param ia Semi-axis a to draw.
+     * @param ib Semi-axis b to draw.
      * @param iGrid Pointer to the Grid object.
      * @param realArea Pointer to store the calculated real area.
      * @param state The cell state to set for digitized pixels.
      */
-    void digitizeEllipseWithBorder(Ellipse iEllipse, Grid* iGrid, double* realArea, CellState state);
+    void digitizeEllipseWithBorder(const ParticleSet& iParticles, size_t k, double ia, double ib, Grid* iGrid, double* realArea, CellState state);
 
     /**
      * @brief Digitizes a quadrant (division by 4) of an ellipse onto the grid and calculates its real area.
-     * This might be used for optimization by only digitizing one quadrant and mirroring.
-     * @param ingradient Component index.
-     * @param iEllipse The Ellipse object.
+     * @param iParticles Particle store (centre, precomputed cos/sin, component).
+     * @param k Index of the particle in the store.
+     * @param ia Semi-axis a to draw.
+     * @param ib Semi-axis b to draw.
      * @param iGrid Pointer to the Grid object.
      * @param realArea Pointer to store the calculated real area.
      * @param state The cell state to set for digitized pixels.
      * @param x Boolean indicating X-axis mirroring.
      * @param y Boolean indicating Y-axis mirroring.
      */
-    void digitizeEllipseDiv4(int ingradient, Ellipse iEllipse, Grid* iGrid, double* realArea, CellState state, bool x, bool y);
+    void digitizeEllipseDiv4(const ParticleSet& iParticles, size_t k, double ia, double ib, Grid* iGrid, double* realArea, CellState state, bool x, bool y);
 
     /**
      * @brief Reads simulation parameters and settings from an input file.
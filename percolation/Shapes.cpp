@@ -380,4 +380,102 @@ void SlopedRectangle::toString(void)
     std::cout << "Lower Left/  X=" << lowerLeft.x << " Y=" << lowerLeft.y << "\n";
     std::cout << "Area =" << area() << "\n"; // Calls the base class's area() method, which correctly calculates the area (rotation doesn't change area).
     std::cout << "--------------------------------------------------\n";
-}
\ No newline at end of file
+}
+
+// --- ParticleSet Class Implementation ---
+
+// Appends one particle to every column. cos/sin of the slope are evaluated here once,
+// instead of once per pixel inside the digitize kernels.
+size_t ParticleSet::add(double cx, double cy, double ia, double ib, double iSlope, double iHoop, int iComponent, ShapeType iType)
+{
+    centerX.push_back(cx);
+    centerY.push_back(cy);
+    a.push_back(ia);
+    b.push_back(ib);
+    slope.push_back(iSlope);
+    cosTheta.push_back(std::cos(iSlope));
+    sinTheta.push_back(std::sin(iSlope));
+    hoop.push_back(iHoop);
+    realArea.push_back(0.0);
+    component.push_back((unsigned char)iComponent);
+    type.push_back(iType);
+    return centerX.size() - 1; // Index of the new particle
+}
+
+// Returns the number of stored particles.
+size_t ParticleSet::size(void) const
+{
+    return centerX.size();
+}
+
+// Empties all columns. std::vector keeps its capacity, so the next realization does not reallocate.
+void ParticleSet::clear(void)
+{
+    centerX.clear();
+    centerY.clear();
+    a.clear();
+    b.clear();
+    slope.clear();
+    cosTheta.clear();
+    sinTheta.clear();
+    hoop.clear();
+    realArea.clear();
+    component.clear();
+    type.clear();
+}
+
+// Reserves room for n particles in every column.
+void ParticleSet::reserve(size_t n)
+{
+    centerX.reserve(n);
+    centerY.reserve(n);
+    a.reserve(n);
+    b.reserve(n);
+    slope.reserve(n);
+    cosTheta.reserve(n);
+    sinTheta.reserve(n);
+    hoop.reserve(n);
+    realArea.reserve(n);
+    component.reserve(n);
+    type.reserve(n);
+}
+
+// Copies the particles into `scaled` at another resolution. Only lengths change, so the
+// precomputed cos/sin columns are copied as they are.
+void ParticleSet::scaleTo(double iScale, ParticleSet* scaled) const
+{
+    *scaled = *this;
+    for (size_t k = 0; k < size(); k++)
+    {
+        scaled->centerX[k] = centerX[k] * iScale;
+        scaled->centerY[k] = centerY[k] * iScale;
+        scaled->a[k] = a[k] * iScale;
+        scaled->b[k] = b[k] * iScale;
+        scaled->hoop[k] = hoop[k] * iScale;
+        scaled->realArea[k] = 0.0;
+    }
+}
+
+// Half width of the bounding box of a rotated ellipse (same formula as Ellipse::maxX, without the trig calls).
+double ParticleSet::ellipseExtentX(size_t k, double ia, double ib) const
+{
+    return std::sqrt(ia * ia * cosTheta[k] * cosTheta[k] + ib * ib * sinTheta[k] * sinTheta[k]);
+}
+
+// Half height of the bounding box of a rotated ellipse (same formula as Ellipse::maxY, without the trig calls).
+double ParticleSet::ellipseExtentY(size_t k, double ia, double ib) const
+{
+    return std::sqrt(ia * ia * sinTheta[k] * sinTheta[k] + ib * ib * cosTheta[k] * cosTheta[k]);
+}
+
+// Half width of the bounding box of a rotated rectangle.
+double ParticleSet::rectangleExtentX(size_t k, double iWidth, double iHeight) const
+{
+    return 0.5 * (std::fabs(iWidth * cosTheta[k]) + std::fabs(iHeight * sinTheta[k]));
+}
+
+// Half height of the bounding box of a rotated rectangle.
+double ParticleSet::rectangleExtentY(size_t k, double iWidth, double iHeight) const
+{
+    return 0.5 * (std::fabs(iWidth * sinTheta[k]) + std::fabs(iHeight * cosTheta[k]));
+}
@@ -30,6 +30,8 @@ if you use this programm and write a paper or report please cite above papers
 #pragma once
 #include <cmath>    // For mathematical functions like std::cos, std::sin, std::sqrt, std::round
 #include <iostream> // For input/output operations, specifically std::cout used in toString methods
+#include <vector>   // For std::vector used by the structure-of-arrays ParticleSet
+#include "general.h" // For the ShapeType enumeration stored per particle
 
 // Define M_PI if it's not already defined to ensure portability.
 // M_PI represents the mathematical constant Pi (approximately 3.14159265358979323846).
@@ -199,4 +201,45 @@ public:
     // Prints the sloped rectangle's parameters (center, width, height, slope)
     // and the transformed (rotated) coordinates of its corner points to the console.
     void toString(void);
+};
+
+// Structure-of-arrays store for all particles placed in one realization.
+// The rotation cosine and sine are computed once when a particle is added, so the
+// digitize kernels never evaluate trigonometric functions per pixel. Every particle
+// occupies the same index k in all columns.
+class ParticleSet
+{
+public:
+    std::vector<double> centerX, centerY;   // Particle centres in grid (pixel) coordinates.
+    std::vector<double> a, b;               // Semi-axes for ellipses/circles, width/height for rectangles (pixels).
+    std::vector<double> slope;              // Rotation angle in radians.
+    std::vector<double> cosTheta, sinTheta; // Precomputed cos(slope) and sin(slope).
+    std::vector<double> hoop;               // Hoop (soft shell) thickness in pixels.
+    std::vector<double> realArea;           // Digitized core area (pixels) credited to the particle.
+    std::vector<unsigned char> component;   // Component (ingredient) index of the particle.
+    std::vector<ShapeType> type;            // Geometry of the particle.
+
+    // Appends a particle, precomputing its rotation, and returns its index.
+    size_t add(double cx, double cy, double ia, double ib, double iSlope, double iHoop, int iComponent, ShapeType iType);
+
+    // Returns the number of stored particles.
+    size_t size(void) const;
+
+    // Removes all particles (capacity is kept for the next realization).
+    void clear(void);
+
+    // Reserves capacity for n particles in every column.
+    void reserve(size_t n);
+
+    // Copies all particles into `scaled` with centres and lengths multiplied by iScale
+    // (rotation is kept), i.e. the same geometry expressed on a finer or coarser pixel grid.
+    void scaleTo(double iScale, ParticleSet* scaled) const;
+
+    // Half extents of the axis-aligned bounding box of particle k, drawn as an ellipse with semi-axes (ia, ib).
+    double ellipseExtentX(size_t k, double ia, double ib) const;
+    double ellipseExtentY(size_t k, double ia, double ib) const;
+
+    // Half extents of the axis-aligned bounding box of particle k, drawn as a rectangle of size (iWidth x iHeight).
+    double rectangleExtentX(size_t k, double iWidth, double iHeight) const;
+    double rectangleExtentY(size_t k, double iWidth, double iHeight) const;
 };
\ No newline at end of file
@@ -0,0 +1,663 @@
+/*
+This file is part of Electric,Thermal, Mechanical Properties
+Estimation With Percolation Theory (ETMPEWPT) (2D version) program.
+
+Created from Eleftherios Lamprou lef27064@otenet.gr during PhD thesis (2017-2024)
+
+ETMPEWPT is free software : you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+ETMPEWPT is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Foobar.If not, see < https://www.gnu.org/licenses/>.
+
+Theory of this is published in two papers:
+1. E. Lambrou and L. N. Gergidis, A computational method for calculating the electrical and thermal properties of random composite ,
+Physica A: Statistical Mechanics and its Applications, Volume 642, 2024, 129760, ISSN 0378-4371,
+https://doi.org/10.1016/j.physa.2024.129760
+2. E. Lambrou and L. N. Gergidis, A particle digitization-based computational method for continuum percolation, Physica A: Statistical Mechanics
+and its Applications, vol. 590, p. 126738, 2022
+
+if you use this programm and write a paper or report please cite above papers
+
+*/
+
+#include "ShapesFile.h"
+#include "OutputQueue.h" // Records are appended by the output queue.
+#include <string.h>      // memcpy, memcmp.
+#include <iostream>      // std::cerr.
+#include <filesystem>    // Cut of unfinished records on resume, rename of merged files.
+#include <algorithm>     // Case order of merged records.
+
+const int shapesFloatColumns = 6; // centerX, centerY, a, b, hoop, slope
+
+// --- LZ codec ---
+
+const size_t lzMinMatch = 4;
+const size_t lzMaxOffset = 65535;
+const int lzHashBits = 16;
+
+static inline uint32_t lzRead32(const unsigned char* p)
+{
+	uint32_t v;
+	memcpy(&v, p, 4);
+	return v;
+}
+
+// Lengths of 15 or more go on in bytes of 255 and a last byte below 255
+static void lzPutLength(std::vector<unsigned char>& out, size_t length)
+{
+	while (length >= 255)
+	{
+		out.push_back(255);
+		length -= 255;
+	}
+	out.push_back((unsigned char)length);
+}
+
+static void lzPutSequence(std::vector<unsigned char>& out, const unsigned char* literals, size_t literalLength, size_t offset, size_t matchLength)
+{
+	size_t matchCode = (matchLength > 0) ? matchLength - lzMinMatch : 0;
+	out.push_back((unsigned char)(((literalLength < 15 ? literalLength : 15) << 4) | (matchCode < 15 ? matchCode : 15)));
+	if (literalLength >= 15)
+		lzPutLength(out, literalLength - 15);
+	out.insert(out.end(), literals, literals + literalLength);
+	if (matchLength == 0) // Last sequence: literals only
+		return;
+	out.push_back((unsigned char)(offset & 0xFF));
+	out.push_back((unsigned char)(offset >> 8));
+	if (matchCode >= 15)
+		lzPutLength(out, matchCode - 15);
+}
+
+void lzCompress(const unsigned char* source, size_t size, std::vector<unsigned char>& out)
+{
+	std::vector<size_t> head((size_t)1 << lzHashBits, 0); // Last position + 1 of every 4 byte hash (0: none)
+	size_t anchor = 0; // First byte not yet emitted
+	size_t pos = 0;
+	while (pos + lzMinMatch <= size)
+	{
+		uint32_t sequence = lzRead32(source + pos);
+		size_t h = (sequence * 2654435761u) >> (32 - lzHashBits);
+		size_t candidate = head[h];
+		head[h] = pos + 1;
+		if ((candidate > 0) && (pos - (candidate - 1) <= lzMaxOffset) && (lzRead32(source + candidate - 1) == sequence))
+		{
+			size_t reference = candidate - 1;
+			size_t length = lzMinMatch;
+			while ((pos + length < size) && (source[reference + length] == source[pos + length]))
+				length++;
+			lzPutSequence(out, source + anchor, pos - anchor, pos - reference, length);
+			pos += length;
+			anchor = pos;
+		}
+		else
+			pos++;
+	}
+	lzPutSequence(out, source + anchor, size - anchor, 0, 0);
+}
+
+bool lzDecompress(const unsigned char* source, size_t size, unsigned char* out, size_t rawSize)
+{
+	const unsigned char* end = source + size;
+	size_t written = 0;
+
+	// Reads an extended length, false past the end of the input
+	auto getLength = [&](size_t& length) {
+		unsigned char byte;
+		do
+		{
+			if (source >= end)
+				return false;
+			byte = *source++;
+			length += byte;
+		} while (byte == 255);
+		return true;
+	};
+
+	while (source < end)
+	{
+		unsigned char token = *source++;
+		size_t literalLength = token >> 4;
+		if ((literalLength == 15) && !getLength(literalLength))
+			return false;
+		if (((size_t)(end - source) < literalLength) || (rawSize - written < literalLength))
+			return false;
+		memcpy(out + written, source, literalLength);
+		source += literalLength;
+		written += literalLength;
+		if (source >= end) // Last sequence
+			break;
+
+		if (end - source < 2)
+			return false;
+		size_t offset = source[0] | ((size_t)source[1] << 8);
+		source += 2;
+		size_t matchLength = token & 0x0F;
+		if ((matchLength == 15) && !getLength(matchLength))
+			return false;
+		matchLength += lzMinMatch;
+		if ((offset == 0) || (offset > written) || (rawSize - written < matchLength))
+			return false;
+		for (size_t k = 0; k < matchLength; k++) // Byte by byte: a match may overlap its own output
+			out[written + k] = out[written - offset + k];
+		written += matchLength;
+	}
+	return written == rawSize;
+}
+
+// --- Payload columns ---
+
+// Bytes of the payload of `count` particles
+static size_t shapesPayloadBytes(uint64_t count, size_t valueBytes)
+{
+	return (size_t)count * (2 + shapesFloatColumns * valueBytes);
+}
+
+static const std::vector<double>& shapesColumn(const ParticleSet& particles, int c)
+{
+	switch (c)
+	{
+	case 0: return particles.centerX;
+	case 1: return particles.centerY;
+	case 2: return particles.a;
+	case 3: return particles.b;
+	case 4: return particles.hoop;
+	default: return particles.slope;
+	}
+}
+
+// Stores one value of a column: at byte b of value i, or at byte plane b (shuffled columns)
+template <typename V>
+static void putColumn(const std::vector<double>& values, unsigned char* out, bool shuffle)
+{
+	size_t n = values.size();
+	for (size_t i = 0; i < n; i++)
+	{
+		V v = (V)values[i];
+		unsigned char bytes[sizeof(V)];
+		memcpy(bytes, &v, sizeof(V));
+		for (size_t b = 0; b < sizeof(V); b++)
+			out[shuffle ? b * n + i : i * sizeof(V) + b] = bytes[b];
+	}
+}
+
+template <typename V>
+static void getColumn(const unsigned char* in, size_t n, bool shuffle, std::vector<double>& values)
+{
+	values.resize(n);
+	for (size_t i = 0; i < n; i++)
+	{
+		unsigned char bytes[sizeof(V)];
+		for (size_t b = 0; b < sizeof(V); b++)
+			bytes[b] = in[shuffle ? b * n + i : i * sizeof(V) + b];
+		V v;
+		memcpy(&v, bytes, sizeof(V));
+		values[i] = (double)v;
+	}
+}
+
+// --- 64 bit file offsets ---
+
+static int seekTo(FILE* file, uint64_t offset, int origin)
+{
+#ifdef _WIN32
+	return _fseeki64(file, (__int64)offset, origin);
+#else
+	return fseeko(file, (off_t)offset, origin);
+#endif
+}
+
+static uint64_t fileSize(FILE* file)
+{
+	seekTo(file, 0, SEEK_END);
+#ifdef _WIN32
+	return (uint64_t)_ftelli64(file);
+#else
+	return (uint64_t)ftello(file);
+#endif
+}
+
+// Index of the complete records from the first one on (a file without index). Returns the end of the last one.
+static uint64_t scanShapesRecords(FILE* file, std::vector<ShapesIndexEntry>& index)
+{
+	index.clear();
+	uint64_t size = fileSize(file);
+	uint64_t offset = sizeof(ShapesFileHeader);
+	ShapesRecordHeader record;
+	while ((seekTo(file, offset, SEEK_SET) == 0) && (fread(&record, sizeof(record), 1, file) == 1) && (record.tag == shapesRecordTag))
+	{
+		ShapesIndexEntry entry = { record.caseNo, 0, offset, record.count };
+		if (record.storedBytes > size - offset - sizeof(record)) // Last record cut short
+			break;
+		offset += sizeof(record) + record.storedBytes;
+		index.push_back(entry);
+	}
+	return offset;
+}
+
+// --- ShapesWriter ---
+
+struct ShapesWriter::State {
+	FILE* file = NULL;
+	std::string fileName;
+	uint32_t flags = 0;
+	uint64_t offset = 0;                  // End of the file
+	std::vector<ShapesIndexEntry> index;
+	bool failed = false;                  // A write failed (reported once)
+
+	void write(const void* data, size_t size)
+	{
+		if ((fwrite(data, 1, size, file) != size) && !failed)
+		{
+			failed = true;
+			std::cerr << "*** Warning: Error writing at shapes file " << fileName << " ****\n";
+		}
+		offset += size;
+	}
+};
+
+ShapesWriter::ShapesWriter(void)
+{
+}
+
+ShapesWriter::~ShapesWriter(void)
+{
+	close();
+}
+
+bool ShapesWriter::open(const std::string& fileName, int width, int height, int totalComponents, bool float32, bool compress)
+{
+	close();
+	FILE* file = fopen(fileName.c_str(), "wb");
+	if (file == NULL)
+	{
+		std::cerr << "Error: Could not open or create file for writing: " << fileName << "\n";
+		return false;
+	}
+
+	state = std::make_shared<State>();
+	state->file = file;
+	state->fileName = fileName;
+	state->flags = (compress ? shapesCompressed : 0) | (float32 ? shapesFloat32 : 0);
+
+	ShapesFileHeader header = {};
+	memcpy(header.magic, shapesFileMagic, sizeof(header.magic));
+	header.version = 1;
+	header.flags = state->flags;
+	header.width = width;
+	header.height = height;
+	header.totalComponents = totalComponents;
+	state->write(&header, sizeof(header));
+	return true;
+}
+
+bool ShapesWriter::resume(const std::string& fileName, int width, int height, int totalComponents, bool float32, bool compress, int cases)
+{
+	if (state)
+	{
+		close();
+		outputQueue.flush(); // The file is closed on the output queue
+	}
+	uint32_t flags = (compress ? shapesCompressed : 0) | (float32 ? shapesFloat32 : 0);
+
+	// Same grid, components and columns, else the file is created again
+	FILE* file = fopen(fileName.c_str(), "r+b");
+	ShapesFileHeader header = {};
+	if ((file == NULL) || (fread(&header, sizeof(header), 1, file) != 1) || (memcmp(header.magic, shapesFileMagic, sizeof(header.magic)) != 0)
+		|| (header.flags != flags) || (header.width != width) || (header.height != height) || (header.totalComponents != totalComponents))
+	{
+		if (file != NULL)
+		{
+			fclose(file);
+			std::cerr << "*** Warning: shapes file " << fileName << " does not belong to this run, it is created again ****\n";
+		}
+		open(fileName, width, height, totalComponents, float32, compress);
+		return false;
+	}
+
+	// Records of the finished realizations are kept, the rest (and an index) is cut
+	std::vector<ShapesIndexEntry> index;
+	scanShapesRecords(file, index);
+	size_t kept = 0;
+	while ((kept < index.size()) && (index[kept].caseNo < cases))
+		kept++;
+	uint64_t end = sizeof(ShapesFileHeader);
+	if (kept > 0)
+	{
+		ShapesRecordHeader record;
+		seekTo(file, index[kept - 1].offset, SEEK_SET);
+		if (fread(&record, sizeof(record), 1, file) == 1)
+			end = index[kept - 1].offset + sizeof(record) + record.storedBytes;
+	}
+	index.resize(kept);
+	fclose(file);
+	if (kept < (size_t)cases)
+		std::cerr << "*** Warning: shapes file " << fileName << " holds " << kept << " of " << cases << " finished realizations ****\n";
+
+	std::error_code error;
+	std::filesystem::resize_file(fileName, end, error);
+	file = error ? NULL : fopen(fileName.c_str(), "ab");
+	if (file == NULL)
+	{
+		std::cerr << "Error: Could not reopen shapes file " << fileName << "\n";
+		return false;
+	}
+	state = std::make_shared<State>();
+	state->file = file;
+	state->fileName = fileName;
+	state->flags = flags;
+	state->offset = end;
+	state->index = std::move(index);
+	return kept == (size_t)cases;
+}
+
+bool ShapesWriter::isOpen(void)
+{
+	return state != nullptr;
+}
+
+void ShapesWriter::append(int caseNo, const ParticleSet& particles)
+{
+	if (!state)
+		return;
+
+	// Snapshot of the columns (float columns in byte planes when compressed)
+	bool float32 = (state->flags & shapesFloat32) != 0;
+	bool compress = (state->flags & shapesCompressed) != 0;
+	size_t n = particles.size();
+	size_t valueBytes = float32 ? sizeof(float) : sizeof(double);
+	std::vector<unsigned char> raw(shapesPayloadBytes(n, valueBytes));
+	for (size_t i = 0; i < n; i++)
+	{
+		raw[i] = particles.component[i];
+		raw[n + i] = (unsigned char)particles.type[i];
+	}
+	for (int c = 0; c < shapesFloatColumns; c++)
+	{
+		unsigned char* out = raw.data() + 2 * n + c * n * valueBytes;
+		if (float32)
+			putColumn<float>(shapesColumn(particles, c), out, compress);
+		else
+			putColumn<double>(shapesColumn(particles, c), out, compress);
+	}
+
+	// Compression and the append run on the output queue, in submission order
+	size_t bytes = raw.size();
+	std::shared_ptr<State> s = state;
+	outputQueue.submit([s, caseNo, n, compress, raw = std::move(raw)]() {
+		std::vector<unsigned char> packed;
+		if (compress)
+		{
+			packed.reserve(raw.size() / 2);
+			lzCompress(raw.data(), raw.size(), packed);
+		}
+		const std::vector<unsigned char>& payload = (compress && (packed.size() < raw.size())) ? packed : raw;
+
+		ShapesRecordHeader record = { shapesRecordTag, caseNo, n, raw.size(), payload.size() };
+		ShapesIndexEntry entry = { caseNo, 0, s->offset, n };
+		s->index.push_back(entry);
+		s->write(&record, sizeof(record));
+		s->write(payload.data(), payload.size());
+		}, bytes);
+}
+
+void ShapesWriter::flush(void)
+{
+	if (!state)
+		return;
+	std::shared_ptr<State> s = state;
+	outputQueue.submit([s]() {
+		if ((fflush(s->file) != 0) && !s->failed)
+		{
+			s->failed = true;
+			std::cerr << "*** Warning: Error writing at shapes file " << s->fileName << " ****\n";
+		}
+		}, 0);
+}
+
+void ShapesWriter::close(void)
+{
+	if (!state)
+		return;
+
+	std::shared_ptr<State> s = state;
+	state.reset();
+	outputQueue.submit([s]() {
+		ShapesFileFooter footer = {};
+		footer.indexOffset = s->offset;
+		footer.entries = s->index.size();
+		memcpy(footer.magic, shapesIndexMagic, sizeof(footer.magic));
+		s->write(s->index.data(), s->index.size() * sizeof(ShapesIndexEntry));
+		s->write(&footer, sizeof(footer));
+		if ((fclose(s->file) != 0) && !s->failed)
+			std::cerr << "*** Warning: Error writing at shapes file " << s->fileName << " ****\n";
+		s->file = NULL;
+		}, 0);
+}
+
+// --- Merge ---
+
+int mergeShapesFiles(const std::vector<std::string>& parts, const std::string& fileName, int cases)
+{
+	struct Record {
+		int32_t caseNo;
+		size_t part;    // Index in `files`
+		uint64_t offset;
+	};
+	ShapesFileHeader header = {};
+	std::vector<FILE*> files;
+	std::vector<Record> records;
+	for (const std::string& part : parts)
+	{
+		ShapesReader reader;
+		if (!reader.open(part))
+			continue;
+		if (!files.empty() && ((reader.header.flags != header.flags) || (reader.header.width != header.width)
+			|| (reader.header.height != header.height) || (reader.header.totalComponents != header.totalComponents)))
+		{
+			std::cerr << "*** Warning: shapes file " << part << " is of another grid or format, it is not merged ****\n";
+			continue;
+		}
+		FILE* file = fopen(part.c_str(), "rb");
+		if (file == NULL)
+			continue;
+		header = reader.header;
+		for (const ShapesIndexEntry& entry : reader.index)
+			if ((entry.caseNo >= 0) && (entry.caseNo < cases))
+				records.push_back({ entry.caseNo, files.size(), entry.offset });
+		files.push_back(file);
+	}
+	auto closeParts = [&]() {
+		for (FILE* file : files)
+			fclose(file);
+	};
+	if (files.empty())
+		return -1;
+
+	// Case order, the first part of a realization stored twice
+	std::stable_sort(records.begin(), records.end(), [](const Record& x, const Record& y) { return x.caseNo < y.caseNo; });
+	records.erase(std::unique(records.begin(), records.end(), [](const Record& x, const Record& y) { return x.caseNo == y.caseNo; }), records.end());
+
+	std::string merged = fileName + ".merge";
+	FILE* out = fopen(merged.c_str(), "wb");
+	if (out == NULL)
+	{
+		std::cerr << "Error: Could not open or create file for writing: " << merged << "\n";
+		closeParts();
+		return -1;
+	}
+	bool ok = (fwrite(&header, sizeof(header), 1, out) == 1);
+	uint64_t offset = sizeof(header);
+	std::vector<ShapesIndexEntry> index;
+	std::vector<unsigned char> payload;
+	for (const Record& r : records)
+	{
+		FILE* file = files[r.part];
+		ShapesRecordHeader record;
+		uint64_t size = fileSize(file);
+		if ((seekTo(file, r.offset, SEEK_SET) != 0) || (fread(&record, sizeof(record), 1, file) != 1) || (record.tag != shapesRecordTag)
+			|| (record.storedBytes > size - r.offset - sizeof(record)))
+			continue;
+		payload.resize((size_t)record.storedBytes);
+		if ((payload.size() > 0) && (fread(payload.data(), 1, payload.size(), file) != payload.size()))
+			continue;
+		ShapesIndexEntry entry = { record.caseNo, 0, offset, record.count };
+		ok = ok && (fwrite(&record, sizeof(record), 1, out) == 1) && (fwrite(payload.data(), 1, payload.size(), out) == payload.size());
+		offset += sizeof(record) + payload.size();
+		index.push_back(entry);
+	}
+	closeParts();
+
+	ShapesFileFooter footer = {};
+	footer.indexOffset = offset;
+	footer.entries = index.size();
+	memcpy(footer.magic, shapesIndexMagic, sizeof(footer.magic));
+	ok = ok && (fwrite(index.data(), sizeof(ShapesIndexEntry), index.size(), out) == index.size()) && (fwrite(&footer, sizeof(footer), 1, out) == 1);
+	ok = (fclose(out) == 0) && ok;
+
+	std::error_code error;
+	if (ok)
+		std::filesystem::rename(merged, fileName, error);
+	if (!ok || error)
+	{
+		std::cerr << "*** Warning: Error writing at shapes file " << fileName << " ****\n";
+		std::filesystem::remove(merged, error);
+		return -1;
+	}
+	return (int)index.size();
+}
+
+// --- ShapesReader ---
+
+ShapesReader::~ShapesReader(void)
+{
+	close();
+}
+
+bool ShapesReader::open(const std::string& fileName)
+{
+	close();
+	file = fopen(fileName.c_str(), "rb");
+	if (file == NULL)
+	{
+		std::cerr << "Error: Could not open shapes file " << fileName << "\n";
+		return false;
+	}
+	if ((fread(&header, sizeof(header), 1, file) != 1) || (memcmp(header.magic, shapesFileMagic, sizeof(header.magic)) != 0))
+	{
+		std::cerr << "Error: " << fileName << " is not a shapes file\n";
+		close();
+		return false;
+	}
+
+	// The index is at the end of a closed file, its entries point at record headers before it
+	uint64_t size = fileSize(file);
+	ShapesFileFooter footer = {};
+	uint64_t maxEntries = (size >= sizeof(header) + sizeof(footer)) ? (size - sizeof(header) - sizeof(footer)) / sizeof(ShapesIndexEntry) : 0;
+	if ((size >= sizeof(header) + sizeof(footer)) && (seekTo(file, size - sizeof(footer), SEEK_SET) == 0)
+		&& (fread(&footer, sizeof(footer), 1, file) == 1) && (memcmp(footer.magic, shapesIndexMagic, sizeof(footer.magic)) == 0)
+		&& (footer.entries <= maxEntries) && (footer.indexOffset >= sizeof(header))
+		&& (footer.indexOffset + footer.entries * sizeof(ShapesIndexEntry) + sizeof(footer) == size))
+	{
+		index.resize((size_t)footer.entries);
+		seekTo(file, footer.indexOffset, SEEK_SET);
+		bool valid = (footer.entries == 0) || (fread(index.data(), sizeof(ShapesIndexEntry), index.size(), file) == index.size());
+		for (size_t k = 0; valid && (k < index.size()); k++)
+			valid = (index[k].offset >= sizeof(header)) && (index[k].offset <= footer.indexOffset)
+				&& (footer.indexOffset - index[k].offset >= sizeof(ShapesRecordHeader));
+		if (valid)
+		{
+			recordsEnd = footer.indexOffset;
+			return true;
+		}
+		std::cerr << "*** Warning: shapes file " << fileName << " has a corrupt index ****\n";
+	}
+
+	scanRecords();
+	return true;
+}
+
+void ShapesReader::scanRecords(void)
+{
+	std::cerr << "*** Warning: shapes file without index, its records are scanned ****\n";
+	recordsEnd = scanShapesRecords(file, index);
+}
+
+void ShapesReader::close(void)
+{
+	if (file != NULL)
+		fclose(file);
+	file = NULL;
+	index.clear();
+	recordsEnd = 0;
+}
+
+size_t ShapesReader::realizations(void) const
+{
+	return index.size();
+}
+
+bool ShapesReader::read(int caseNo, ParticleSet* particles)
+{
+	particles->clear();
+	if (file == NULL)
+		return false;
+
+	const ShapesIndexEntry* entry = NULL;
+	for (const ShapesIndexEntry& e : index)
+		if (e.caseNo == caseNo)
+			entry = &e;
+	if (entry == NULL)
+		return false;
+
+	ShapesRecordHeader record;
+	if ((seekTo(file, entry->offset, SEEK_SET) != 0) || (fread(&record, sizeof(record), 1, file) != 1) || (record.tag != shapesRecordTag))
+		return false;
+
+	// Sizes of a corrupt record are caught before anything is allocated: the payload lies before the
+	// end of the records, the particles fill the raw payload, and LZ sequences expand a byte to 255 at most
+	bool float32 = (header.flags & shapesFloat32) != 0;
+	bool shuffled = (header.flags & shapesCompressed) != 0;
+	size_t valueBytes = float32 ? sizeof(float) : sizeof(double);
+	uint64_t particleBytes = shapesPayloadBytes(1, valueBytes);
+	if ((record.storedBytes > recordsEnd - entry->offset - sizeof(record)) || (record.rawBytes % particleBytes != 0)
+		|| (record.count != record.rawBytes / particleBytes)
+		|| ((record.storedBytes != record.rawBytes) && (record.rawBytes / 255 > record.storedBytes + 1)))
+		return false;
+	size_t n = (size_t)record.count;
+
+	std::vector<unsigned char> stored((size_t)record.storedBytes);
+	if ((stored.size() > 0) && (fread(stored.data(), 1, stored.size(), file) != stored.size()))
+		return false;
+	std::vector<unsigned char> raw;
+	if (record.storedBytes == record.rawBytes)
+		raw.swap(stored);
+	else
+	{
+		raw.resize((size_t)record.rawBytes);
+		if (!lzDecompress(stored.data(), stored.size(), raw.data(), raw.size()))
+			return false;
+	}
+
+	std::vector<double> columns[shapesFloatColumns];
+	for (int c = 0; c < shapesFloatColumns; c++)
+	{
+		const unsigned char* in = raw.data() + 2 * n + c * n * valueBytes;
+		if (float32)
+			getColumn<float>(in, n, shuffled, columns[c]);
+		else
+			getColumn<double>(in, n, shuffled, columns[c]);
+	}
+
+	particles->reserve(n);
+	for (size_t k = 0; k < n; k++)
+		particles->add(columns[0][k], columns[1][k], columns[2][k], columns[3][k], columns[5][k], columns[4][k], raw[k], (ShapeType)raw[n + k]);
+	return true;
+}
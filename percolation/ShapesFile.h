@@ -0,0 +1,159 @@
+/*
+This file is part of Electric,Thermal, Mechanical Properties
+Estimation With Percolation Theory (ETMPEWPT) (2D version) program.
+
+Created from Eleftherios Lamprou lef27064@otenet.gr during PhD thesis (2017-2024)
+
+ETMPEWPT is free software : you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+ETMPEWPT is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Foobar.If not, see < https://www.gnu.org/licenses/>.
+
+Theory of this is published in two papers:
+1. E. Lambrou and L. N. Gergidis, A computational method for calculating the electrical and thermal properties of random composite ,
+Physica A: Statistical Mechanics and its Applications, Volume 642, 2024, 129760, ISSN 0378-4371,
+https://doi.org/10.1016/j.physa.2024.129760
+2. E. Lambrou and L. N. Gergidis, A particle digitization-based computational method for continuum percolation, Physica A: Statistical Mechanics
+and its Applications, vol. 590, p. 126738, 2022
+
+if you use this programm and write a paper or report please cite above papers
+
+*/
+
+#pragma once // Ensures this header file is included only once in a compilation unit.
+
+#include <stdio.h>   // FILE, fopen, fread, fwrite.
+#include <stdint.h>  // Fixed size fields of the file layout.
+#include <string>
+#include <vector>
+#include <memory>    // The writer state is shared with the queued writes.
+#include "Shapes.h"  // ParticleSet, the columns stored per realization.
+
+// Binary shapes container: the particles of all realizations of one input in one file.
+//
+// Layout (little-endian):
+//   ShapesFileHeader
+//   per realization: ShapesRecordHeader + payload
+//   ShapesIndexEntry[realizations] + ShapesFileFooter (written by close)
+// The payload holds the columns of a ParticleSet: component (uint8), type (uint8), then
+// centerX, centerY, a, b, hoop and slope as float64 (or float32). In compressed files every
+// float column is split in byte planes and the payload is LZ compressed; a record that does not
+// shrink is stored raw (storedBytes == rawBytes). A file without index (the run was stopped)
+// is still readable: its records are scanned one after the other.
+
+const char shapesFileMagic[8] = { 'P', 'E', 'R', 'C', 'S', 'H', 'P', '1' };
+const char shapesIndexMagic[8] = { 'P', 'E', 'R', 'C', 'I', 'D', 'X', '1' };
+const uint32_t shapesRecordTag = 0x4C414552; // "REAL"
+const uint32_t shapesCompressed = 1;         // Header flag: LZ compressed payloads.
+const uint32_t shapesFloat32 = 2;            // Header flag: float32 columns.
+
+struct ShapesFileHeader {
+	char magic[8];            // shapesFileMagic
+	uint32_t version;         // 1
+	uint32_t flags;           // shapesCompressed | shapesFloat32
+	int32_t width, height;    // Generation grid (pixels) of the stored coordinates.
+	int32_t totalComponents;  // Components of the input.
+	uint32_t reserved;
+};
+
+struct ShapesRecordHeader {
+	uint32_t tag;             // shapesRecordTag
+	int32_t caseNo;           // Realization number.
+	uint64_t count;           // Particles.
+	uint64_t rawBytes;        // Payload size before compression.
+	uint64_t storedBytes;     // Payload size in the file.
+};
+
+struct ShapesIndexEntry {
+	int32_t caseNo;           // Realization number.
+	uint32_t reserved;
+	uint64_t offset;          // File offset of the ShapesRecordHeader.
+	uint64_t count;           // Particles.
+};
+
+struct ShapesFileFooter {
+	uint64_t indexOffset;     // File offset of the first ShapesIndexEntry.
+	uint64_t entries;         // Index entries.
+	char magic[8];            // shapesIndexMagic
+};
+
+// LZ77 byte codec (LZ4 style sequences: token, literals, 16 bit offset, match length).
+// Appends the compressed form of `size` bytes of `source` to `out`.
+void lzCompress(const unsigned char* source, size_t size, std::vector<unsigned char>& out);
+// Decompresses `size` bytes into exactly `rawSize` bytes of `out`. Returns false on corrupt input.
+bool lzDecompress(const unsigned char* source, size_t size, unsigned char* out, size_t rawSize);
+
+// Writes the realizations of one input to a binary shapes file. Records are encoded and
+// appended on the output queue (in order), so the generator is not kept waiting for the disk.
+class ShapesWriter {
+	struct State;                 // File, flags and index, shared with the queued writes.
+	std::shared_ptr<State> state;
+
+public:
+	ShapesWriter(void);
+	// Destructor: closes the file (writes the index).
+	~ShapesWriter(void);
+
+	// Creates the file and writes its header.
+	// @param fileName Name of the shapes file.
+	// @param width, height Generation grid of the particle coordinates.
+	// @param totalComponents Components of the input.
+	// @param float32 Stores the geometry columns as float32 (else float64).
+	// @param compress LZ compresses the records.
+	// @return false if the file cannot be created.
+	bool open(const std::string& fileName, int width, int height, int totalComponents, bool float32, bool compress);
+	// Reopens the file of an interrupted run: the records of realizations before `cases` are kept,
+	// the rest is cut and new records are appended. A missing file, or one of another grid or
+	// format, is created again as by open. Returns false if the records were not all kept.
+	bool resume(const std::string& fileName, int width, int height, int totalComponents, bool float32, bool compress, int cases);
+	// True between open and close.
+	bool isOpen(void);
+	// Appends the particles of realization caseNo (a snapshot is taken, `particles` can change at once).
+	void append(int caseNo, const ParticleSet& particles);
+	// Flushes the appended records to the file (on the output queue, after them).
+	void flush(void);
+	// Writes the index and closes the file.
+	void close(void);
+};
+
+// Copies the records of realizations before `cases` from the shapes files `parts` (e.g. one per
+// rank of an MPI run) into one file `fileName`, in case order and with its index. A realization
+// stored twice is taken from the first part that has it; parts of another grid or format are
+// skipped. `fileName` may be one of the parts (the merge is written aside and renamed).
+// Returns the realizations written, or -1 if the file cannot be written.
+int mergeShapesFiles(const std::vector<std::string>& parts, const std::string& fileName, int cases);
+
+// Reads any realization of a binary shapes file back into a ParticleSet.
+class ShapesReader {
+	FILE* file = NULL;
+	uint64_t recordsEnd = 0; // End of the records (the index, or the end of the last complete record).
+
+	// Rebuilds the index of a file without one, record by record.
+	void scanRecords(void);
+
+public:
+	ShapesFileHeader header = {};          // Header of the open file.
+	std::vector<ShapesIndexEntry> index;   // One entry per stored realization, in file order.
+
+	ShapesReader(void) {};
+	~ShapesReader(void);
+
+	// Opens a shapes file and loads (or rebuilds) its index. An index that points outside the records
+	// (a truncated or corrupt file) is rebuilt too. Returns false if it is not a shapes file.
+	bool open(const std::string& fileName);
+	void close(void);
+
+	// Number of stored realizations.
+	size_t realizations(void) const;
+	// Loads realization caseNo into `particles` (cleared first), in generation order.
+	// Coordinates are in pixels of the header's generation grid. Returns false if it is missing or corrupt.
+	bool read(int caseNo, ParticleSet* particles);
+};
@@ -0,0 +1,267 @@
+/*
+This file is part of Electric,Thermal, Mechanical Properties
+Estimation With Percolation Theory (ETMPEWPT) (2D version) program.
+
+Created from Eleftherios Lamprou lef27064@otenet.gr during PhD thesis (2017-2024)
+
+ETMPEWPT is free software : you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+ETMPEWPT is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Foobar.If not, see < https://www.gnu.org/licenses/>.
+
+Theory of this is published in two papers:
+1. E. Lambrou and L. N. Gergidis, A computational method for calculating the electrical and thermal properties of random composite ,
+Physica A: Statistical Mechanics and its Applications, Volume 642, 2024, 129760, ISSN 0378-4371,
+https://doi.org/10.1016/j.physa.2024.129760
+2. E. Lambrou and L. N. Gergidis, A particle digitization-based computational method for continuum percolation, Physica A: Statistical Mechanics
+and its Applications, vol. 590, p. 126738, 2022
+
+if you use this programm and write a paper or report please cite above papers
+
+*/
+
+#include "TiledGrid.h"
+#include <algorithm> // For std::min, std::fill.
+
+// Constructor: Splits a virtual width x height grid into tiles. No cell memory is allocated here;
+// the tile is created by the first call of `materialize`.
+TiledGrid::TiledGrid(int iWidth, int iHeight, int iTileSize) : width(iWidth), height(iHeight), tileSize(iTileSize), tile(NULL)
+{
+	if (tileSize < 1)
+		tileSize = 1;
+	tilesX = (width + tileSize - 1) / tileSize;  // Last column of tiles may be narrower.
+	tilesY = (height + tileSize - 1) / tileSize; // Last row of tiles may be lower.
+	clear();
+}
+
+// `clear` method: Resets the union-find and the border rows for a new realization.
+// Must be called again if `periodic` is changed.
+void TiledGrid::clear(void)
+{
+	parent.clear();
+	clusterSize.clear();
+	touchesTop.clear();
+	touchesBottom.clear();
+
+	upperRow.assign(width, -1);
+	topRow.assign(periodic ? width : 0, -1);
+	leftColumn.assign(tileSize, -1);
+	firstColumn.assign(tileSize, -1);
+
+	totalClusters = 0;
+	maxClusterSize = 0;
+	hardCells = 0;
+	percolates = false;
+}
+
+// `tileRange` method: Domain pixels covered by tile (tx, ty).
+Range TiledGrid::tileRange(int tx, int ty)
+{
+	int x0 = tx * tileSize; // Left column of the tile.
+	int y0 = ty * tileSize; // Top row of the tile.
+	return Range(iPoint(x0, y0), iPoint(std::min(x0 + tileSize, width) - 1, std::min(y0 + tileSize, height) - 1));
+}
+
+// `materialize` method: Returns an empty Grid for tile (tx, ty). The previous tile is evicted;
+// its memory is reused unless the tile size changes (last column / row of tiles).
+Grid* TiledGrid::materialize(int tx, int ty)
+{
+	Range region = tileRange(tx, ty);
+	int tw = region.to.x - region.from.x + 1; // Tile width.
+	int th = region.to.y - region.from.y + 1; // Tile height.
+
+	if ((tile == NULL) || (tile->width != tw) || (tile->height != th))
+	{
+		delete tile;
+		tile = new Grid(tw, th);
+	}
+	else
+		tile->clear();
+	return tile;
+}
+
+// `find` method: Root of label l, halving the path on the way.
+int TiledGrid::find(int l)
+{
+	while (parent[l] != l)
+	{
+		parent[l] = parent[parent[l]];
+		l = parent[l];
+	}
+	return l;
+}
+
+// `unite` method: Joins two clusters (union by size), merging their sizes and border flags.
+void TiledGrid::unite(int l1, int l2)
+{
+	int r1 = find(l1);
+	int r2 = find(l2);
+	if (r1 == r2)
+		return;
+	if (clusterSize[r1] < clusterSize[r2])
+		std::swap(r1, r2);
+	parent[r2] = r1;
+	clusterSize[r1] += clusterSize[r2];
+	touchesTop[r1] = touchesTop[r1] || touchesTop[r2];
+	touchesBottom[r1] = touchesBottom[r1] || touchesBottom[r2];
+}
+
+// `newLabel` method: Adds an empty cluster to the union-find.
+int TiledGrid::newLabel(void)
+{
+	int l = (int)parent.size();
+	parent.push_back(l);
+	clusterSize.push_back(0);
+	touchesTop.push_back(0);
+	touchesBottom.push_back(0);
+	return l;
+}
+
+// `retire` method: A cluster that cannot grow any more is counted.
+void TiledGrid::retire(int root)
+{
+	totalClusters++;
+	if (clusterSize[root] > maxClusterSize)
+		maxClusterSize = clusterSize[root];
+}
+
+// `addTile` method: Single pass labelling of the HARD cells of the tile. The left neighbour of
+// the first column comes from the previous tile, the upper neighbour of the first row from the
+// previous row of tiles, so clusters are joined across tile borders without keeping the tiles.
+void TiledGrid::addTile(int tx, int ty)
+{
+	Range region = tileRange(tx, ty);
+	int x0 = region.from.x;   // Domain column of the tile's first column.
+	int y0 = region.from.y;   // Domain row of the tile's first row.
+	int tw = tile->width;     // Tile width.
+	int th = tile->height;    // Tile height.
+
+	local.assign((size_t)tw * th, -1);
+	if (tx == 0)
+		std::fill(leftColumn.begin(), leftColumn.end(), -1); // No tile on the left of the first column.
+
+	for (int y = 0; y < th; y++)
+		for (int x = 0; x < tw; x++)
+		{
+			size_t where = (size_t)y * tw + x;
+			if (tile->cell[where] != CellState::HARD)
+				continue;
+
+			int left = (x > 0) ? local[where - 1] : leftColumn[y]; // Label of the left neighbour.
+			int up = (y > 0) ? local[where - tw] : upperRow[x0 + x]; // Label of the upper neighbour.
+			int l;
+			if (left >= 0)
+			{
+				l = left;
+				if (up >= 0)
+					unite(left, up);
+			}
+			else if (up >= 0)
+				l = up;
+			else
+				l = newLabel();
+			local[where] = l;
+
+			int root = find(l);
+			clusterSize[root]++;
+			if (y0 + y == 0)
+				touchesTop[root] = 1;
+			if (y0 + y == height - 1)
+				touchesBottom[root] = 1;
+			hardCells++;
+		}
+
+	// Keep the borders needed by the next tiles, then evict the labels of the tile.
+	for (int y = 0; y < th; y++)
+		leftColumn[y] = local[(size_t)y * tw + tw - 1];
+	if (tx == 0)
+		for (int y = 0; y < th; y++)
+			firstColumn[y] = local[(size_t)y * tw];
+	for (int x = 0; x < tw; x++)
+		upperRow[x0 + x] = local[(size_t)(th - 1) * tw + x];
+	if (periodic && (ty == 0))
+		for (int x = 0; x < tw; x++)
+			topRow[x0 + x] = local[x];
+
+	if (tx == tilesX - 1) // Row of tiles completed
+	{
+		if (periodic) // Last column touches the first one
+			for (int y = 0; y < th; y++)
+				if ((leftColumn[y] >= 0) && (firstColumn[y] >= 0))
+					unite(leftColumn[y], firstColumn[y]);
+		if (ty < tilesY - 1)
+			compact();
+	}
+}
+
+// `compact` method: After a row of tiles only the clusters on `upperRow` (and `topRow` when periodic)
+// can still grow. All others are counted now and the live ones get new consecutive labels, so the
+// union-find stays proportional to one row of tiles.
+void TiledGrid::compact(void)
+{
+	std::vector<int> newLabels(parent.size(), -1);
+	std::vector<size_t> newSize;
+	std::vector<char> newTop, newBottom;
+
+	auto relabel = [&](int& l) {
+		if (l < 0)
+			return;
+		int root = find(l);
+		if (newLabels[root] < 0)
+		{
+			newLabels[root] = (int)newSize.size();
+			newSize.push_back(clusterSize[root]);
+			newTop.push_back(touchesTop[root]);
+			newBottom.push_back(touchesBottom[root]);
+		}
+		l = newLabels[root];
+		};
+	for (size_t x = 0; x < upperRow.size(); x++)
+		relabel(upperRow[x]);
+	for (size_t x = 0; x < topRow.size(); x++)
+		relabel(topRow[x]);
+
+	for (size_t l = 0; l < parent.size(); l++)
+		if ((parent[l] == (int)l) && (newLabels[l] < 0))
+			retire((int)l);
+
+	parent.resize(newSize.size());
+	for (size_t l = 0; l < parent.size(); l++)
+		parent[l] = (int)l;
+	clusterSize.swap(newSize);
+	touchesTop.swap(newTop);
+	touchesBottom.swap(newBottom);
+}
+
+// `finish` method: Percolation is decided before the periodic y wrap is closed (a path has to
+// cross the domain, not go around it); then every remaining cluster is counted.
+void TiledGrid::finish(void)
+{
+	for (size_t l = 0; l < parent.size(); l++)
+		if ((parent[l] == (int)l) && touchesTop[l] && touchesBottom[l])
+			percolates = true;
+
+	if (periodic)
+		for (size_t x = 0; x < topRow.size(); x++)
+			if ((topRow[x] >= 0) && (upperRow[x] >= 0))
+				unite(topRow[x], upperRow[x]);
+
+	for (size_t l = 0; l < parent.size(); l++)
+		if (parent[l] == (int)l)
+			retire((int)l);
+}
+
+// Destructor: Frees the tile.
+TiledGrid::~TiledGrid()
+{
+	delete tile;
+	tile = NULL;
+}
@@ -0,0 +1,94 @@
+/*
+This file is part of Electric,Thermal, Mechanical Properties
+Estimation With Percolation Theory (ETMPEWPT) (2D version) program.
+
+Created from Eleftherios Lamprou lef27064@otenet.gr during PhD thesis (2017-2024)
+
+ETMPEWPT is free software : you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+ETMPEWPT is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Foobar.If not, see < https://www.gnu.org/licenses/>.
+
+Theory of this is published in two papers:
+1. E. Lambrou and L. N. Gergidis, A computational method for calculating the electrical and thermal properties of random composite ,
+Physica A: Statistical Mechanics and its Applications, Volume 642, 2024, 129760, ISSN 0378-4371,
+https://doi.org/10.1016/j.physa.2024.129760
+2. E. Lambrou and L. N. Gergidis, A particle digitization-based computational method for continuum percolation, Physica A: Statistical Mechanics
+and its Applications, vol. 590, p. 126738, 2022
+
+if you use this programm and write a paper or report please cite above papers
+
+*/
+
+#pragma once // Ensures this header file is included only once in a compilation unit.
+
+#include <vector>   // For std::vector (union-find arrays and border label rows).
+#include "Grid.h"   // A tile is materialized as a regular (small) Grid.
+#include "Shapes.h" // For Range.
+
+// Definition of the TiledGrid class: a lazily materialized grid for very large RVEs.
+// Only one tile (tileSize x tileSize pixels) exists in memory at a time. The caller rasterizes
+// the tile from the particle list, then `addTile` labels its HARD cells (4-connected) and
+// joins them to the neighbouring tiles through the labels of the tile borders (union-find).
+// Tiles must be added row by row, left to right. Memory is O(tileSize^2 + width) plus the
+// union-find entries of one row of tiles.
+class TiledGrid {
+	std::vector<int> parent;        // Union-find parent of every live label.
+	std::vector<size_t> clusterSize; // Pixels of the cluster (valid on roots).
+	std::vector<char> touchesTop;   // Cluster reaches row 0 of the domain (valid on roots).
+	std::vector<char> touchesBottom; // Cluster reaches the last row of the domain (valid on roots).
+
+	std::vector<int> upperRow;      // Labels of the last row of the previous row of tiles (-1: not HARD).
+	std::vector<int> topRow;        // Labels of row 0 of the domain (periodic y wrap).
+	std::vector<int> leftColumn;    // Labels of the right column of the previous tile in the row.
+	std::vector<int> firstColumn;   // Labels of the left column of the first tile in the row (periodic x wrap).
+	std::vector<int> local;         // Labels of the current tile.
+
+	// Finds the root of label l (path halving).
+	int find(int l);
+	// Joins the clusters of labels l1 and l2.
+	void unite(int l1, int l2);
+	// Creates a new (empty) cluster and returns its label.
+	int newLabel(void);
+	// Retires the clusters that no longer reach the live borders and renumbers the rest.
+	void compact(void);
+	// Counts a finished cluster.
+	void retire(int root);
+
+public:
+	int width, height;     // Dimensions of the whole (virtual) grid.
+	int tileSize;          // Edge of a tile in pixels.
+	int tilesX, tilesY;    // Number of tiles in x and y.
+	bool periodic = false; // Periodic boundaries: clusters wrap in x and y, percolation wraps in x only.
+	Grid* tile;            // The currently materialized tile (reallocated only when its size changes).
+
+	size_t totalClusters = 0;   // Number of HARD clusters in the domain.
+	size_t maxClusterSize = 0;  // Pixels of the largest cluster.
+	size_t hardCells = 0;       // Total HARD cells in the domain.
+	bool percolates = false;    // A cluster connects the first and the last row.
+
+	// Constructor: a virtual width x height grid split into tiles of iTileSize pixels.
+	TiledGrid(int iWidth, int iHeight, int iTileSize);
+
+	// Resets the connectivity summary for a new realization.
+	void clear(void);
+	// Returns the domain pixels covered by tile (tx, ty); `to` is inclusive.
+	Range tileRange(int tx, int ty);
+	// Materializes an empty tile (tx, ty) and returns it for rasterization.
+	Grid* materialize(int tx, int ty);
+	// Labels the materialized tile (tx, ty) and merges it with its left and upper neighbours.
+	void addTile(int tx, int ty);
+	// Closes the last row of tiles, decides percolation and counts the remaining clusters.
+	void finish(void);
+
+	// Destructor: Frees the tile.
+	~TiledGrid();
+};
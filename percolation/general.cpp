@@ -38,6 +38,15 @@ if you use this programm and write a paper or report please cite above papers
 #include <numeric>    // For numeric operations, specifically std::accumulate for summing array elements
 #include <limits>     // For std::numeric_limits, used to get properties of numeric types (e.g., NaN)
 
+#if defined(_WIN32)
+#define NOMINMAX      // Keep std::min / std::max usable after <windows.h>
+#include <windows.h>  // For GlobalMemoryStatusEx
+#include <psapi.h>    // For GetProcessMemoryInfo
+#pragma comment(lib, "psapi.lib")
+#elif defined(__unix__) || defined(__APPLE__)
+#include <unistd.h>   // For sysconf
+#endif
+
 /// <summary>
 /// Provides a delay for a specified number of seconds.
 /// This function pauses the program's execution for the duration specified by `number_of_seconds`.
@@ -145,4 +154,68 @@ double average_element(double values[], int first, int last)
     double sum = std::accumulate(values + first, values + last, 0.0);
     // Calculate the average by dividing the sum by the number of elements in the range.
     return sum / (last - first);
-}
\ No newline at end of file
+}
+
+/// <summary>
+/// Returns the physical memory currently available to new allocations.
+/// On Linux this is `MemAvailable` of /proc/meminfo (free memory plus reclaimable page cache),
+/// elsewhere the free physical pages reported by the operating system.
+/// </summary>
+/// <returns>Available memory in bytes, or 0 when it can not be determined.</returns>
+size_t availableMemory(void)
+{
+#if defined(_WIN32)
+    MEMORYSTATUSEX status;
+    status.dwLength = sizeof(status);
+    if (GlobalMemoryStatusEx(&status))
+        return (size_t)status.ullAvailPhys;
+    return 0;
+#elif defined(__unix__) || defined(__APPLE__)
+    std::ifstream meminfo("/proc/meminfo");
+    std::string key;
+    size_t kiloBytes;
+    // Lines are "Key: value kB"
+    while (meminfo >> key >> kiloBytes)
+    {
+        if (key == "MemAvailable:")
+            return kiloBytes * 1024;
+        meminfo.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+    }
+#if defined(_SC_AVPHYS_PAGES)
+    long pages = sysconf(_SC_AVPHYS_PAGES);
+#else
+    long pages = sysconf(_SC_PHYS_PAGES);
+#endif
+    long pageSize = sysconf(_SC_PAGESIZE);
+    if ((pages > 0) && (pageSize > 0))
+        return (size_t)pages * (size_t)pageSize;
+    return 0;
+#else
+    return 0;
+#endif
+}
+
+/// <summary>
+/// Returns the physical memory used by this process (its resident set).
+/// On Linux this is the second field of /proc/self/statm times the page size,
+/// on Windows the working set of the process.
+/// </summary>
+/// <returns>Resident memory in bytes, or 0 when it can not be determined.</returns>
+size_t residentMemory(void)
+{
+#if defined(_WIN32)
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+        return (size_t)counters.WorkingSetSize;
+    return 0;
+#elif defined(__unix__) || defined(__APPLE__)
+    std::ifstream statm("/proc/self/statm");
+    size_t totalPages, residentPages;
+    long pageSize = sysconf(_SC_PAGESIZE);
+    if ((statm >> totalPages >> residentPages) && (pageSize > 0))
+        return residentPages * (size_t)pageSize;
+    return 0;
+#else
+    return 0;
+#endif
+}
@@ -88,6 +88,46 @@ enum ShapeType
 	NOTHING = 4            // No specific shape (e.g., for matrix or generic elements)
 };
 
+// Enumeration defining the file format of the saved grid images
+enum ImageFormat
+{
+	BMP_IMAGE = 0, // 24 bit BMP
+	PGM_IMAGE = 1, // Binary (P5) gray map
+	PNG_IMAGE = 2  // Palette PNG, compressed with the built-in deflate
+};
+
+// Enumeration defining how the particles of every realization are saved
+enum ShapesFormat
+{
+	TEXT_SHAPES = 0,     // One text file per case and component
+	BINARY_SHAPES = 1,   // One binary shapes file per input, float64 columns
+	BINARY32_SHAPES = 2  // One binary shapes file per input, float32 columns
+};
+
+// Enumeration defining the solver of the Finite Differences (FD2DEL) voltage field
+enum FdmSolver
+{
+	CG_SOLVER = 0,          // Conjugate gradient of the whole grid on one thread (dembx)
+	BLOCK_JACOBI_SOLVER = 1, // Row strips per thread, block-Jacobi preconditioned conjugate gradient (dembxStrips)
+	AMG_SOLVER = 2,          // Conjugate gradient preconditioned by algebraic multigrid (dembxAmg)
+	MIXED_SOLVER = 3         // Conjugate gradient on single precision arrays, double sums and iterative refinement (dembxMixed)
+};
+
+// Enumeration defining what the ranks of an MPI run (mpirun -np N, build with PERC_MPI) share
+enum DistributeMode
+{
+	DISTRIBUTE_REALIZATIONS = 0, // All ranks run every input, each one takes the next realization
+	DISTRIBUTE_INPUTS = 1        // Each rank takes the next whole input file
+};
+
+// Enumeration defining where the planes (cell, visited, ingadients, cluster, clusterVisited) of a Grid are stored
+enum GridStorage
+{
+	HEAP = 0,          // malloc'd planes (default)
+	ANONYMOUS_MAP = 1, // Anonymous memory map with transparent huge pages
+	FILE_MAP = 2       // Shared memory map of a temporary (already deleted) file
+};
+
 // Structure to hold program information
 struct pinfo {
 	string program;      // Name of the program
@@ -127,4 +167,10 @@ double maxElement(double values[], int first, int last);
 double average_element(double values[], int first, int last);
 
 // Pauses the execution for a specified number of seconds.
-void delay(int number_of_seconds);
\ No newline at end of file
+void delay(int number_of_seconds);
+
+// Physical memory (bytes) currently available to new allocations, 0 if unknown.
+size_t availableMemory(void);
+
+// Physical memory (bytes) used by this process, 0 if unknown.
+size_t residentMemory(void);
\ No newline at end of file
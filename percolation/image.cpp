@@ -28,6 +28,9 @@ if you use this programm and write a paper or report please cite above papers
 */
 
 #include "image.h"
+#include <vector>     // Row chunk buffers
+#include <algorithm>  // std::min, std::max
+#include <iostream>   // std::cerr
 
 // --- Global Color Definitions Initialization ---
 // These are the global sRGB color variables declared in image.h.
@@ -51,381 +54,504 @@ sRGB RGB_Brown = { 96,128,160 }; // Brown (160,128,96) as {96,128,160}
 sRGB RGB_Orange = { 0x52,0x91,0xCD }; // Orange (205,145,82) as {82,145,205}
 
 
-void generatePGMImage(char* image, int height, int width, char* imageFileName)
+// --- CellState look up tables ---
+// Cell states are the characters '0'..'6' (see CellState). Every byte value is mapped once to a gray
+// level (PGM) and to a palette index (PNG), so the writers do one table look up per pixel.
+// Unknown codes map to black / EMPTY; they are counted and reported once per image.
+const int cellStatePaletteSize = 7; // EMPTY, PERCOLATE, SOFT, HARD, BORDER, PATH, SIDEPATH
+
+struct CellStateLUT {
+	unsigned char gray[256];  // Gray level per cell code
+	unsigned char index[256]; // Palette index per cell code
+	bool known[256];          // Code is a CellState
+	sRGB palette[cellStatePaletteSize]; // Colour of each palette index (same colours as the BMP writer)
+
+	CellStateLUT(void)
+	{
+		memset(gray, 0, sizeof(gray));
+		memset(index, 0, sizeof(index));
+		memset(known, 0, sizeof(known));
+		set(EMPTY, 0, RGB_Black);
+		set(PERCOLATE, 64, RGB_White);
+		set(SOFT, 128, RGB_Red);
+		set(HARD, 164, RGB_Orange);
+		set(BORDER, 96, RGB_Gray);
+		set(PATH, 254, RGB_Yellow);
+		set(SIDEPATH, 200, RGB_Light_Blue);
+	}
+
+	void set(CellState state, unsigned char grayLevel, sRGB colour)
+	{
+		unsigned char code = (unsigned char)state;
+		gray[code] = grayLevel;
+		index[code] = (unsigned char)(code - EMPTY);
+		known[code] = true;
+		palette[code - EMPTY] = colour;
+	}
+};
+
+// Built on first use (the colours above must be initialized first)
+static const CellStateLUT& cellStateLUT(void)
 {
-	// Use FILE* and C-style functions as per original requirement,
-	// but prefer std::ofstream for C++ streams in new code.
-	FILE* pgmimg = nullptr; // Initialize to nullptr for safety
+	static const CellStateLUT lut;
+	return lut;
+}
 
-	// Attempt to open the file. Check if fopen was successful.
-	pgmimg = fopen(imageFileName, "w");
+static void reportUnknownCellCodes(size_t unknown, char* imageFileName)
+{
+	if (unknown > 0)
+		std::cerr << "Warning: " << unknown << " pixels with unknown color code in " << imageFileName << " (saved as EMPTY)\n";
+}
+
+// Binary (P5) PGM: header, then the gray level of every pixel, rows top to bottom
+void generatePGMImage(char* image, int height, int width, char* imageFileName)
+{
+	FILE* pgmimg = fopen(imageFileName, "wb");
 	if (pgmimg == nullptr) {
-		// Use std::cerr for error output. It's generally unbuffered.
 		std::cerr << "\n*************************************************************************************\n";
 		std::cerr << "Error: Could not open or create file for writing: " << imageFileName << "\n";
 		std::cerr << "*************************************************************************************\n";
-		// It's often better to throw an exception or return an error code
-		// instead of just returning void, but adhering to original signature.
 		return;
 	}
 
 	// --- PGM Header Writing ---
-	// Writing Magic Number to the File (P2 for ASCII grayscale)
-	fprintf(pgmimg, "P2\n");
-
-	// Writing Width and Height
-	fprintf(pgmimg, "%d %d\n", width, height);
-
-	// Writing the maximum gray value
-	fprintf(pgmimg, "255\n"); // Max pixel value for 8-bit grayscale
+	// Magic Number (P5 for binary grayscale), width and height, maximum gray value
+	fprintf(pgmimg, "P5\n%d %d\n255\n", width, height);
 
 	// --- Image Data Writing ---
-	// Iterate through rows and columns to write pixel data.
-	for (int line = 0; line < height; ++line) // Use pre-increment for slight optimization
+	const CellStateLUT& lut = cellStateLUT();
+	size_t rowsPerChunk = std::max((size_t)1, imageChunkBytes / std::max(width, 1));
+	std::vector<unsigned char> chunk(rowsPerChunk * width);
+	size_t unknown = 0;
+
+	for (int line = 0; line < height; line += (int)rowsPerChunk)
 	{
-		for (int column = 0; column < width; ++column) // Use pre-increment
+		size_t rows = std::min(rowsPerChunk, (size_t)(height - line));
+		const unsigned char* codes = (const unsigned char*)image + (size_t)line * width;
+		size_t n = rows * width;
+		for (size_t k = 0; k < n; k++)
 		{
-			// Calculate the correct index into the 1D 'image' array.
-			// Explicitly cast to size_t for array indexing to prevent potential
-			// overflow issues with large dimensions on 32-bit systems.
-			unsigned char color_code = image[static_cast<size_t>(line) * width + column];
-			int gray_value; // Use a temporary variable for the gray value
-
-			// Use if-else if structure for cleaner logic than switch for non-contiguous cases.
-			// Or, ideally, use a map or array for lookup if there are many mappings.
-			if (color_code == EMPTY) {
-				gray_value = 0;
-			}
-			else if (color_code == CellState::PERCOLATE) {
-				gray_value = 64;
-			}
-			else if (color_code == CellState::SOFT) {
-				gray_value = 128;
-			}
-			else if (color_code == CellState::HARD) {
-				gray_value = 164;
-			}
-			else if (color_code == CellState::SIDEPATH) {
-				gray_value = 200;
-			}
-			else if (color_code == CellState::PATH) {
-				gray_value = 254;
-			}
-			else {
-				// Handle unexpected color_code values.
-				// You might want to log a warning or assign a default value.
-				gray_value = 0; // Default to black for unknown codes
-				std::cerr << "Warning: Unknown color code encountered: " << static_cast<int>(color_code) << " at (" << line << ", " << column << ")\n";
-			}
-
-			// Print the gray value followed by a space.
-			// Using %hhu (for unsigned char) or casting to int (%d) for fprintf is common.
-			// %d is generally safer as it promotes to int.
-			fprintf(pgmimg, "%d ", gray_value);
+			chunk[k] = lut.gray[codes[k]];
+			unknown += !lut.known[codes[k]];
 		}
-		// After each row, add a newline character for PGM format readability.
-		fprintf(pgmimg, "\n");
+		fwrite(chunk.data(), 1, n, pgmimg);
 	}
 
 	// --- File Closing and Error Checking ---
-	// Close the file and check the return value for potential write errors.
 	int err = fclose(pgmimg);
 	if (err != 0) {
 		std::cerr << "\n*** Warning: Error writing to PGM Image file '" << imageFileName << "' ****\n";
 	}
+	reportUnknownCellCodes(unknown, imageFileName);
 }
-//only for internal proposes code clearnce
-void setcolor(unsigned char* image, int start, unsigned char red, unsigned char green, unsigned char blue)
+
+// --- PNG ---
+// Palette (colour type 3, 8 bit) PNG with one palette entry per CellState. The image data is zlib
+// compressed with an in-tree deflate: LZ77 (hash of three bytes plus the previous pixel and the pixel
+// above as match candidates) coded with the fixed Huffman tables, streamed into 64 KiB IDAT chunks.
+
+static unsigned long crc32Update(unsigned long crc, const unsigned char* data, size_t n)
 {
-	image[start] = red;
-	image[start + 1] = green;
-	image[start + 2] = blue;
+	static const std::vector<unsigned long> table = [] {
+		std::vector<unsigned long> t(256);
+		for (unsigned long k = 0; k < 256; k++)
+		{
+			unsigned long c = k;
+			for (int b = 0; b < 8; b++)
+				c = (c & 1) ? 0xEDB88320UL ^ (c >> 1) : c >> 1;
+			t[k] = c;
+		}
+		return t;
+		}();
+	for (size_t k = 0; k < n; k++)
+		crc = table[(crc ^ data[k]) & 0xFF] ^ (crc >> 8);
+	return crc;
 }
 
-void setcolor(unsigned char* image, int start, sRGB iRGB)
+static void putBigEndian32(unsigned char* p, unsigned long value)
 {
-	image[start] = iRGB.red;
-	image[start + 1] = iRGB.green;
-	image[start + 2] = iRGB.blue;
+	p[0] = (unsigned char)(value >> 24);
+	p[1] = (unsigned char)(value >> 16);
+	p[2] = (unsigned char)(value >> 8);
+	p[3] = (unsigned char)(value);
 }
 
-
-//create bitmap from array
-void generateBitmapImage(char* image, int height, int width, char* imageFileName)
+// Writes one PNG chunk: length, type, data, CRC of type and data
+static void writePNGChunk(FILE* file, const char* type, const unsigned char* data, size_t n)
 {
+	unsigned char word[4];
+	putBigEndian32(word, (unsigned long)n);
+	fwrite(word, 1, 4, file);
+	fwrite(type, 1, 4, file);
+	if (n > 0)
+		fwrite(data, 1, n, file);
+	unsigned long crc = crc32Update(0xFFFFFFFFUL, (const unsigned char*)type, 4);
+	crc = crc32Update(crc, data, n) ^ 0xFFFFFFFFUL;
+	putBigEndian32(word, crc);
+	fwrite(word, 1, 4, file);
+}
 
-	//bmp format
-	unsigned char* fileHeader = createBitmapFileHeader(height, width);
-	unsigned char* infoHeader = createBitmapInfoHeader(height, width);
-	unsigned char padding[] = { 0, 0, 0 };
-
-	//one line of image 3 colors* width
-	unsigned char* colors = new unsigned char[bytesPerPixel * width]();
-
-	int paddingSize = (4 - (width * bytesPerPixel) % 4) % 4;
-
-
-	FILE* imageFile;
-	//int err;
-	imageFile = fopen(imageFileName, "w");
+// Streaming zlib (deflate, one fixed Huffman block) compressor writing IDAT chunks
+class PNGDeflater {
+public:
+	PNGDeflater(FILE* iFile, size_t iRowBytes) : file(iFile), rowBytes(iRowBytes), head(hashSize, -1)
+	{
+		out.push_back(0x78); // CMF: deflate, 32K window
+		out.push_back(0x01); // FLG: fastest, check bits
+		putBits(1, 1);       // BFINAL
+		putBits(1, 2);       // BTYPE = 01, fixed Huffman
+	}
 
-	//initialize
-	fwrite(fileHeader, 1, fileHeaderSize, imageFile);
-	fwrite(infoHeader, 1, infoHeaderSize, imageFile);
+	// Adds raw bytes; everything but the last maxMatch bytes is compressed right away
+	void write(const unsigned char* data, size_t n)
+	{
+		adler(data, n);
+		input.insert(input.end(), data, data + n);
+		compress(false);
+	}
 
+	// Compresses the rest, ends the block and the zlib stream, flushes the last IDAT
+	void finish(void)
+	{
+		compress(true);
+		putSymbol(256); // End of block
+		if (bitCount > 0)
+			putBits(0, 8 - bitCount);
+		unsigned char word[4];
+		putBigEndian32(word, (adlerB << 16) | adlerA);
+		out.insert(out.end(), word, word + 4);
+		flushIDAT();
+	}
 
-	//from botom to up
-	for (int line = height - 1; line >= 0; line--)
+private:
+	static const int window = 32768;
+	static const int minMatch = 3;
+	static const int maxMatch = 258;
+	static const int hashBits = 15;
+	static const int hashSize = 1 << hashBits;
+	static const size_t idatBytes = 1 << 16;
+
+	FILE* file;
+	size_t rowBytes;
+	std::vector<unsigned char> input; // Window (last 32K bytes already coded) plus pending bytes
+	size_t base = 0;                  // Stream position of input[0]
+	size_t pos = 0;                   // Next stream position to code
+	std::vector<long long> head;      // Last stream position of every 3 byte hash
+	std::vector<unsigned char> out;   // Compressed bytes not yet written
+	unsigned long bitBuffer = 0;
+	int bitCount = 0;
+	unsigned long adlerA = 1, adlerB = 0;
+
+	void adler(const unsigned char* data, size_t n)
 	{
-		for (int column = 0; column < width; column++)
+		while (n > 0)
 		{
-			unsigned char color = image[(size_t)line * width + column];
-			switch (color) {
-
-			case SOFT:setcolor(colors, 3 * column, RGB_Red); break;
-			case EMPTY:setcolor(colors, 3 * column, RGB_Black); break;
-			case HARD:  setcolor(colors, 3 * column, RGB_Orange);  break;
-			case PERCOLATE: setcolor(colors, 3 * column, RGB_White);  break;
-			case PATH:setcolor(colors, 3 * column, RGB_Yellow);  break;
-			case SIDEPATH:setcolor(colors, 3 * column, RGB_Light_Blue);  break;
-
+			size_t block = std::min(n, (size_t)5552); // Largest block without overflow before the modulo
+			for (size_t k = 0; k < block; k++)
+			{
+				adlerA += data[k];
+				adlerB += adlerA;
 			}
+			adlerA %= 65521;
+			adlerB %= 65521;
+			data += block;
+			n -= block;
 		}
-		//write line and pading
-		fwrite(colors, bytesPerPixel, width, imageFile);
-		fwrite(padding, 1, paddingSize, imageFile);
 	}
 
-	//close
-	fclose(imageFile);
-	delete[](colors);
-}
-
-
-
-//create bitmap from array
-void generateBitmapImageFortranStyle(int* image, int height, int width, char* imageFileName) {
-
-	//bmp format
-	unsigned char* fileHeader = createBitmapFileHeader(height, width);
-	unsigned char* infoHeader = createBitmapInfoHeader(height, width);
-	unsigned char padding[] = { 0, 0, 0 };
+	// Deflate packs bits LSB first
+	void putBits(unsigned long value, int n)
+	{
+		bitBuffer |= value << bitCount;
+		bitCount += n;
+		while (bitCount >= 8)
+		{
+			out.push_back((unsigned char)bitBuffer);
+			bitBuffer >>= 8;
+			bitCount -= 8;
+		}
+	}
 
-	//one line of image 3 colors* width
-	unsigned char* colors = new unsigned char[bytesPerPixel * width]();
+	// Huffman codes are packed MSB first
+	void putCode(unsigned int code, int n)
+	{
+		unsigned int reversed = 0;
+		for (int b = 0; b < n; b++)
+			reversed |= ((code >> b) & 1) << (n - 1 - b);
+		putBits(reversed, n);
+	}
 
-	int paddingSize = (4 - (width * bytesPerPixel) % 4) % 4;
+	// Fixed Huffman literal/length code
+	void putSymbol(int symbol)
+	{
+		if (symbol < 144)
+			putCode(0x30 + symbol, 8);
+		else if (symbol < 256)
+			putCode(0x190 + symbol - 144, 9);
+		else if (symbol < 280)
+			putCode(symbol - 256, 7);
+		else
+			putCode(0xC0 + symbol - 280, 8);
+	}
 
+	void putMatch(int length, int distance)
+	{
+		static const int lengthBase[29] = { 3,4,5,6,7,8,9,10,11,13,15,17,19,23,27,31,35,43,51,59,67,83,99,115,131,163,195,227,258 };
+		static const int lengthExtra[29] = { 0,0,0,0,0,0,0,0,1,1,1,1,2,2,2,2,3,3,3,3,4,4,4,4,5,5,5,5,0 };
+		static const int distanceBase[30] = { 1,2,3,4,5,7,9,13,17,25,33,49,65,97,129,193,257,385,513,769,1025,1537,2049,3073,4097,6145,8193,12289,16385,24577 };
+		static const int distanceExtra[30] = { 0,0,0,0,1,1,2,2,3,3,4,4,5,5,6,6,7,7,8,8,9,9,10,10,11,11,12,12,13,13 };
+
+		int l = 28;
+		while (lengthBase[l] > length)
+			l--;
+		putSymbol(257 + l);
+		putBits(length - lengthBase[l], lengthExtra[l]);
+
+		int d = 29;
+		while (distanceBase[d] > distance)
+			d--;
+		putCode(d, 5);
+		putBits(distance - distanceBase[d], distanceExtra[d]);
+	}
 
-	FILE* imageFile;
-	//int err;
-	imageFile = fopen(imageFileName, "w");
+	unsigned int hash(size_t p) const
+	{
+		const unsigned char* s = &input[p - base];
+		return ((s[0] << 10) ^ (s[1] << 5) ^ s[2]) & (hashSize - 1);
+	}
 
-	//initialize
-	fwrite(fileHeader, 1, fileHeaderSize, imageFile);
-	fwrite(infoHeader, 1, infoHeaderSize, imageFile);
+	int matchLength(size_t candidate, size_t p, size_t end) const
+	{
+		const unsigned char* a = &input[candidate - base];
+		const unsigned char* b = &input[p - base];
+		int limit = (int)std::min((size_t)maxMatch, end - p);
+		int n = 0;
+		while ((n < limit) && (a[n] == b[n]))
+			n++;
+		return n;
+	}
 
-	//from botom to up
-	for (int line = height - 1; line >= 0; line--)
+	void compress(bool last)
 	{
-		for (int column = 0; column < width; column++)
+		size_t end = base + input.size();
+		size_t stop = last ? end : ((end > (size_t)maxMatch) ? end - maxMatch : 0);
+		while (pos < stop)
 		{
-			int color = image[(size_t)line * width + column];
-			if (color == 1)
-				setcolor(colors, 3 * column, 0x00, 0x00, 0x00);
+			int bestLength = 0, bestDistance = 0;
+			if (pos + minMatch <= end)
+			{
+				// Candidates: last position with the same hash, the previous byte (runs), the pixel above
+				size_t candidates[3] = { 0, pos - 1, pos - rowBytes };
+				bool valid[3] = { false, pos >= 1, pos >= rowBytes };
+				unsigned int h = hash(pos);
+				if (head[h] >= 0)
+				{
+					candidates[0] = (size_t)head[h];
+					valid[0] = true;
+				}
+				for (int c = 0; c < 3; c++)
+				{
+					if (!valid[c] || (candidates[c] < base) || (pos - candidates[c] > (size_t)window))
+						continue;
+					int length = matchLength(candidates[c], pos, end);
+					if (length > bestLength)
+					{
+						bestLength = length;
+						bestDistance = (int)(pos - candidates[c]);
+					}
+				}
+			}
+
+			int advance = 1;
+			if (bestLength >= minMatch)
+			{
+				putMatch(bestLength, bestDistance);
+				advance = bestLength;
+			}
 			else
-				setcolor(colors, 3 * column, 0xFF, 0xFF, 0xFF);
+				putSymbol(input[pos - base]);
 
-			//case CellState::SOFT:setcolor(colors, 3 * column, 0x33, 0x99, 0xFF); break;
-			//case BORDER: setcolor(colors, 3 * column, 0xFF, 0xFF, 0xFF);  break;
+			for (int k = 0; k < advance; k++, pos++)
+				if (pos + minMatch <= end)
+					head[hash(pos)] = (long long)pos;
 
+			if (out.size() >= idatBytes)
+				flushIDAT();
+		}
 
-		//if (((line % 10) ==0) || ((column % 10) == 0))
-		//	setcolor(colors, 3 * column, 0x00, 0x80, 0x00);
+		// Keep only the window in memory
+		if (pos - base > 4 * (size_t)window)
+		{
+			size_t drop = pos - base - window;
+			input.erase(input.begin(), input.begin() + drop);
+			base += drop;
 		}
-		//write line and pading
-		fwrite(colors, bytesPerPixel, width, imageFile);
-		fwrite(padding, 1, paddingSize, imageFile);
 	}
 
-	//close
-	fclose(imageFile);
-	delete[](colors);
-
-}
-
-
-
-//create bitmap from array
-void saveClustersAsBitmapImage(unsigned char* image, int height, int width, char* imageFileName) {
-
-	//bmp format
-	unsigned char* fileHeader = createBitmapFileHeader(height, width);
-	unsigned char* infoHeader = createBitmapInfoHeader(height, width);
-	unsigned char padding[] = { 0, 0, 0 };
-
-	//one line of image 3 colors* width
-	unsigned char* colors = new unsigned char[bytesPerPixel * width]();
-
-	int paddingSize = (4 - (width * bytesPerPixel) % 4) % 4;
+	void flushIDAT(void)
+	{
+		if (!out.empty())
+			writePNGChunk(file, "IDAT", out.data(), out.size());
+		out.clear();
+	}
+};
 
+void generatePNGImage(char* image, int height, int width, char* imageFileName)
+{
+	FILE* pngimg = fopen(imageFileName, "wb");
+	if (pngimg == nullptr) {
+		std::cerr << "\n*************************************************************************************\n";
+		std::cerr << "Error: Could not open or create file for writing: " << imageFileName << "\n";
+		std::cerr << "*************************************************************************************\n";
+		return;
+	}
+	const CellStateLUT& lut = cellStateLUT();
+
+	// Signature
+	static const unsigned char signature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+	fwrite(signature, 1, 8, pngimg);
+
+	// IHDR: width, height, bit depth 8, colour type 3 (palette), deflate, filter method 0, no interlace
+	unsigned char ihdr[13] = {};
+	putBigEndian32(ihdr, (unsigned long)width);
+	putBigEndian32(ihdr + 4, (unsigned long)height);
+	ihdr[8] = 8;
+	ihdr[9] = 3;
+	writePNGChunk(pngimg, "IHDR", ihdr, 13);
+
+	// PLTE: RGB of every CellState
+	unsigned char plte[3 * cellStatePaletteSize];
+	for (int k = 0; k < cellStatePaletteSize; k++)
+	{
+		plte[3 * k] = lut.palette[k].red;
+		plte[3 * k + 1] = lut.palette[k].green;
+		plte[3 * k + 2] = lut.palette[k].blue;
+	}
+	writePNGChunk(pngimg, "PLTE", plte, sizeof(plte));
 
-	FILE* imageFile;
-	//	int err;
-	imageFile = fopen(imageFileName, "w");
+	// IDAT: scanlines (filter byte 0, then the palette index of every pixel), rows top to bottom
+	size_t rowBytes = (size_t)width + 1;
+	size_t rowsPerChunk = std::max((size_t)1, imageChunkBytes / rowBytes);
+	std::vector<unsigned char> chunk(rowsPerChunk * rowBytes);
+	size_t unknown = 0;
+	PNGDeflater deflater(pngimg, rowBytes);
 
-	//initialize
-	fwrite(fileHeader, 1, fileHeaderSize, imageFile);
-	fwrite(infoHeader, 1, infoHeaderSize, imageFile);
-	//unsigned char red = 557756 & 0xFF;
-	//unsigned char blue = (557756 >> 8) & 0xFF;
-	//unsigned char green = (557756 >> 16) & 0xFF;
-	//
-	//from botom to up
-	for (int line = height - 1; line >= 0; line--)
+	for (int line = 0; line < height; line += (int)rowsPerChunk)
 	{
-		for (int column = 0; column < width; column++)
+		size_t rows = std::min(rowsPerChunk, (size_t)(height - line));
+		for (size_t r = 0; r < rows; r++)
 		{
-
-			unsigned char color = image[(size_t)line * width + column];
-			switch ((int)color)
+			const unsigned char* codes = (const unsigned char*)image + (size_t)(line + r) * width;
+			unsigned char* scanline = &chunk[r * rowBytes];
+			scanline[0] = 0; // Filter type None (recommended for palette images)
+			for (int column = 0; column < width; column++)
 			{
-				//case 0:setcolor(colors, 3 * column, 0x00, 0x00, 0x00); cout << "1"; break;
-			case 0:  setcolor(colors, 3 * column, 0x00, 0x00, 0x00);  break;
-			case 1: setcolor(colors, 3 * column, 0x20, 0x20, 0x20);  break;
-			case 2:setcolor(colors, 3 * column, 0x40, 0x40, 0x40); break;
-			case 3: setcolor(colors, 3 * column, 0x60, 0x60, 0x60);  break;
-			case 4: setcolor(colors, 3 * column, 0x80, 0x80, 0x80);  break;
-			default:setcolor(colors, 3 * column, 0x00, 0x00, 0x00); break;
+				scanline[column + 1] = lut.index[codes[column]];
+				unknown += !lut.known[codes[column]];
 			}
-
-			//setcolor(colors, 3 * column, color, color, color);
-
 		}
-		//write line and pading
-		fwrite(colors, bytesPerPixel, width, imageFile);
-		fwrite(padding, 1, paddingSize, imageFile);
+		deflater.write(chunk.data(), rows * rowBytes);
 	}
+	deflater.finish();
 
-	//close
-	fclose(imageFile);
-	delete[] colors;
-}
-
-//create bitmap from array
-void saveClustersAsBitmapImage(unsigned char* image, int height, int width, int totalColors, char* imageFileName) {
-
-	//bmp format
-	unsigned char* fileHeader = createBitmapFileHeader(height, width);
-	unsigned char* infoHeader = createBitmapInfoHeader(height, width);
-	unsigned char padding[] = { 0, 0, 0 };
+	writePNGChunk(pngimg, "IEND", NULL, 0);
 
-	int trueColor;
-	int colorWidth = (0xFFFFFF - 1) / (totalColors + 1);
+	int err = fclose(pngimg);
+	if (err != 0) {
+		std::cerr << "\n*** Warning: Error writing to PNG Image file '" << imageFileName << "' ****\n";
+	}
+	reportUnknownCellCodes(unknown, imageFileName);
+}
 
-	//	cout << "Color Width" << colorWidth << "\n";
-		//one line of image 3 colors* width
+// --- BMP ---
+// All bitmaps are 8 bit palette images written by generateIndexedBitmap (image.h).
 
-	unsigned char* colors = new unsigned char[bytesPerPixel * width]();
+//create bitmap from array of cell states (CellState palette, as the PNG)
+void generateBitmapImage(char* image, int height, int width, char* imageFileName)
+{
+	const CellStateLUT& lut = cellStateLUT();
+	generateIndexedBitmap(image, height, width, lut.palette, cellStatePaletteSize,
+		[&lut](char code) { return lut.index[(unsigned char)code]; }, imageFileName);
+}
 
-	int paddingSize = (4 - (width * bytesPerPixel) % 4) % 4;
+//create bitmap from FDM phase labels: phase 1 black, others white
+void generateBitmapImageFortranStyle(int* image, int height, int width, char* imageFileName)
+{
+	static const sRGB palette[2] = { RGB_Black, RGB_White };
+	generateIndexedBitmap(image, height, width, palette, 2,
+		[](int phase) { return (phase == 1) ? 0 : 1; }, imageFileName);
+}
 
+//create bitmap from cluster values 0..4 as gray levels (others black)
+void saveClustersAsBitmapImage(unsigned char* image, int height, int width, char* imageFileName)
+{
+	static const sRGB palette[5] = { { 0x00,0x00,0x00 }, { 0x20,0x20,0x20 }, { 0x40,0x40,0x40 }, { 0x60,0x60,0x60 }, { 0x80,0x80,0x80 } };
+	generateIndexedBitmap(image, height, width, palette, 5,
+		[](unsigned char value) { return (value <= 4) ? value : 0; }, imageFileName);
+}
 
-	FILE* imageFile;
-	int err;
-	imageFile = fopen(imageFileName, "w");
+//create bitmap from cluster values, a colour per value spread over totalColors (0 is black)
+void saveClustersAsBitmapImage(unsigned char* image, int height, int width, int totalColors, char* imageFileName)
+{
+	int colorWidth = (0xFFFFFF - 1) / (totalColors + 1);
 
-	//initialize
-	fwrite(fileHeader, 1, fileHeaderSize, imageFile);
-	fwrite(infoHeader, 1, infoHeaderSize, imageFile);
-	unsigned char red;
-	unsigned char blue;
-	unsigned char green;
-	//from botom to up
-	for (int line = height - 1; line >= 0; line--)
+	sRGB palette[256];
+	palette[0] = RGB_Black;
+	for (int value = 1; value < 256; value++)
 	{
-		for (int column = 0; column < width; column++)
-		{
-
-			unsigned char color = image[(size_t)line * width + column];
-			trueColor = (int)color * colorWidth;
-			red = ((char)(trueColor % (0xFF))) | 0xF;//& (0xFF);
-			blue = ((char(trueColor) % 0x00FF)) | 0xF; //(trueColor >> 8) & (0xFF);
-			green = ((char(trueColor) % 0x0000FF)) | 0xF; //(trueColor >> 16) & (0xFF);
-			if (color > 0)
-				//setcolor(colors, 3 * column, 0xFA, 0xFA, 0XFA);
-				setcolor(colors, 3 * column, red, green, blue);
-			else
-				setcolor(colors, 3 * column, 0, 0, 0);
-
-		}
-		//write line and pading
-		fwrite(colors, bytesPerPixel, width, imageFile);
-		fwrite(padding, 1, paddingSize, imageFile);
+		int trueColor = value * colorWidth;
+		palette[value].red = ((char)(trueColor % (0xFF))) | 0xF;
+		palette[value].green = ((char(trueColor) % 0x0000FF)) | 0xF;
+		palette[value].blue = ((char(trueColor) % 0x00FF)) | 0xF;
 	}
-
-	//close
-	err = fclose(imageFile);
-	delete[] colors;
-	if (err != 0)
-		cout << "*** Warning: Error writing at Image File  ****\n";
+	generateIndexedBitmap(image, height, width, palette, 256,
+		[](unsigned char value) { return value; }, imageFileName);
 }
 
-
 /**
- * @brief Creates a BMP file header as a byte array.
+ * @brief Creates the headers and the colour table of an 8 bit palette BMP.
  * @param height The height of the image.
  * @param width The width of the image.
- * @return A pointer to a static unsigned char array containing the file header bytes.
+ * @param palette Colours of the palette indexes.
+ * @param paletteSize Number of palette entries (at most 256).
+ * @return File header (14 bytes), info header (40 bytes) and colour table (4 bytes per entry).
  */
-unsigned char* createBitmapFileHeader(int height, int width) {
-	// Calculate the size of the pixel data, ensuring each row is padded to a multiple of 4 bytes.
-	int fileSize = fileHeaderSize + infoHeaderSize + bytesPerPixel * height * width;
-
-	static unsigned char fileHeader[] = {
-		0,0,    /// signature
-		0,0,0,0, /// image file size in bytes
-		0,0,0,0, /// reserved
-		0,0,0,0, /// start of pixel array
-	};
-
-	fileHeader[0] = (unsigned char)('B');
-	fileHeader[1] = (unsigned char)('M');
-	fileHeader[2] = (unsigned char)(fileSize);
-	fileHeader[3] = (unsigned char)(fileSize >> 8);
-	fileHeader[4] = (unsigned char)(fileSize >> 16);
-	fileHeader[5] = (unsigned char)(fileSize >> 24);
-	fileHeader[10] = (unsigned char)(fileHeaderSize + infoHeaderSize);
-
-	return fileHeader;
+std::vector<unsigned char> createIndexedBitmapHeader(int height, int width, const sRGB* palette, int paletteSize)
+{
+	size_t rowBytes = ((size_t)width + 3) & ~(size_t)3;
+	size_t offset = fileHeaderSize + infoHeaderSize + 4 * (size_t)paletteSize;
+	size_t fileSize = offset + rowBytes * height;
+	std::vector<unsigned char> header(offset, 0);
+
+	auto put32 = [&header](size_t at, size_t value) {
+		header[at] = (unsigned char)(value);
+		header[at + 1] = (unsigned char)(value >> 8);
+		header[at + 2] = (unsigned char)(value >> 16);
+		header[at + 3] = (unsigned char)(value >> 24);
+		};
+
+	// File header
+	header[0] = (unsigned char)('B'); /// signature
+	header[1] = (unsigned char)('M');
+	put32(2, fileSize);               /// image file size in bytes
+	put32(10, offset);                /// start of pixel array
+
+	// Info header
+	put32(14, infoHeaderSize);        /// header size
+	put32(18, (size_t)width);         /// image width
+	put32(22, (size_t)height);        /// image height
+	header[26] = 1;                   /// number of color planes
+	header[28] = bitsPerPixel;        /// bits per pixel
+	put32(34, rowBytes * height);     /// image size
+	put32(46, (size_t)paletteSize);   /// colors in color table
+	put32(50, (size_t)paletteSize);   /// important color count
+
+	// Colour table: blue, green, red, reserved
+	for (int k = 0; k < paletteSize; k++)
+	{
+		header[54 + 4 * k] = palette[k].blue;
+		header[54 + 4 * k + 1] = palette[k].green;
+		header[54 + 4 * k + 2] = palette[k].red;
+	}
+	return header;
 }
-
-unsigned char* createBitmapInfoHeader(int height, int width) {
-	static unsigned char infoHeader[] = {
-		0,0,0,0, /// header size
-		0,0,0,0, /// image width
-		0,0,0,0, /// image height
-		0,0,    /// number of color planes
-		0,0,    /// bits per pixel
-		0,0,0,0, /// compression
-		0,0,0,0, /// image size
-		0,0,0,0, /// horizontal resolution
-		0,0,0,0, /// vertical resolution
-		0,0,0,0, /// colors in color table
-		0,0,0,0, /// important color count
-	};
-
-	infoHeader[0] = (unsigned char)(infoHeaderSize);
-	infoHeader[4] = (unsigned char)(width);
-	infoHeader[5] = (unsigned char)(width >> 8);
-	infoHeader[6] = (unsigned char)(width >> 16);
-	infoHeader[7] = (unsigned char)(width >> 24);
-	infoHeader[8] = (unsigned char)(height);
-	infoHeader[9] = (unsigned char)(height >> 8);
-	infoHeader[10] = (unsigned char)(height >> 16);
-	infoHeader[11] = (unsigned char)(height >> 24);
-	infoHeader[12] = (unsigned char)(1);
-	infoHeader[14] = (unsigned char)(bytesPerPixel * 8);
-
-	return infoHeader;
-}
\ No newline at end of file
@@ -33,6 +33,12 @@ if you use this programm and write a paper or report please cite above papers
 #include "Grid.h"    // Custom header file likely defining the 'Grid' class or related structures/enums for cell states.
 #include <errno.h>   // Provides access to the 'errno' variable and error codes for reporting system errors.
 #include <string.h>  // Provides string manipulation functions, potentially used for error messages (e.g., strerror).
+#include <vector>    // File and row buffers of the image writers.
+#include <algorithm> // std::max.
+#include <iostream>  // std::cerr.
+#include <string>    // File names owned by queued images.
+#include "OutputQueue.h" // Background encodes and writes of image snapshots.
+#include "PhaseTimer.h"  // Image save phase of the realization.
 
 
 // Structure to represent an sRGB color with blue, green, and red components.
@@ -43,22 +49,34 @@ struct sRGB {
 	unsigned char red;
 };
 
-// Global constant: Number of bytes per pixel for RGB images (3 bytes for Red, Green, Blue).
-const int bytesPerPixel = 3; /// red, green, blue
+// Global constant: Bits per pixel of the BMP images (palette indexes, a third of a 24 bit BMP).
+const int bitsPerPixel = 8;
 // Global constant: Size of the BMP file header in bytes.
 const int fileHeaderSize = 14;
 // Global constant: Size of the BMP info header in bytes.
 const int infoHeaderSize = 40;
 
+// Rows of the image writers are converted into buffers of about this size and written with one fwrite.
+const size_t imageChunkBytes = 1 << 20;
+
 // Function declarations for image generation.
 
-// Generates a PGM (Portable Graymap) image from a character array representing pixel data.
+// Generates a binary (P5) PGM (Portable Graymap) image from a character array of cell states.
+// Each CellState is mapped to a gray level through a look up table; rows are written in large chunks.
 // @param image A pointer to the character array containing image pixel data.
 // @param height The height of the image in pixels.
 // @param width The width of the image in pixels.
 // @param imageFileName A C-style string representing the name of the output PGM file.
 void  generatePGMImage(char* image, int height, int width, char* imageFileName);
 
+// Generates a palette-indexed PNG image (one palette colour per CellState, same colours as the BMP).
+// The pixel data is compressed with the built-in deflate, no external library is needed.
+// @param image A pointer to the character array containing image pixel data.
+// @param height The height of the image in pixels.
+// @param width The width of the image in pixels.
+// @param imageFileName A C-style string representing the name of the output PNG file.
+void  generatePNGImage(char* image, int height, int width, char* imageFileName);
+
 // Generates a BMP (Bitmap) image from a character array representing pixel data.
 // This function likely maps internal cell states to specific RGB colors.
 // @param image A pointer to the character array containing image pixel data.
@@ -92,18 +110,82 @@ void saveClustersAsBitmapImage(unsigned char* image, int height, int width, char
 // @param imageFileName A C-style string representing the name of the output BMP file.
 void saveClustersAsBitmapImage(unsigned char* image, int height, int width, int totalColors, char* imageFileName);
 
-// Utility functions for creating BMP header components.
+// Utility functions for the BMP writers.
 
-// Creates and returns a pointer to a byte array representing the BMP file header.
-// This header contains general information about the BMP file, such as file size and pixel data offset.
+// Builds the file header, the info header and the colour table of an 8 bit palette BMP.
 // @param height The height of the image.
 // @param width The width of the image.
-// @return A pointer to an unsigned char array containing the BMP file header bytes.
-unsigned char* createBitmapFileHeader(int height, int width);
-
-// Creates and returns a pointer to a byte array representing the BMP info header.
-// This header contains detailed information about the image, such as dimensions, color depth, and compression.
-// @param height The height of the image.
-// @param width The width of the image.
-// @return A pointer to an unsigned char array containing the BMP info header bytes.
-unsigned char* createBitmapInfoHeader(int height, int width);
\ No newline at end of file
+// @param palette Colours of the palette indexes.
+// @param paletteSize Number of palette entries (at most 256).
+// @return The header bytes; the pixel rows follow them in the file.
+std::vector<unsigned char> createIndexedBitmapHeader(int height, int width, const sRGB* palette, int paletteSize);
+
+// Generates an 8 bit palette BMP from any pixel type. `indexOf(pixel)` gives the palette index of a pixel.
+// Rows (bottom to top, padded to 4 bytes) are converted into large chunks, each written with one fwrite.
+// @param image A pointer to the pixel data (rows top to bottom).
+// @param height The height of the image in pixels.
+// @param width The width of the image in pixels.
+// @param palette Colours of the palette indexes.
+// @param paletteSize Number of palette entries (at most 256).
+// @param indexOf Maps a pixel value to its palette index.
+// @param imageFileName A C-style string representing the name of the output BMP file.
+template <typename T, typename IndexOf>
+void generateIndexedBitmap(const T* image, int height, int width, const sRGB* palette, int paletteSize, IndexOf indexOf, const char* imageFileName)
+{
+	size_t rowBytes = ((size_t)width + 3) & ~(size_t)3; // Rows are padded to a multiple of 4 bytes
+
+	FILE* imageFile = fopen(imageFileName, "wb");
+	if (imageFile == NULL)
+	{
+		std::cerr << "Error: Could not open or create file for writing: " << imageFileName << "\n";
+		return;
+	}
+	std::vector<unsigned char> buffer = createIndexedBitmapHeader(height, width, palette, paletteSize);
+	buffer.reserve(buffer.size() + imageChunkBytes + rowBytes);
+
+	// From bottom to up
+	for (int line = height - 1; line >= 0; line--)
+	{
+		size_t start = buffer.size();
+		buffer.resize(start + rowBytes, 0);
+		unsigned char* row = &buffer[start];
+		const T* pixels = image + (size_t)line * width;
+		for (int column = 0; column < width; column++)
+			row[column] = (unsigned char)indexOf(pixels[column]);
+
+		if (buffer.size() >= imageChunkBytes)
+		{
+			fwrite(buffer.data(), 1, buffer.size(), imageFile);
+			buffer.clear();
+		}
+	}
+
+	fwrite(buffer.data(), 1, buffer.size(), imageFile);
+	if (fclose(imageFile) != 0)
+		std::cerr << "*** Warning: Error writing at Image File " << imageFileName << " ****\n";
+}
+
+// Encodes and writes an image from a snapshot of its pixels on the output queue, so that the caller
+// can go on changing `image` at once. Without background writes the image is encoded right away.
+// @param image A pointer to the pixel data (rows top to bottom).
+// @param height The height of the image in pixels.
+// @param width The width of the image in pixels.
+// @param imageFileName A C-style string representing the name of the output file.
+// @param encode The image writer, called as encode(pixels, height, width, imageFileName).
+template <typename T, typename Encoder>
+void queueImageSnapshot(T* image, int height, int width, const char* imageFileName, Encoder encode)
+{
+	ScopedTimer timer(IMAGE_SAVE_PHASE);
+	std::string name(imageFileName);
+	if (!outputQueue.isEnabled())
+	{
+		encode(image, height, width, &name[0]);
+		return;
+	}
+
+	size_t pixels = (size_t)height * width;
+	std::vector<T> snapshot(image, image + pixels);
+	outputQueue.submit([snapshot = std::move(snapshot), height, width, name, encode]() mutable {
+		encode(snapshot.data(), height, width, &name[0]);
+		}, pixels * sizeof(T));
+}
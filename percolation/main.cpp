@@ -42,26 +42,33 @@ if you use this programm and write a paper or report please cite above papers
 #include "general.h"     // Custom header for general utility functions (like NowToString, delay)
 #include "BatchMonteCarlo.h" // Custom header for batch Monte Carlo simulation
 #include "Settings.h"    // Custom header for program settings (e.g., `info` struct)
+#include "Distributed.h" // Ranks of an MPI run
 
 
 using namespace std; // Use the standard namespace
 
-int main() {
+int main(int argc, char* argv[]) {
+    // Ranks of an MPI run (build with PERC_MPI, start with mpirun -np N); a single process otherwise
+    distributed.start(&argc, &argv);
+
     //setlocale(LC_NUMERIC,".OCP"); // ".OCP" if you want to use system settings "French_Canada.1252" - commented out
 
     // Change to local locale for correct number formatting in output
     std::locale cpploc{ "" }; // Get the user's default locale
     std::cout.imbue(cpploc);  // Imbue cout with the local locale
 
-    // Display program information header
-    cout << "------------------------------------------------------------------------------------------------------------------------------------\n";
-    cout << info.program;  // Program title
-    cout << info.version;  // Program version
-    cout << info.date;     // Creation date
-    cout << info.author;   // Author information
-    cout << info.licence;  // License information
-    cout << "------------------------------------------------------------------------------------------------------------------------------------\n";
-    cout << "Start at " << NowToString() << "\n"; // Display current start time
+    // Display program information header (once, by rank 0)
+    if (distributed.rank == 0)
+    {
+        cout << "------------------------------------------------------------------------------------------------------------------------------------\n";
+        cout << info.program;  // Program title
+        cout << info.version;  // Program version
+        cout << info.date;     // Creation date
+        cout << info.author;   // Author information
+        cout << info.licence;  // License information
+        cout << "------------------------------------------------------------------------------------------------------------------------------------\n";
+        cout << "Start at " << NowToString() << "\n"; // Display current start time
+    }
 
     // Create a new instance of BatchMonteCarlo to manage simulations
     BatchMonteCarlo* batchMonteCarlo = new BatchMonteCarlo();
@@ -73,7 +80,13 @@ int main() {
         //batchMonteCarlo->saveResults(); // Save results (commented out in the original code)
     }
     else // If there was an error processing input files
+    {
+        distributed.stop();
         return EXIT_FAILURE; // Exit with a failure code
+    }
+    distributed.stop();
+    if (distributed.rank != 0) // Only rank 0 has the console input of an MPI run
+        return EXIT_SUCCESS;
 
     // Prompt user to press a key before exiting
     cout << "Press any key to exit...";